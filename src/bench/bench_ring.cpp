@@ -4,6 +4,8 @@
 
 #include <bench/bench.h>
 
+#include <chainparams.h>
+#include <crypto/pow/minotaur.h>
 #include <crypto/sha256.h>
 #include <key.h>
 #include <util/system.h>
@@ -63,8 +65,10 @@ int main(int argc, char** argv)
     const fs::path bench_datadir{SetDataDir()};
 
     SHA256AutoDetect();
+    MinotaurAutoDetect();
     ECC_Start();
     SetupEnvironment();
+    SelectParams(CBaseChainParams::REGTEST);         // Ring-fork: So benchmarks that switch params have some to put back
 
     int64_t evaluations = gArgs.GetArg("-evals", DEFAULT_BENCH_EVALUATIONS);
     std::string regex_filter = gArgs.GetArg("-filter", DEFAULT_BENCH_FILTER);
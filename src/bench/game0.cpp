@@ -0,0 +1,71 @@
+// Copyright (c) 2019 The Ring Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Ring-fork: Pop: Game0 verification benchmarks
+
+#include <bench/bench.h>
+
+#include <crypto/pop/game0/game0.h>
+#include <crypto/pop/game0/game0bitboard.h>
+#include <crypto/pop/game0/game0solver.h>
+#include <random.h>
+#include <uint256.h>
+
+#include <string>
+#include <vector>
+
+// Fill the board with random legal moves, as a solver submitting a long game would
+static std::vector<unsigned char> MakeSolution(const uint256& gameSourceHash)
+{
+    FastRandomContext rng(true);
+    Game0 game;
+    game.InitGame(gameSourceHash);
+    std::string strError;
+    while (game.GetTilesPlaced() < GAME0_BOARD_CELLS) {
+        bool fPlaced = false;
+        for (int attempt = 0; attempt < 1000 && !fPlaced; attempt++)
+            fPlaced = game.PlaceTile(rng.randrange(GAME0_BOARD_SIZE), rng.randrange(GAME0_BOARD_SIZE), rng.randrange(4), strError);
+        if (!fPlaced)
+            break;
+    }
+    return game.GetSolution();
+}
+
+// Verification with the reference Game0 implementation
+static void Game0Verify_Reference(benchmark::State& state)
+{
+    const uint256 gameSourceHash = FastRandomContext(true).rand256();
+    const std::vector<unsigned char> solution = MakeSolution(gameSourceHash);
+    std::string strError;
+    while (state.KeepRunning()) {
+        Game0 game;
+        game.VerifyGameSolution(0, gameSourceHash, solution, strError);
+    }
+}
+
+// Verification with the bitboard verifier, as done by CheckPopProof
+static void Game0Verify_Bitboard(benchmark::State& state)
+{
+    const uint256 gameSourceHash = FastRandomContext(true).rand256();
+    const std::vector<unsigned char> solution = MakeSolution(gameSourceHash);
+    std::string strError;
+    while (state.KeepRunning())
+        VerifyGame0Solution(0, gameSourceHash, solution, strError);
+}
+
+// Solving a game to the minimum score target, on one thread and on two
+static void Game0Solve(benchmark::State& state, int nThreads)
+{
+    FastRandomContext rng(true);
+    while (state.KeepRunning())
+        SolveGame0(rng.rand256(), 70, nThreads, 16, nullptr);
+}
+
+static void Game0Solve_1Thread(benchmark::State& state) { Game0Solve(state, 1); }
+static void Game0Solve_2Threads(benchmark::State& state) { Game0Solve(state, 2); }
+
+BENCHMARK(Game0Verify_Reference, 500);
+BENCHMARK(Game0Verify_Bitboard, 5000);
+BENCHMARK(Game0Solve_1Thread, 2);
+BENCHMARK(Game0Solve_2Threads, 2);
@@ -0,0 +1,417 @@
+// Copyright (c) 2019 The Ring Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Ring-fork: Hive: Hive mining benchmarks. Regtest has no hive parameters, so these run under main params, over a chain of
+// block indexes made up for the purpose (no block data) and a wallet with made-up DCTs.
+
+#include <bench/bench.h>
+
+#include <arith_uint256.h>
+#include <chain.h>
+#include <chainparams.h>
+#include <coins.h>
+#include <crypto/common.h>
+#include <hash.h>
+#include <interfaces/chain.h>
+#include <key.h>
+#include <key_io.h>
+#include <miner.h>
+#include <pow.h>
+#include <random.h>
+#include <script/standard.h>
+#include <util/system.h>
+#include <validation.h>
+#include <wallet/wallet.h>
+
+#include <thread>
+#include <vector>
+
+static const int HIVE_BENCH_DWARVES_PER_DCT = 100;
+
+// Selects main params while in scope, putting back whichever were selected before
+class HiveBenchParams
+{
+public:
+    HiveBenchParams() : strPrevNetwork(Params().NetworkIDString())
+    {
+        SelectParams(CBaseChainParams::MAIN);
+    }
+
+    ~HiveBenchParams()
+    {
+        SelectParams(strPrevNetwork);
+    }
+
+private:
+    const std::string strPrevNetwork;
+};
+
+// A chain of PoW block indexes reaching past the hive slow start, set as the active chain while in scope
+class HiveBenchChain
+{
+public:
+    explicit HiveBenchChain(int nHeight)
+    {
+        const Consensus::Params& consensusParams = Params().GetConsensus();
+        FastRandomContext rng(true);
+
+        LOCK(cs_main);
+        pindexOldTip = chainActive.Tip();
+        CBlockIndex* pprev = nullptr;
+        for (int i = 0; i <= nHeight; i++) {
+            CBlockIndex* pindex = new CBlockIndex();
+            pindex->pprev = pprev;
+            pindex->nHeight = i;
+            pindex->nTime = 1556000000 + i * consensusParams.nPowTargetSpacing;
+            pindex->nBits = 0x1e0fffff;
+            pindex->phashBlock = &mapBlockIndex.emplace(rng.rand256(), pindex).first->first;
+            pindex->BuildSkip();
+            pindex->BuildHiveContext(consensusParams);
+            vBlocks.push_back(pindex);
+            pprev = pindex;
+        }
+        chainActive.SetTip(pprev);
+    }
+
+    ~HiveBenchChain()
+    {
+        LOCK(cs_main);
+        chainActive.SetTip(pindexOldTip);
+        for (CBlockIndex* pindex : vBlocks) {
+            mapBlockIndex.erase(pindex->GetBlockHash());
+            delete pindex;
+        }
+    }
+
+private:
+    std::vector<CBlockIndex*> vBlocks;
+    CBlockIndex* pindexOldTip;
+};
+
+// Height for the bench chain: a DCT mined a little over a gestation period back is mature for a block on the tip
+static int HiveBenchChainHeight(const Consensus::Params& consensusParams)
+{
+    return consensusParams.lastInitialDistributionHeight + consensusParams.slowStartBlocks + consensusParams.dwarfGestationBlocks + 200;
+}
+
+// A DCT output paying to the dwarf creation address, with the given reward script
+static CScript HiveBenchDCTScript(const Consensus::Params& consensusParams, const CScript& scriptPubKeyReward)
+{
+    CScript scriptPubKeyDCT = GetScriptForDestination(DecodeDestination(consensusParams.dwarfCreationAddress));
+    scriptPubKeyDCT << OP_RETURN << OP_DWARF;
+    scriptPubKeyDCT.insert(scriptPubKeyDCT.end(), scriptPubKeyReward.begin(), scriptPubKeyReward.end());
+    return scriptPubKeyDCT;
+}
+
+static std::string HiveBenchRandString(FastRandomContext& rng)
+{
+    std::string deterministicRandString;
+    for (int i = 0; i < 6; i++)
+        deterministicRandString += rng.rand256().GetHex();
+    return deterministicRandString;
+}
+
+// nDwarves dwarves, in DCTs of HIVE_BENCH_DWARVES_PER_DCT
+static std::vector<CDwarfRange> HiveBenchRanges(FastRandomContext& rng, int nDwarves)
+{
+    std::vector<CDwarfRange> vRanges;
+    for (int nStart = 0; nStart < nDwarves; nStart += HIVE_BENCH_DWARVES_PER_DCT)
+        vRanges.push_back({rng.rand256().GetHex(), "", false, 0, std::min(HIVE_BENCH_DWARVES_PER_DCT, nDwarves - nStart)});
+    return vRanges;
+}
+
+// Check 4096 dwarves from 41 DCTs on the check pool with nThreads workers. None meets the target, so all are hashed.
+static void HiveCheck(benchmark::State& state, int nThreads)
+{
+    FastRandomContext rng(true);
+    const std::string deterministicRandString = HiveBenchRandString(rng);
+    const std::vector<CDwarfRange> vRanges = HiveBenchRanges(rng, 4096);
+
+    CDwarfRange solvingRange;
+    uint32_t solvingDwarf;
+    while (state.KeepRunning()) {
+        HiveCheckResult result = CheckHiveDwarves(deterministicRandString, arith_uint256(), vRanges, nThreads, solvingRange, solvingDwarf);
+        assert(result == HIVE_CHECK_NONE);
+    }
+    StopHiveCheckThreads();
+}
+
+static void HiveCheck_1Thread(benchmark::State& state) { HiveCheck(state, 1); }
+static void HiveCheck_2Threads(benchmark::State& state) { HiveCheck(state, 2); }
+static void HiveCheck_4Threads(benchmark::State& state) { HiveCheck(state, 4); }
+static void HiveCheck_8Threads(benchmark::State& state) { HiveCheck(state, 8); }
+static void HiveCheck_AllThreads(benchmark::State& state) { HiveCheck(state, GetNumCores()); }
+
+// Pick the dwarves to check from a wallet's DCT list, as each round does. Half the DCTs are mature, holding nDwarves dwarves.
+static void HiveBin(benchmark::State& state, int nDwarves)
+{
+    HiveBenchParams params;
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    FastRandomContext rng(true);
+
+    std::vector<CDwarfCreationTransactionInfo> dcts;
+    for (int nStart = 0; nStart < nDwarves; nStart += HIVE_BENCH_DWARVES_PER_DCT) {
+        for (bool fMature : {true, false}) {
+            CDwarfCreationTransactionInfo dct;
+            dct.txid = rng.rand256().GetHex();
+            dct.time = 1556000000;
+            dct.dwarfCount = std::min(HIVE_BENCH_DWARVES_PER_DCT, nDwarves - nStart);
+            dct.dwarfFeePaid = dct.dwarfCount * consensusParams.dwarfCost;
+            dct.communityContrib = false;
+            dct.dwarfStatus = fMature ? "mature" : "immature";
+            dct.rewardAddress = EncodeDestination(CKeyID(uint160(std::vector<unsigned char>(20, 0x11))));
+            dct.rewardsPaid = 0;
+            dct.profit = 0;
+            dct.blocksFound = 0;
+            dct.blocksLeft = fMature ? consensusParams.dwarfLifespanBlocks / 2 : consensusParams.dwarfLifespanBlocks + 100;
+            dcts.push_back(dct);
+        }
+    }
+
+    while (state.KeepRunning()) {
+        std::vector<CDwarfRange> vRanges = GetMatureDwarfRanges(dcts, false, consensusParams);
+        assert(vRanges.size() * 2 == dcts.size());
+    }
+}
+
+static void HiveBin_1k(benchmark::State& state) { HiveBin(state, 1000); }
+static void HiveBin_100k(benchmark::State& state) { HiveBin(state, 100000); }
+static void HiveBin_10M(benchmark::State& state) { HiveBin(state, 10000000); }
+
+// A whole round for a fleet of nDwarves, with the default thread count and no dwarf meeting the target: pick the mature
+// dwarves and check every one. Larger fleets scale linearly from here (see HiveCheck_* for throughput per thread count).
+static void HiveRound(benchmark::State& state, int nDwarves)
+{
+    HiveBenchParams params;
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    FastRandomContext rng(true);
+    const std::string deterministicRandString = HiveBenchRandString(rng);
+    const int nThreads = std::max(1, GetNumCores() - 1);
+
+    std::vector<CDwarfCreationTransactionInfo> dcts;
+    for (const CDwarfRange& range : HiveBenchRanges(rng, nDwarves)) {
+        CDwarfCreationTransactionInfo dct;
+        dct.txid = range.txid;
+        dct.dwarfCount = range.count;
+        dct.communityContrib = false;
+        dct.dwarfStatus = "mature";
+        dct.blocksLeft = consensusParams.dwarfLifespanBlocks / 2;
+        dcts.push_back(dct);
+    }
+
+    CDwarfRange solvingRange;
+    uint32_t solvingDwarf;
+    while (state.KeepRunning()) {
+        std::vector<CDwarfRange> vRanges = GetMatureDwarfRanges(dcts, false, consensusParams);
+        HiveCheckResult result = CheckHiveDwarves(deterministicRandString, arith_uint256(), vRanges, nThreads, solvingRange, solvingDwarf);
+        assert(result == HIVE_CHECK_NONE);
+    }
+    StopHiveCheckThreads();
+}
+
+static void HiveRound_1k(benchmark::State& state) { HiveRound(state, 1000); }
+static void HiveRound_10k(benchmark::State& state) { HiveRound(state, 10000); }
+static void HiveRound_100k(benchmark::State& state) { HiveRound(state, 100000); }
+
+// Start a round over a fleet far too big to finish, and cancel it as soon as the workers are busy, as a new tip does. Each
+// iteration covers publishing the round, waking the workers, and the round returning once cancelled.
+static void HiveCheckAbort(benchmark::State& state)
+{
+    FastRandomContext rng(true);
+    const std::string deterministicRandString = HiveBenchRandString(rng);
+    const std::vector<CDwarfRange> vRanges = HiveBenchRanges(rng, 10000000);
+    const int nThreads = std::max(1, GetNumCores() - 1);
+
+    CDwarfRange solvingRange;
+    uint32_t solvingDwarf;
+    while (state.KeepRunning()) {
+        HiveCheckResult result = HIVE_CHECK_SKIPPED;
+        std::thread round([&] { result = CheckHiveDwarves(deterministicRandString, arith_uint256(), vRanges, nThreads, solvingRange, solvingDwarf); });
+
+        int nClaimed = 0, nChecked;
+        while (!GetHiveCheckProgress(nClaimed, nChecked) || nClaimed == 0)
+            std::this_thread::yield();
+        CancelHiveCheck();
+
+        round.join();
+        assert(result == HIVE_CHECK_ABORTED);
+    }
+    StopHiveCheckThreads();
+}
+
+// List a wallet's DCTs, as each round does, for a wallet holding nDCTs mature DCTs (every other one with a community contribution)
+static void HiveGetDCTs(benchmark::State& state, int nDCTs)
+{
+    HiveBenchParams params;
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    HiveBenchChain benchChain(HiveBenchChainHeight(consensusParams));
+
+    auto chain = interfaces::MakeChain();
+    CWallet wallet(*chain, WalletLocation(), WalletDatabase::CreateDummy());
+    CKey key;
+    key.MakeNewKey(true);
+    const CScript scriptPubKeyKey = GetScriptForDestination(key.GetPubKey().GetID());
+    const CScript scriptPubKeyDCT = HiveBenchDCTScript(consensusParams, scriptPubKeyKey);
+    const CScript scriptPubKeyCF = GetScriptForDestination(DecodeDestination(consensusParams.hiveCommunityAddress));
+    {
+        LOCK(wallet.cs_wallet);
+        wallet.AddKeyPubKey(key, key.GetPubKey());
+    }
+
+    // One funding tx paying the wallet, then DCTs spending its outputs, all confirmed a little over a gestation period back
+    uint256 blockHash;
+    {
+        LOCK(cs_main);
+        blockHash = chainActive[chainActive.Height() - consensusParams.dwarfGestationBlocks - 100]->GetBlockHash();
+    }
+    CMutableTransaction funding;
+    funding.vin.resize(1);
+    funding.vout.resize(nDCTs, CTxOut(HIVE_BENCH_DWARVES_PER_DCT * consensusParams.dwarfCost * 2, scriptPubKeyKey));
+    CWalletTx wtxFunding(&wallet, MakeTransactionRef(funding));
+    wtxFunding.SetMerkleBranch(blockHash, 1);
+    wallet.AddToWallet(wtxFunding);
+    for (int i = 0; i < nDCTs; i++) {
+        CMutableTransaction dct;
+        dct.vin.emplace_back(COutPoint(funding.GetHash(), i));
+        const CAmount nCost = HIVE_BENCH_DWARVES_PER_DCT * consensusParams.dwarfCost;
+        if (i % 2) {
+            dct.vout.emplace_back(nCost - nCost / consensusParams.communityContribFactor, scriptPubKeyDCT);
+            dct.vout.emplace_back(nCost / consensusParams.communityContribFactor, scriptPubKeyCF);
+        } else
+            dct.vout.emplace_back(nCost, scriptPubKeyDCT);
+        CWalletTx wtx(&wallet, MakeTransactionRef(dct));
+        wtx.SetMerkleBranch(blockHash, 2 + i);
+        wallet.AddToWallet(wtx);
+    }
+
+    while (state.KeepRunning()) {
+        std::vector<CDwarfCreationTransactionInfo> dcts = wallet.GetDCTs(false, false, consensusParams);
+        assert(dcts.size() == (size_t)nDCTs);
+    }
+}
+
+static void HiveGetDCTs_100(benchmark::State& state) { HiveGetDCTs(state, 100); }
+static void HiveGetDCTs_10k(benchmark::State& state) { HiveGetDCTs(state, 10000); }
+
+// Check the hive proof of a block on the tip, claiming a DCT found in the UTXO set, as for each incoming hive block
+static void HiveCheckProof(benchmark::State& state)
+{
+    HiveBenchParams params;
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    HiveBenchChain benchChain(HiveBenchChainHeight(consensusParams));
+
+    CKey key;
+    key.MakeNewKey(true);
+    const CScript scriptPubKeyReward = GetScriptForDestination(key.GetPubKey().GetID());
+
+    const CBlockIndex* pindexPrev;
+    {
+        LOCK(cs_main);
+        pindexPrev = chainActive.Tip();
+    }
+    const int dctHeight = pindexPrev->nHeight - consensusParams.dwarfGestationBlocks - 100;
+    const int dwarfCount = 1000;                        // Plenty for one to meet the easiest target
+    CMutableTransaction dct;
+    dct.vin.resize(1);
+    dct.vout.emplace_back(dwarfCount * consensusParams.dwarfCost, HiveBenchDCTScript(consensusParams, scriptPubKeyReward));
+    const std::string dctTxid = dct.GetHash().GetHex();
+
+    CCoinsView coinsDummy;
+    std::unique_ptr<CCoinsViewCache> coins = MakeUnique<CCoinsViewCache>(&coinsDummy);
+    coins->AddCoin(COutPoint(dct.GetHash(), 0), Coin(dct.vout[0], dctHeight, false), false);
+    {
+        LOCK(cs_main);
+        std::swap(pcoinsTip, coins);
+    }
+
+    // Find a dwarf meeting the target, and build the hive proof as MintHiveBlock does
+    const std::string deterministicRandString = GetDeterministicRandString(pindexPrev);
+    arith_uint256 dwarfHashTarget;
+    dwarfHashTarget.SetCompact(GetNextHiveWorkRequired(pindexPrev, consensusParams));
+    CDwarfHasher dwarfHasher(deterministicRandString, dctTxid);
+    uint32_t dwarfNonce = 0;
+    while (!dwarfHasher.CheckTarget(dwarfNonce, dwarfHashTarget)) {
+        dwarfNonce++;
+        assert(dwarfNonce < (uint32_t)dwarfCount);
+    }
+
+    CHashWriter ss(SER_GETHASH, 0);
+    ss << deterministicRandString;
+    std::vector<unsigned char> messageProofVec;
+    bool fSigned = key.SignCompact(ss.GetHash(), messageProofVec);
+    assert(fSigned);
+
+    unsigned char dwarfNonceEncoded[4], dctHeightEncoded[4];
+    WriteLE32(dwarfNonceEncoded, dwarfNonce);
+    WriteLE32(dctHeightEncoded, dctHeight);
+    CScript hiveProofScript;
+    hiveProofScript << OP_RETURN << OP_DWARF << std::vector<unsigned char>(dwarfNonceEncoded, dwarfNonceEncoded + 4)
+        << std::vector<unsigned char>(dctHeightEncoded, dctHeightEncoded + 4) << OP_FALSE
+        << std::vector<unsigned char>(dctTxid.begin(), dctTxid.end()) << messageProofVec;
+
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vin[0].prevout.SetNull();
+    coinbase.vin[0].scriptSig = CScript() << (pindexPrev->nHeight + 1) << OP_0;
+    coinbase.vout.emplace_back(0, hiveProofScript);
+    coinbase.vout.emplace_back(GetBlockSubsidyHive(consensusParams), scriptPubKeyReward);
+    CBlock block;
+    block.hashPrevBlock = pindexPrev->GetBlockHash();
+    block.nNonce = consensusParams.hiveNonceMarker;
+    block.vtx.push_back(MakeTransactionRef(coinbase));
+
+    while (state.KeepRunning()) {
+        bool fValid = CheckHiveProof(&block, consensusParams);
+        assert(fValid);
+    }
+
+    LOCK(cs_main);
+    std::swap(pcoinsTip, coins);
+}
+
+// Count the DCTs and dwarves in a block, as GetNetworkHiveInfo does for each block of the dwarf lifespan when the hive
+// index isn't enabled (after reading the block). The block holds 200 transactions, half of them DCTs.
+static void HiveCountBlockDwarves(benchmark::State& state)
+{
+    HiveBenchParams params;
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    const int nHeight = HiveBenchChainHeight(consensusParams);
+    const CScript scriptPubKeyReward = GetScriptForDestination(CKeyID(uint160(std::vector<unsigned char>(20, 0x11))));
+
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vin[0].prevout.SetNull();
+    coinbase.vout.emplace_back(0, scriptPubKeyReward);
+    CBlock block;
+    block.vtx.push_back(MakeTransactionRef(coinbase));
+    for (int i = 0; i < 200; i++) {
+        CMutableTransaction tx;
+        tx.vin.emplace_back(COutPoint(uint256(), i));
+        tx.vout.emplace_back(HIVE_BENCH_DWARVES_PER_DCT * consensusParams.dwarfCost, i % 2 ? HiveBenchDCTScript(consensusParams, scriptPubKeyReward) : scriptPubKeyReward);
+        block.vtx.push_back(MakeTransactionRef(tx));
+    }
+
+    while (state.KeepRunning()) {
+        int nDCTs, nDwarves;
+        CountBlockDwarves(block, nHeight, consensusParams, nDCTs, nDwarves);
+        assert(nDCTs == 100);
+    }
+}
+
+BENCHMARK(HiveCheck_1Thread, 10);
+BENCHMARK(HiveCheck_2Threads, 20);
+BENCHMARK(HiveCheck_4Threads, 40);
+BENCHMARK(HiveCheck_8Threads, 80);
+BENCHMARK(HiveCheck_AllThreads, 80);
+BENCHMARK(HiveBin_1k, 20000);
+BENCHMARK(HiveBin_100k, 200);
+BENCHMARK(HiveBin_10M, 2);
+BENCHMARK(HiveRound_1k, 20);
+BENCHMARK(HiveRound_10k, 2);
+BENCHMARK(HiveRound_100k, 1);
+BENCHMARK(HiveCheckAbort, 100);
+BENCHMARK(HiveGetDCTs_100, 200);
+BENCHMARK(HiveGetDCTs_10k, 2);
+BENCHMARK(HiveCheckProof, 1000);
+BENCHMARK(HiveCountBlockDwarves, 2000);
@@ -0,0 +1,136 @@
+// Copyright (c) 2019 The Ring Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Ring-fork: Minotaur hashing benchmarks
+
+#include <bench/bench.h>
+
+#include <crypto/pow/minotaur.h>
+#include <pow.h>
+#include <primitives/block.h>
+#include <random.h>
+#include <uint256.h>
+
+#include <string>
+
+// Full Minotaur over an 80-byte block header, as done for every PoW check
+static void Minotaur_80b(benchmark::State& state)
+{
+    FastRandomContext rng(true);
+    CBlockHeader header;
+    header.nVersion = 0x20000000;
+    header.hashPrevBlock = rng.rand256();
+    header.hashMerkleRoot = rng.rand256();
+    header.nTime = 1556000000;
+    header.nBits = 0x1e0fffff;
+    while (state.KeepRunning()) {
+        header.nNonce++;
+        header.GetPowHash();
+    }
+}
+
+// Full Minotaur over a batch of 80-byte block headers with consecutive nonces, as done by the in-wallet miner
+static void Minotaur_80b_Batch(benchmark::State& state)
+{
+    FastRandomContext rng(true);
+    CBlockHeader headers[MinotaurBatch::MAX_LANES];
+    const unsigned char* data[MinotaurBatch::MAX_LANES];
+    unsigned char hashes[MinotaurBatch::MAX_LANES * 32];
+    headers[0].nVersion = 0x20000000;
+    headers[0].hashPrevBlock = rng.rand256();
+    headers[0].hashMerkleRoot = rng.rand256();
+    headers[0].nTime = 1556000000;
+    headers[0].nBits = 0x1e0fffff;
+    for (unsigned int i = 0; i < MinotaurBatch::MAX_LANES; i++) {
+        headers[i] = headers[0];
+        data[i] = (const unsigned char*)&headers[i].nVersion;
+    }
+
+    MinotaurBatch batch;
+    uint32_t nonce = 0;
+    while (state.KeepRunning()) {
+        for (unsigned int i = 0; i < MinotaurBatch::MAX_LANES; i++)
+            headers[i].nNonce = nonce++;
+        batch.Hash(data, 80, MinotaurBatch::MAX_LANES, hashes);
+    }
+}
+
+// Ring-fork: Hive: Both Minotaur passes of a dwarf check; deterministicRandString (6 block hashes) + DCT txid + dwarf nonce, then the hex of that result
+static void Minotaur_DwarfHash(benchmark::State& state)
+{
+    FastRandomContext rng(true);
+    std::string prefix;
+    for (int i = 0; i < 7; i++)
+        prefix += rng.rand256().GetHex();
+    uint32_t dwarfNonce = 0;
+    while (state.KeepRunning()) {
+        uint256 dwarfHash = CBlockHeader::MinotaurHashArbitrary(std::string(prefix + std::to_string(dwarfNonce++)).c_str());
+        CBlockHeader::MinotaurHashArbitrary(dwarfHash.ToString().c_str());
+    }
+}
+
+// Ring-fork: Hive: The same dwarf check through CDwarfHasher, which keeps a sha512 midstate over the prefix
+static void Minotaur_DwarfHash_Midstate(benchmark::State& state)
+{
+    FastRandomContext rng(true);
+    std::string deterministicRandString;
+    for (int i = 0; i < 6; i++)
+        deterministicRandString += rng.rand256().GetHex();
+    CDwarfHasher dwarfHasher(deterministicRandString, rng.rand256().GetHex());
+    uint32_t dwarfNonce = 0;
+    while (state.KeepRunning())
+        dwarfHasher.Hash(dwarfNonce++);
+}
+
+// Run a single one of Minotaur's algos over a 64-byte input, feeding each output back in as the next input
+static void MinotaurAlgo(benchmark::State& state, unsigned int algo)
+{
+    MinotaurHasher hasher;
+    unsigned char hash[64];
+    FastRandomContext rng(true);
+    uint256 seed = rng.rand256();
+    memcpy(hash, seed.begin(), 32);
+    memcpy(hash + 32, seed.begin(), 32);
+    while (state.KeepRunning())
+        hasher.HashAlgo(algo, hash, hash);
+}
+
+static void Minotaur_Blake512(benchmark::State& state) { MinotaurAlgo(state, 0); }
+static void Minotaur_BMW512(benchmark::State& state) { MinotaurAlgo(state, 1); }
+static void Minotaur_CubeHash512(benchmark::State& state) { MinotaurAlgo(state, 2); }
+static void Minotaur_Echo512(benchmark::State& state) { MinotaurAlgo(state, 3); }
+static void Minotaur_Fugue512(benchmark::State& state) { MinotaurAlgo(state, 4); }
+static void Minotaur_Groestl512(benchmark::State& state) { MinotaurAlgo(state, 5); }
+static void Minotaur_Hamsi512(benchmark::State& state) { MinotaurAlgo(state, 6); }
+static void Minotaur_SHA512(benchmark::State& state) { MinotaurAlgo(state, 7); }
+static void Minotaur_JH512(benchmark::State& state) { MinotaurAlgo(state, 8); }
+static void Minotaur_Keccak512(benchmark::State& state) { MinotaurAlgo(state, 9); }
+static void Minotaur_Luffa512(benchmark::State& state) { MinotaurAlgo(state, 10); }
+static void Minotaur_Shabal512(benchmark::State& state) { MinotaurAlgo(state, 11); }
+static void Minotaur_SHAvite512(benchmark::State& state) { MinotaurAlgo(state, 12); }
+static void Minotaur_SIMD512(benchmark::State& state) { MinotaurAlgo(state, 13); }
+static void Minotaur_Skein512(benchmark::State& state) { MinotaurAlgo(state, 14); }
+static void Minotaur_Whirlpool(benchmark::State& state) { MinotaurAlgo(state, 15); }
+
+BENCHMARK(Minotaur_80b, 60 * 1000);
+BENCHMARK(Minotaur_80b_Batch, 2 * 1000);
+BENCHMARK(Minotaur_DwarfHash, 30 * 1000);
+BENCHMARK(Minotaur_DwarfHash_Midstate, 30 * 1000);
+
+BENCHMARK(Minotaur_Blake512, 1200 * 1000);
+BENCHMARK(Minotaur_BMW512, 1200 * 1000);
+BENCHMARK(Minotaur_CubeHash512, 250 * 1000);
+BENCHMARK(Minotaur_Echo512, 250 * 1000);
+BENCHMARK(Minotaur_Fugue512, 500 * 1000);
+BENCHMARK(Minotaur_Groestl512, 300 * 1000);
+BENCHMARK(Minotaur_Hamsi512, 400 * 1000);
+BENCHMARK(Minotaur_SHA512, 1500 * 1000);
+BENCHMARK(Minotaur_JH512, 300 * 1000);
+BENCHMARK(Minotaur_Keccak512, 1200 * 1000);
+BENCHMARK(Minotaur_Luffa512, 500 * 1000);
+BENCHMARK(Minotaur_Shabal512, 1000 * 1000);
+BENCHMARK(Minotaur_SHAvite512, 400 * 1000);
+BENCHMARK(Minotaur_SIMD512, 100 * 1000);
+BENCHMARK(Minotaur_Skein512, 1000 * 1000);
+BENCHMARK(Minotaur_Whirlpool, 200 * 1000);
@@ -6,6 +6,7 @@
 #include <chain.h>
 #include <chainparams.h>        // Ring-fork: Hive
 #include <logging.h>            // Ring-fork: Hive
+#include <pow.h>                // Ring-fork: Hive
 #include <rpc/blockchain.h>     // Ring-fork: Hive
 #include <validation.h>         // Ring-fork: Hive
 #include <cmath>                // Ring-fork: Hive
@@ -123,6 +124,72 @@ void CBlockIndex::BuildSkip()
         pskip = pprev->GetAncestor(GetSkipHeight(nHeight));
 }
 
+// Ring-fork: Hive: Chain context
+void CBlockIndex::BuildHiveContext(const Consensus::Params& consensusParams)
+{
+    bool isHive = IsHiveMined(consensusParams);
+    bool isPop = IsPopMined(consensusParams);
+
+    pindexLastPow = (isHive || isPop) ? (pprev ? pprev->GetLastPow(consensusParams) : nullptr) : this;
+    pindexLastHive = isHive ? this : (pprev ? pprev->GetLastHive(consensusParams) : nullptr);
+    nHiveSincePow = (isHive || isPop) ? (pprev ? pprev->GetHiveSincePow(consensusParams) : 0) + (isHive ? 1 : 0) : 0;
+    nChainPopBlocks = (pprev ? pprev->GetChainPopBlocks(consensusParams) : 0) + (isPop ? 1 : 0);
+    nNextHiveBits = CalculateNextHiveWorkRequired(this, consensusParams);    // Uses the context above
+}
+
+const CBlockIndex* CBlockIndex::GetLastPow(const Consensus::Params& consensusParams) const
+{
+    if (pindexLastPow)
+        return pindexLastPow;
+
+    const CBlockIndex* pindex = this;
+    while (pindex->IsHiveMined(consensusParams) || pindex->IsPopMined(consensusParams)) {
+        assert(pindex->pprev);
+        pindex = pindex->pprev;
+    }
+    return pindex;
+}
+
+const CBlockIndex* CBlockIndex::GetLastHive(const Consensus::Params& consensusParams) const
+{
+    if (pindexLastPow)
+        return pindexLastHive;
+
+    const CBlockIndex* pindex = this;
+    while (pindex && !pindex->IsHiveMined(consensusParams))
+        pindex = pindex->pprev;
+    return pindex;
+}
+
+int CBlockIndex::GetHiveSincePow(const Consensus::Params& consensusParams) const
+{
+    if (pindexLastPow)
+        return nHiveSincePow;
+
+    int hiveBlocks = 0;
+    const CBlockIndex* pindex = this;
+    while (pindex->IsHiveMined(consensusParams) || pindex->IsPopMined(consensusParams)) {
+        if (pindex->IsHiveMined(consensusParams))
+            hiveBlocks++;
+
+        assert(pindex->pprev);
+        pindex = pindex->pprev;
+    }
+    return hiveBlocks;
+}
+
+int CBlockIndex::GetChainPopBlocks(const Consensus::Params& consensusParams) const
+{
+    if (pindexLastPow)
+        return nChainPopBlocks;
+
+    int popBlocks = 0;
+    for (const CBlockIndex* pindex = this; pindex; pindex = pindex->pprev)
+        if (pindex->IsPopMined(consensusParams))
+            popBlocks++;
+    return popBlocks;
+}
+
 // Ring-fork: Hive: Grant hive-mined blocks bonus work value
 arith_uint256 GetBlockProof(const CBlockIndex& block)
 {
@@ -144,12 +211,12 @@ arith_uint256 GetBlockProof(const CBlockIndex& block)
     // or ~bnTarget / (bnTarget+1) + 1.
     arith_uint256 bnTargetScaled = (~bnTarget / (bnTarget + 1)) + 1;
 
-    if (block.GetBlockHeader().IsHiveMined(consensusParams)) {
+    if (block.IsHiveMined(consensusParams)) {
         assert(block.pprev);
 
         // Set bnPreviousTarget from nBits in most recent pow block
         CBlockIndex* pindexTemp = block.pprev;
-        while (pindexTemp->GetBlockHeader().IsHiveMined(consensusParams)) {
+        while (pindexTemp->IsHiveMined(consensusParams)) {
             assert(pindexTemp->pprev);
             pindexTemp = pindexTemp->pprev;
         }
@@ -179,25 +246,21 @@ arith_uint256 GetBlockProof(const CBlockIndex& block)
             LogPrintf("**** Initial block chainwork = %s\n", bnTargetScaled.ToString());
         }
 
-        // Find last hive block
+        // Find last hive block within maxKPow blocks
         if (!block.pprev)
             return bnTargetScaled;
 
-        CBlockIndex *currBlock = block.pprev;
-        int blocksSinceHive;
+        const CBlockIndex* pindexLastHive = block.pprev->GetLastHive(consensusParams);
+        int blocksSinceHive = pindexLastHive ? block.pprev->nHeight - pindexLastHive->nHeight : consensusParams.maxKPow;
         double lastHiveDifficulty = 0;
 
-        for (blocksSinceHive = 0; blocksSinceHive < consensusParams.maxKPow; blocksSinceHive++) {
-            if (currBlock->GetBlockHeader().IsHiveMined(consensusParams)) {
-                lastHiveDifficulty = GetDifficulty(currBlock, true);
-                if (verbose) LogPrintf("**** Got last Hive diff = %.12f, at %s\n", lastHiveDifficulty, currBlock->GetBlockHash().ToString());
-                break;
-            }
-
-            if (!currBlock->pprev)
+        if (blocksSinceHive < consensusParams.maxKPow) {
+            lastHiveDifficulty = GetDifficulty(pindexLastHive, true);
+            if (verbose) LogPrintf("**** Got last Hive diff = %.12f, at %s\n", lastHiveDifficulty, pindexLastHive->GetBlockHash().ToString());
+        } else {
+            blocksSinceHive = consensusParams.maxKPow;
+            if (block.pprev->nHeight < consensusParams.maxKPow)     // Ran out of blocks before maxKPow
                 return bnTargetScaled;
-
-            currBlock = currBlock->pprev;
         }
 
         if (verbose) LogPrintf("**** Pow/pop blocks since last Hive block = %d\n", blocksSinceHive);
@@ -230,8 +293,8 @@ arith_uint256 GetNumHashes(const CBlockIndex& block)
 
     bnTarget.SetCompact(block.nBits, &fNegative, &fOverflow);
     if (fNegative || fOverflow || bnTarget == 0 
-        || block.GetBlockHeader().IsHiveMined(Params().GetConsensus())
-        || block.GetBlockHeader().IsPopMined(Params().GetConsensus())  // Ring-fork: Pop
+        || block.IsHiveMined(Params().GetConsensus())
+        || block.IsPopMined(Params().GetConsensus())  // Ring-fork: Pop
     )
         return 0;
 
@@ -168,6 +168,8 @@ enum BlockStatus: uint32_t {
     BLOCK_FAILED_MASK        =   BLOCK_FAILED_VALID | BLOCK_FAILED_CHILD,
 
     BLOCK_OPT_WITNESS       =   128, //!< block data in blk*.data was received with a witness-enforcing client
+
+    BLOCK_POW_ASSUMED       =   256, //!< Ring-fork: header was accepted without its pow being checked, as it leads to a checkpoint or the default assumevalid block
 };
 
 /** The block chain is a tree shaped structure starting with the
@@ -221,12 +223,38 @@ public:
     uint32_t nBits;
     uint32_t nNonce;
 
+    //! Ring-fork: PoW hash of the block header, stored once the header's PoW has been checked.
+    //! Null if not (yet) known; always null for Hive and Pop blocks.
+    uint256 hashPow;
+
     //! (memory only) Sequential id assigned to distinguish order in which blocks are received.
     int32_t nSequenceId;
 
     //! (memory only) Maximum nTime in the chain up to and including this block.
     unsigned int nTimeMax;
 
+    //! Ring-fork: Hive: (memory only) Chain context, set by BuildHiveContext(). The latest PoW block (neither
+    //! hive nor pop mined) at or before this one; null if the context hasn't been built.
+    const CBlockIndex* pindexLastPow;
+
+    //! Ring-fork: Hive: (memory only) The latest hive mined block at or before this one, if any.
+    const CBlockIndex* pindexLastHive;
+
+    //! Ring-fork: Hive: (memory only) Number of hive mined blocks after pindexLastPow, up to and including this one.
+    int nHiveSincePow;
+
+    //! Ring-fork: Pop: (memory only) Number of pop mined blocks in the chain up to and including this one.
+    int nChainPopBlocks;
+
+    //! Ring-fork: Hive: (memory only) Hive difficulty (compact dwarf hash target) for a hive block on this one; 0 if
+    //! the context hasn't been built.
+    unsigned int nNextHiveBits;
+
+    //! Ring-fork: (memory only) The block's hive or pop proof has passed, so needn't be checked again. Only set for
+    //! verdicts that hold on any branch: a hive verdict only when its DCT was found through the block's ancestry (not the
+    //! UTXO set). The pop proof's active chain check is redone where asked for.
+    bool fProofPassed;
+
     void SetNull()
     {
         phashBlock = nullptr;
@@ -242,12 +270,19 @@ public:
         nStatus = 0;
         nSequenceId = 0;
         nTimeMax = 0;
+        pindexLastPow = nullptr;
+        pindexLastHive = nullptr;
+        nHiveSincePow = 0;
+        nChainPopBlocks = 0;
+        nNextHiveBits = 0;
+        fProofPassed = false;
 
         nVersion       = 0;
         hashMerkleRoot = uint256();
         nTime          = 0;
         nBits          = 0;
         nNonce         = 0;
+        hashPow        = uint256();
     }
 
     CBlockIndex()
@@ -302,9 +337,23 @@ public:
         return *phashBlock;
     }
 
-    // Ring-fork: Seperate block hash and pow hash
+    // Ring-fork: Hive: Check if this block is hivemined, without building its header
+    bool IsHiveMined(const Consensus::Params& consensusParams) const
+    {
+        return nNonce == consensusParams.hiveNonceMarker;
+    }
+
+    // Ring-fork: Pop: Check if this block is popmined, without building its header
+    bool IsPopMined(const Consensus::Params& consensusParams) const
+    {
+        return nNonce == consensusParams.popNonceMarker;
+    }
+
+    // Ring-fork: Seperate block hash and pow hash (use the stored pow hash if we have it)
     uint256 GetBlockPowHash() const
     {
+        if (!hashPow.IsNull())
+            return hashPow;
         return GetBlockHeader().GetPowHash();
     }
 
@@ -377,6 +426,16 @@ public:
     //! Build the skiplist pointer for this entry.
     void BuildSkip();
 
+    //! Ring-fork: Hive: Build the chain context for this entry from its parent's.
+    void BuildHiveContext(const Consensus::Params& consensusParams);
+
+    //! Ring-fork: Hive: Chain context lookups. These are O(1) once BuildHiveContext() has run, and walk
+    //! the chain otherwise (eg for indexes made up in tests).
+    const CBlockIndex* GetLastPow(const Consensus::Params& consensusParams) const;
+    const CBlockIndex* GetLastHive(const Consensus::Params& consensusParams) const;
+    int GetHiveSincePow(const Consensus::Params& consensusParams) const;
+    int GetChainPopBlocks(const Consensus::Params& consensusParams) const;
+
     //! Efficiently find an ancestor of this block.
     CBlockIndex* GetAncestor(int height);
     const CBlockIndex* GetAncestor(int height) const;
@@ -431,6 +490,15 @@ public:
         READWRITE(nTime);
         READWRITE(nBits);
         READWRITE(nNonce);
+
+        // Ring-fork: The pow hash is appended only when known, so entries without it (including all those
+        // written before it was stored) still read, and older versions can still read entries that have it
+        if (ser_action.ForRead()) {
+            if (!s.empty())
+                READWRITE(hashPow);
+        } else if (!hashPow.IsNull()) {
+            READWRITE(hashPow);
+        }
     }
 
     uint256 GetBlockHash() const
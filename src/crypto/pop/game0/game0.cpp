@@ -6,27 +6,6 @@
 
 #include <crypto/pop/game0/game0.h>
 
-// Tile atlas
-constexpr Game0TileType game0TileAtlas[GAME0_NUM_TILES]  = {
-//    Connections from sides              Water
-//    0         1       2       3           
-    {{2,        1,      0,      0     },  0},
-    {{4,        0,      1,      0     },  0},
-    {{8,        4,      2,      1     },  0},
-    {{8+2,      8+1,    0,      1+2   },  0},
-    {{2+4+8,    1+4+8,  1+2+8,  1+2+4 },  0},
-    {{2,        1,      0,      0     },  0},
-    {{0,        0,      0,      0     },  0},
-    {{0,        0,      16,     0     },  0},
-    {{16,       0,      8,      4     },  0},
-    {{16,       8,      0,      2     },  0},
-    {{0,        0,      0,      0     },  0},
-    {{4,        8,      1,      2     },  0},
-    {{0,        0,      0,      16    },  0},
-    {{16,       8,      0,      2     },  0},
-    {{0,        0,      0,      0     },  0}
-};
-
 Game0::Game0() {
 	for (int y = 0; y < GAME0_BOARD_SIZE; y++)
 		for (int x = 0; x < GAME0_BOARD_SIZE; x++) {
@@ -45,6 +45,27 @@ struct Game0TileType {                                              // A tile ty
     int water;
 };
 
+// Tile atlas
+constexpr Game0TileType game0TileAtlas[GAME0_NUM_TILES]  = {
+//    Connections from sides              Water
+//    0         1       2       3           
+    {{2,        1,      0,      0     },  0},
+    {{4,        0,      1,      0     },  0},
+    {{8,        4,      2,      1     },  0},
+    {{8+2,      8+1,    0,      1+2   },  0},
+    {{2+4+8,    1+4+8,  1+2+8,  1+2+4 },  0},
+    {{2,        1,      0,      0     },  0},
+    {{0,        0,      0,      0     },  0},
+    {{0,        0,      16,     0     },  0},
+    {{16,       0,      8,      4     },  0},
+    {{16,       8,      0,      2     },  0},
+    {{0,        0,      0,      0     },  0},
+    {{4,        8,      1,      2     },  0},
+    {{0,        0,      0,      16    },  0},
+    {{16,       8,      0,      2     },  0},
+    {{0,        0,      0,      0     },  0}
+};
+
 class Game0 : public PopGame
 {
 public:
@@ -0,0 +1,200 @@
+// Copyright (c) 2019 The Ring Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Ring-fork: Pop: Allocation-free Game0 verifier
+
+#include <crypto/pop/game0/game0bitboard.h>
+
+#include <algorithm>
+
+namespace {
+
+// Rotate a tile's connection mask from its own sides to board sides; the internal room bit (16) doesn't turn
+constexpr int RotateConnections(int connections, int rotation) {
+    return (((connections & 15) << rotation | (connections & 15) >> (4 - rotation)) & 15) | (connections & 16);
+}
+
+// What a tile at the given rotation connects an incoming board side to, in board sides
+constexpr uint8_t RotatedConnections(int tileType, int rotation, int side) {
+    return RotateConnections(game0TileAtlas[tileType].connections[(side - rotation + 4) % 4], rotation);
+}
+
+// Compile-time index list, to fill the table below (std::index_sequence is C++14)
+template <int... Is> struct Indices {};
+template <int N, int... Is> struct MakeIndices : MakeIndices<N - 1, N - 1, Is...> {};
+template <int... Is> struct MakeIndices<0, Is...> { typedef Indices<Is...> type; };
+
+struct RotationTable {
+    uint8_t connections[GAME0_NUM_TILES * 4 * 4];           // By [tileType][rotation][incoming side]
+};
+
+template <int... Is>
+constexpr RotationTable MakeRotationTable(Indices<Is...>) {
+    return RotationTable{{ RotatedConnections(Is / 16, (Is / 4) % 4, Is % 4)... }};
+}
+
+constexpr RotationTable rotationTable = MakeRotationTable(MakeIndices<GAME0_NUM_TILES * 4 * 4>::type());
+
+// Get the tile type that comes up after the given moves, mutating the hash as Game0::GetNextTile does
+int NextTile(uint256& gameMutatedHash, const unsigned char* moves, size_t nMoves) {
+    unsigned char size = nMoves;                            // Compact size; moves never number 253 or more
+    CHash256().Write(gameMutatedHash.begin(), gameMutatedHash.size()).Write(&size, 1).Write(moves, nMoves).Finalize(gameMutatedHash.begin());
+    return gameMutatedHash.ByteAt(13) % GAME0_NUM_TILES;
+}
+
+} // namespace
+
+void Game0Bitboard::Init(const uint256& gameSourceHash) {
+    occupied = 0;
+    nMoves = 0;
+    gameMutatedHash = gameSourceHash;
+    currentTile = NextTile(gameMutatedHash, moves, 0);
+    nextTile = NextTile(gameMutatedHash, moves, 0);
+}
+
+Game0Bitboard::Result Game0Bitboard::Place(unsigned char move) {
+    if (nMoves >= GAME0_BOARD_CELLS)
+        return GAME0_BAD_SIZE;
+
+    int x = (move >> 3) & 7;
+    int y = move & 7;
+    if (x >= GAME0_BOARD_SIZE || y >= GAME0_BOARD_SIZE)
+        return GAME0_OUT_OF_RANGE;
+
+    int cell = y * GAME0_BOARD_SIZE + x;
+    if (occupied >> cell & 1)
+        return GAME0_OCCUPIED;
+
+    uint64_t neighbours = (x > 0 ? 1ULL << (cell - 1) : 0) | (x < GAME0_BOARD_SIZE - 1 ? 1ULL << (cell + 1) : 0)
+                        | (y > 0 ? 1ULL << (cell - GAME0_BOARD_SIZE) : 0) | (y < GAME0_BOARD_SIZE - 1 ? 1ULL << (cell + GAME0_BOARD_SIZE) : 0);
+    if (nMoves > 0 && !(occupied & neighbours))
+        return GAME0_NO_NEIGHBOUR;
+
+    occupied |= 1ULL << cell;
+    tileType[cell] = currentTile;
+    rotation[cell] = move >> 6;
+    moves[nMoves++] = move;
+
+    currentTile = nextTile;
+    nextTile = NextTile(gameMutatedHash, moves, nMoves);
+    return GAME0_OK;
+}
+
+Game0Bitboard::Result Game0Bitboard::Replay(const uint256& gameSourceHash, const unsigned char* movesToReplay, size_t nMovesToReplay) {
+    if (nMovesToReplay > GAME0_BOARD_CELLS)
+        return GAME0_BAD_SIZE;
+
+    Init(gameSourceHash);
+    for (size_t i = 0; i < nMovesToReplay; i++) {
+        Result result = Place(movesToReplay[i]);
+        if (result != GAME0_OK)
+            return result;
+    }
+
+    return GAME0_OK;
+}
+
+int Game0Bitboard::CountConnectedRooms(int start, int direction) const {
+    // A branch is a cell and the board side it's left by. Each is followed at most once, so the stack never holds more
+    // than there are branches.
+    uint64_t followed[4] = {0, 0, 0, 0};
+    uint8_t stack[GAME0_BOARD_CELLS * 4];
+    int nStack = 0;
+    int connectedRooms = 0;
+
+    followed[direction] |= 1ULL << start;
+    stack[nStack++] = start * 4 + direction;
+    while (nStack > 0) {
+        int branch = stack[--nStack];
+        int cell = branch >> 2;
+        direction = branch & 3;
+
+        int x = cell % GAME0_BOARD_SIZE, y = cell / GAME0_BOARD_SIZE;
+        switch (direction) {
+            case 0: y--; break;
+            case 1: x++; break;
+            case 2: y++; break;
+            case 3: x--; break;
+        }
+        if (y < 0 || y >= GAME0_BOARD_SIZE || x < 0 || x >= GAME0_BOARD_SIZE)
+            continue;
+        cell = y * GAME0_BOARD_SIZE + x;
+        if (cell == start || !(occupied >> cell & 1))
+            continue;
+
+        int connections = rotationTable.connections[(tileType[cell] * 4 + rotation[cell]) * 4 + (direction + 2) % 4];
+        if (connections & 16) {
+            connectedRooms++;
+            continue;
+        }
+
+        for (int side = 0; side < 4; side++) {
+            if ((connections >> side & 1) && !(followed[side] >> cell & 1)) {
+                followed[side] |= 1ULL << cell;
+                stack[nStack++] = cell * 4 + side;
+            }
+        }
+    }
+
+    return connectedRooms;
+}
+
+int Game0Bitboard::CalculateScore() const {
+    int maxConnectedRooms = 0;
+    for (int cell = 0; cell < GAME0_BOARD_CELLS; cell++) {
+        if (!(occupied >> cell & 1))
+            continue;
+        for (int side = 0; side < 4; side++) {
+            int connections = rotationTable.connections[(tileType[cell] * 4 + rotation[cell]) * 4 + side];
+            if (connections & 16)
+                maxConnectedRooms = std::max(maxConnectedRooms, CountConnectedRooms(cell, side));
+        }
+    }
+
+    return maxConnectedRooms > 0 ? (maxConnectedRooms + 1) * 10 : 0;
+}
+
+int Game0Bitboard::CountOpenEnds() const {
+    int openEnds = 0;
+    for (int cell = 0; cell < GAME0_BOARD_CELLS; cell++) {
+        if (!(occupied >> cell & 1))
+            continue;
+        int x = cell % GAME0_BOARD_SIZE, y = cell / GAME0_BOARD_SIZE;
+        const uint8_t* connections = &rotationTable.connections[(tileType[cell] * 4 + rotation[cell]) * 4];
+        if (connections[0] && y > 0 && !(occupied >> (cell - GAME0_BOARD_SIZE) & 1)) openEnds++;
+        if (connections[1] && x < GAME0_BOARD_SIZE - 1 && !(occupied >> (cell + 1) & 1)) openEnds++;
+        if (connections[2] && y < GAME0_BOARD_SIZE - 1 && !(occupied >> (cell + GAME0_BOARD_SIZE) & 1)) openEnds++;
+        if (connections[3] && x > 0 && !(occupied >> (cell - 1) & 1)) openEnds++;
+    }
+
+    return openEnds;
+}
+
+const char* Game0Bitboard::ResultString(Result result) {
+    switch (result) {
+        case GAME0_OK: break;
+        case GAME0_BAD_SIZE: return "Impossible solution size";
+        case GAME0_OUT_OF_RANGE: return "Attempted out-of-range placement";
+        case GAME0_OCCUPIED: return "Attempted to place on an occupied tile";
+        case GAME0_NO_NEIGHBOUR: return "Attempted to place without occupied neighbour";
+    }
+    return "";
+}
+
+bool VerifyGame0Solution(int targetScore, const uint256& gameSourceHash, const std::vector<unsigned char>& solution, std::string& strError) {
+    Game0Bitboard board;
+    Game0Bitboard::Result result = board.Replay(gameSourceHash, solution.data(), solution.size());
+    if (result != Game0Bitboard::GAME0_OK) {
+        strError = Game0Bitboard::ResultString(result);
+        return false;
+    }
+
+    int score = board.CalculateScore();
+    if (score < targetScore) {
+        strError = "Solution does not meet score target; score=" + std::to_string(score) + ", target=" + std::to_string(targetScore);
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,73 @@
+// Copyright (c) 2019 The Ring Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Ring-fork: Pop: Allocation-free Game0 verifier
+
+/*
+Game0Bitboard replays and scores Game0 solutions exactly as Game0::VerifyGameSolution does, for use in block validation.
+The occupied cells are held in a 49-bit bitboard (bit y * GAME0_BOARD_SIZE + x), rotated tile connections come from a
+table built at compile time, and room searches run on a fixed-size stack with a bitset of followed branches, so nothing
+is allocated on the heap unless verification fails and an error string is built.
+*/
+
+#ifndef RING_CRYPTO_POP_GAME0_GAME0BITBOARD_H
+#define RING_CRYPTO_POP_GAME0_GAME0BITBOARD_H
+
+#include <crypto/pop/game0/game0.h>
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#define GAME0_BOARD_CELLS     (GAME0_BOARD_SIZE * GAME0_BOARD_SIZE)
+
+class Game0Bitboard
+{
+public:
+    enum Result {
+        GAME0_OK,
+        GAME0_BAD_SIZE,             // More moves than cells
+        GAME0_OUT_OF_RANGE,         // Move off the board
+        GAME0_OCCUPIED,             // Move onto an occupied cell
+        GAME0_NO_NEIGHBOUR,         // Move (other than the first) with no occupied neighbour
+    };
+
+    // Start a fresh game from gameSourceHash
+    void Init(const uint256& gameSourceHash);
+
+    // Place the current tile with the given move byte, as Game0::PlaceTile does. On failure the board is unchanged.
+    Result Place(unsigned char move);
+
+    // Replay the moves against the game from gameSourceHash. On success the board holds the final position.
+    Result Replay(const uint256& gameSourceHash, const unsigned char* moves, size_t nMoves);
+
+    // Score the board as Game0::CalculateScore does
+    int CalculateScore() const;
+
+    // Count connections leading off occupied cells onto empty cells of the board; room for the position to grow
+    int CountOpenEnds() const;
+
+    uint64_t GetOccupied() const { return occupied; }                       // Occupied cells
+    int GetTilesPlaced() const { return nMoves; }                           // Number of tiles placed so far
+    const unsigned char* GetMoves() const { return moves; }                 // Moves made so far, as solution bytes
+
+    // Get the error Game0::PlaceTile or VerifyGameSolution reports for a replay result
+    static const char* ResultString(Result result);
+
+private:
+    int CountConnectedRooms(int start, int direction) const;    // Rooms reachable from the start cell, leaving it in the given (board) direction
+
+    uint256 gameMutatedHash;                                // Hash used to generate tiles and mutated every move
+    int currentTile, nextTile;                              // Tile types of current and next tiles
+    int nMoves;                                             // Tiles placed
+    unsigned char moves[GAME0_BOARD_CELLS];                 // Solution so far
+    uint64_t occupied;                                      // Occupied cells
+    uint8_t tileType[GAME0_BOARD_CELLS];                    // Tile type of each occupied cell
+    uint8_t rotation[GAME0_BOARD_CELLS];                    // Rotation of each occupied cell
+};
+
+// Ring-fork: Pop: Verify a Game0 solution; a drop-in for Game0::VerifyGameSolution that only allocates on failure
+bool VerifyGame0Solution(int targetScore, const uint256& gameSourceHash, const std::vector<unsigned char>& solution, std::string& strError);
+
+#endif // RING_CRYPTO_POP_GAME0_GAME0BITBOARD_H
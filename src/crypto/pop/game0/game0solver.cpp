@@ -0,0 +1,260 @@
+// Copyright (c) 2019 The Ring Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Ring-fork: Pop: Headless Game0 solver
+
+#include <crypto/pop/game0/game0solver.h>
+
+#include <crypto/common.h>
+#include <crypto/pop/game0/game0bitboard.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+constexpr uint64_t BOARD_MASK = (1ULL << GAME0_BOARD_CELLS) - 1;
+constexpr size_t INTERRUPT_POLL_PARENTS = 64;               // Parents the calling thread expands between polls of fnInterrupt
+
+// Cells in column x, from row y down
+constexpr uint64_t ColumnMask(int x, int y = 0) {
+    return y == GAME0_BOARD_SIZE ? 0 : (1ULL << (y * GAME0_BOARD_SIZE + x)) | ColumnMask(x, y + 1);
+}
+
+// Empty cells a tile may be placed on: any cell on an empty board, otherwise those next to an occupied cell
+uint64_t LegalCells(uint64_t occupied) {
+    if (!occupied)
+        return BOARD_MASK;
+    uint64_t neighbours = occupied << GAME0_BOARD_SIZE | occupied >> GAME0_BOARD_SIZE
+                        | (occupied & ~ColumnMask(GAME0_BOARD_SIZE - 1)) << 1 | (occupied & ~ColumnMask(0)) >> 1;
+    return neighbours & BOARD_MASK & ~occupied;
+}
+
+struct Position
+{
+    Game0Bitboard board;
+    int score;
+    int64_t rank;
+};
+
+bool RanksHigher(const Position& a, const Position& b) {
+    return a.rank > b.rank;
+}
+
+// Keep only the nWidth highest ranked positions
+void Prune(std::vector<Position>& positions, size_t nWidth) {
+    if (positions.size() > nWidth) {
+        std::nth_element(positions.begin(), positions.begin() + nWidth, positions.end(), RanksHigher);
+        positions.resize(nWidth);
+    }
+}
+
+// Per-thread xorshift, for tie-break jitter; seeded from the game so searches are repeatable
+struct Jitter
+{
+    uint64_t state;
+    explicit Jitter(uint64_t seed) : state(seed | 1) {}
+    int Next() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state & 7;
+    }
+};
+
+struct Expansion
+{
+    std::vector<Position> children;                         // Best children of this thread's parents
+    Position best;                                          // Highest scoring child
+    uint64_t nPositions = 0;
+};
+
+// Expand parents nThread, nThread + nThreads, ... of the beam, stopping early once fInterrupted is set. Only the calling
+// thread passes fnInterrupt, which it polls every INTERRUPT_POLL_PARENTS parents and sets fInterrupted from.
+void Expand(const std::vector<Position>& beam, size_t nThread, size_t nThreads, size_t nWidth, uint64_t seed, const std::function<bool()>& fnInterrupt, std::atomic<bool>& fInterrupted, Expansion& expansion) {
+    Jitter jitter(seed);
+    expansion.best.score = -1;
+    size_t nParents = 0;
+    for (size_t i = nThread; i < beam.size(); i += nThreads) {
+        if (fInterrupted.load(std::memory_order_relaxed))
+            break;
+        if (fnInterrupt && ++nParents % INTERRUPT_POLL_PARENTS == 0 && fnInterrupt()) {
+            fInterrupted.store(true, std::memory_order_relaxed);
+            break;
+        }
+
+        const Game0Bitboard& parent = beam[i].board;
+        uint64_t legal = LegalCells(parent.GetOccupied());
+        for (int cell = 0; cell < GAME0_BOARD_CELLS; cell++) {
+            if (!(legal >> cell & 1))
+                continue;
+            unsigned char move = (cell % GAME0_BOARD_SIZE) << 3 | cell / GAME0_BOARD_SIZE;
+            for (int rotation = 0; rotation < 4; rotation++) {
+                Position child;
+                child.board = parent;
+                if (child.board.Place(move | rotation << 6) != Game0Bitboard::GAME0_OK)
+                    continue;
+                child.score = child.board.CalculateScore();
+                child.rank = (int64_t)child.score * 1024 + child.board.CountOpenEnds() * 8 + jitter.Next();
+                expansion.nPositions++;
+
+                if (child.score > expansion.best.score)
+                    expansion.best = child;
+                expansion.children.push_back(child);
+            }
+        }
+
+        // Don't let the candidates grow far beyond what can survive
+        if (expansion.children.size() > nWidth * 4)
+            Prune(expansion.children, nWidth);
+    }
+    Prune(expansion.children, nWidth);
+}
+
+// Workers kept for the whole search, each expanding its share of every level's beam alongside the calling thread
+class ExpandPool
+{
+public:
+    explicit ExpandPool(size_t nWorkers) {
+        for (size_t t = 1; t <= nWorkers; t++)
+            threads.emplace_back(&ExpandPool::Worker, this, t);
+    }
+
+    ~ExpandPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            fStop = true;
+        }
+        condWork.notify_all();
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+
+    // Threads available, the calling one included
+    size_t Size() const { return threads.size() + 1; }
+
+    // Expand the beam across the first nThreads threads, the calling one taking the first share
+    void Run(const std::vector<Position>& beam, size_t nThreads, size_t nWidth, uint64_t seed, const std::function<bool()>& fnInterrupt, std::atomic<bool>& fInterrupted, std::vector<Expansion>& expansions) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = Job{&beam, nThreads, nWidth, seed, &fInterrupted, &expansions};
+            nPending = nThreads - 1;
+            nGeneration++;
+        }
+        condWork.notify_all();
+        Expand(beam, 0, nThreads, nWidth, seed, fnInterrupt, fInterrupted, expansions[0]);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        condDone.wait(lock, [this]() { return nPending == 0; });
+    }
+
+private:
+    struct Job
+    {
+        const std::vector<Position>* pbeam;
+        size_t nThreads;
+        size_t nWidth;
+        uint64_t seed;
+        std::atomic<bool>* pfInterrupted;
+        std::vector<Expansion>* pexpansions;
+    };
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable condWork;
+    std::condition_variable condDone;
+    Job job;
+    size_t nPending = 0;
+    uint64_t nGeneration = 0;                               // Bumped for each level; a level can't end until its workers have seen it
+    bool fStop = false;
+
+    void Worker(size_t nThread) {
+        uint64_t nLastGeneration = 0;
+        while (true) {
+            Job current;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condWork.wait(lock, [&]() { return fStop || nGeneration != nLastGeneration; });
+                if (fStop)
+                    return;
+                nLastGeneration = nGeneration;
+                current = job;
+            }
+            if (nThread >= current.nThreads)
+                continue;
+
+            Expand(*current.pbeam, nThread, current.nThreads, current.nWidth, current.seed + nThread, nullptr, *current.pfInterrupted, (*current.pexpansions)[nThread]);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--nPending == 0)
+                condDone.notify_one();
+        }
+    }
+};
+
+// Run one pass of the search, updating the result with the best position seen. Returns false if interrupted.
+bool SearchPass(const Position& root, int targetScore, ExpandPool& pool, size_t nWidth, uint64_t seed, const std::function<bool()>& fnInterrupt, Game0SolverResult& result, Game0Bitboard& best) {
+    std::vector<Position> beam(1, root);
+    std::atomic<bool> fInterrupted(false);
+    for (int nDepth = 0; nDepth < GAME0_BOARD_CELLS && !beam.empty(); nDepth++) {
+        if (fnInterrupt && fnInterrupt())
+            return false;
+
+        // Expand the beam
+        size_t nThreads = std::min(pool.Size(), beam.size());
+        std::vector<Expansion> expansions(nThreads);
+        pool.Run(beam, nThreads, nWidth, seed ^ (uint64_t)nDepth << 32, fnInterrupt, fInterrupted, expansions);
+
+        // Merge the survivors into the next beam; an interrupted level still counts towards the best position seen
+        beam.clear();
+        for (Expansion& expansion : expansions) {
+            result.nPositions += expansion.nPositions;
+            if (expansion.best.score > result.nScore) {
+                result.nScore = expansion.best.score;
+                best = expansion.best.board;
+            }
+            beam.insert(beam.end(), expansion.children.begin(), expansion.children.end());
+        }
+        if (result.nScore >= targetScore)
+            return true;
+        if (fInterrupted.load())
+            return false;
+        Prune(beam, nWidth);
+    }
+
+    return true;
+}
+
+} // namespace
+
+Game0SolverResult SolveGame0(const uint256& gameSourceHash, int targetScore, int nThreads, int nBeamWidth, const std::function<bool()>& fnInterrupt) {
+    nThreads = std::max(nThreads, 1);
+    nBeamWidth = std::min(std::max(nBeamWidth, 1), GAME0_SOLVER_MAX_BEAM_WIDTH);
+
+    Position root;
+    root.board.Init(gameSourceHash);
+    root.score = root.board.CalculateScore();
+    root.rank = 0;
+
+    Game0SolverResult result;
+    result.nScore = root.score;
+    result.nPasses = 0;
+    result.nPositions = 0;
+    Game0Bitboard best = root.board;
+
+    ExpandPool pool(nThreads - 1);
+    uint64_t seed = ReadLE64(gameSourceHash.begin());
+    for (int nPass = 0; nPass < GAME0_SOLVER_MAX_PASSES && result.nScore < targetScore; nPass++) {
+        result.nPasses++;
+        size_t nWidth = std::min((size_t)nBeamWidth << nPass, (size_t)GAME0_SOLVER_MAX_BEAM_WIDTH);
+        if (!SearchPass(root, targetScore, pool, nWidth, seed ^ (uint64_t)nPass << 48, fnInterrupt, result, best))
+            break;
+    }
+
+    result.fSolved = result.nScore >= targetScore;
+    result.solution.assign(best.GetMoves(), best.GetMoves() + best.GetTilesPlaced());
+    return result;
+}
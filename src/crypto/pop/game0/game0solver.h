@@ -0,0 +1,43 @@
+// Copyright (c) 2019 The Ring Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Ring-fork: Pop: Headless Game0 solver
+
+/*
+SolveGame0 plays a game by beam search over Game0Bitboard positions. Each level places one more tile: every position in
+the beam is expanded with each legal move (every empty cell next to an occupied one, in each rotation), and the best
+children make up the next beam. Positions are ranked by score, then by open ends (connections leading onto empty cells)
+with a little seeded jitter to break ties. Expanding a level is split across a pool of threads kept for the whole
+search. When a pass fills the board without reaching the target, the next pass starts over with a wider beam and fresh
+jitter.
+
+The search stops as soon as any position reaches the target, when fnInterrupt returns true (it's polled between
+levels and every few parents while expanding, from the calling thread only), or after GAME0_SOLVER_MAX_PASSES passes.
+*/
+
+#ifndef RING_CRYPTO_POP_GAME0_GAME0SOLVER_H
+#define RING_CRYPTO_POP_GAME0_GAME0SOLVER_H
+
+#include <uint256.h>
+
+#include <functional>
+#include <stdint.h>
+#include <vector>
+
+static const int GAME0_SOLVER_MAX_PASSES = 8;               // Each pass doubles the beam width
+static const int GAME0_SOLVER_MAX_BEAM_WIDTH = 16384;
+
+struct Game0SolverResult
+{
+    bool fSolved;                                           // Solution meets the target
+    std::vector<unsigned char> solution;                    // Best solution found
+    int nScore;                                             // Its score
+    int nPasses;                                            // Passes started
+    uint64_t nPositions;                                    // Positions evaluated
+};
+
+// Search for a solution to the game from gameSourceHash scoring at least targetScore
+Game0SolverResult SolveGame0(const uint256& gameSourceHash, int targetScore, int nThreads, int nBeamWidth, const std::function<bool()>& fnInterrupt);
+
+#endif // RING_CRYPTO_POP_GAME0_GAME0SOLVER_H
@@ -0,0 +1,406 @@
+// Copyright (c) 2019 The Ring Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Ring-fork: Minotaur hash algorithm
+
+#if defined(HAVE_CONFIG_H)
+#include <config/ring-config.h>
+#endif
+
+#include <crypto/pow/minotaur.h>
+
+#include <algorithm>
+#include <assert.h>
+#include <string.h>
+#ifdef MINOTAUR_DEBUG
+#include <stdio.h>
+#endif
+
+#if defined(__x86_64__) || defined(__amd64__) || defined(__i386__)
+#if defined(USE_ASM)
+#include <cpuid.h>
+#endif
+#endif
+
+namespace minotaur_aesni
+{
+void Echo512(const unsigned char in[64], unsigned char out[64]);
+void Fugue512(const unsigned char in[64], unsigned char out[64]);
+void Groestl512(const unsigned char in[64], unsigned char out[64]);
+void Shavite512(const unsigned char in[64], unsigned char out[64]);
+}
+
+namespace minotaur_avx2
+{
+void Cubehash512(const unsigned char in[64], unsigned char out[64]);
+void Blake512_4way(const unsigned char in[256], unsigned char out[256]);
+void Keccak512_4way(const unsigned char in[256], unsigned char out[256]);
+void Skein512_4way(const unsigned char in[256], unsigned char out[256]);
+}
+
+// Torture garden topology: left (last byte of node's output even) and right (odd) child of each node.
+// Note that both sides of 19 and 20 lead to 21, and 21 has no children (to make traversal complete).
+static constexpr unsigned char gardenChildren[MINOTAUR_GARDEN_NODES - 1][2] = {
+    {1, 2},   {3, 4},   {5, 6},   {7, 8},   {9, 10},  {11, 12}, {13, 14},
+    {15, 16}, {15, 16}, {15, 16}, {15, 16}, {17, 18}, {17, 18}, {17, 18}, {17, 18},
+    {19, 20}, {19, 20}, {19, 20}, {19, 20},
+    {21, 21}, {21, 21}
+};
+
+namespace
+{
+typedef void (*AlgoFunction)(const unsigned char in[64], unsigned char out[64]);
+
+// Accelerated single-block implementations selected by MinotaurAutoDetect(). When null, the SPH implementation is used.
+AlgoFunction Cubehash512 = nullptr;
+AlgoFunction Echo512 = nullptr;
+AlgoFunction Fugue512 = nullptr;
+AlgoFunction Groestl512 = nullptr;
+AlgoFunction Shavite512 = nullptr;
+
+// 4-lane implementations used by MinotaurBatch, indexed by algo. Null where there isn't one.
+typedef void (*AlgoFunction4Way)(const unsigned char in[256], unsigned char out[256]);
+AlgoFunction4Way algo4Way[MINOTAUR_ALGO_COUNT] = {};
+
+bool SelfTest() {
+    // Input: the bytes 0x00 - 0x3f
+    unsigned char data[64];
+    for (int i = 0; i < 64; i++)
+        data[i] = i;
+
+    // Expected CubeHash-512, ECHO-512, Fugue-512, Groestl-512 and SHAvite-512 outputs for the input above
+    static const unsigned char result[5][64] = {
+        {
+            0x50, 0x13, 0x36, 0x30, 0x4d, 0x23, 0x5c, 0xf9, 0x82, 0x5d, 0xa6, 0xf2, 0x66, 0x23, 0xf2, 0x0c,
+            0xf3, 0x38, 0xc2, 0xef, 0xa1, 0xea, 0xc0, 0xf6, 0x68, 0xdc, 0x1d, 0x99, 0xa1, 0xf6, 0x7b, 0xf6,
+            0x17, 0x45, 0x3a, 0x1c, 0x86, 0x1c, 0x96, 0x28, 0xf7, 0xb9, 0x8d, 0xd5, 0xca, 0x50, 0xba, 0xf6,
+            0xd7, 0x52, 0x99, 0xf1, 0x3f, 0xa4, 0x3d, 0x28, 0xd3, 0x9b, 0x40, 0x31, 0x41, 0x61, 0x13, 0x5f
+        },
+        {
+            0x2f, 0x7a, 0x64, 0xce, 0xc7, 0xe0, 0x7c, 0x9d, 0x79, 0x1f, 0x90, 0x2b, 0x83, 0x8e, 0x9a, 0x77,
+            0x6c, 0x03, 0xda, 0x43, 0xef, 0x88, 0x58, 0xe8, 0x9c, 0x16, 0xbb, 0xfa, 0x7e, 0xff, 0x64, 0x1d,
+            0x5e, 0x30, 0x9d, 0x9a, 0x51, 0xe1, 0x31, 0x77, 0xcb, 0xb8, 0x6f, 0xb1, 0x02, 0x10, 0x70, 0xc6,
+            0x47, 0x63, 0xfa, 0x93, 0xb3, 0x98, 0x24, 0xda, 0xfd, 0x77, 0x31, 0x54, 0xcf, 0x2e, 0xc0, 0x58
+        },
+        {
+            0x8d, 0xaf, 0x6f, 0xdf, 0x35, 0x8c, 0x3c, 0x83, 0x17, 0x9a, 0xfc, 0x8d, 0x07, 0x2d, 0x5f, 0x8b,
+            0x64, 0x82, 0x37, 0x17, 0x5e, 0x6c, 0x82, 0xaa, 0x7c, 0xa4, 0xc3, 0x76, 0xce, 0x7e, 0xf6, 0xf0,
+            0xfb, 0x85, 0xe4, 0xd7, 0xb8, 0xee, 0xc8, 0x6b, 0x5b, 0x1d, 0xd0, 0x6b, 0x2b, 0xf2, 0xc9, 0xbc,
+            0x0e, 0xc6, 0x1c, 0xee, 0x1e, 0x32, 0x02, 0xa0, 0x04, 0xe5, 0xed, 0x28, 0xae, 0x90, 0xc9, 0x8b
+        },
+        {
+            0x6e, 0x8c, 0x9b, 0x90, 0xe3, 0x6c, 0xea, 0x68, 0xc0, 0x29, 0xa7, 0xd8, 0xb9, 0x5b, 0x71, 0x8c,
+            0x84, 0x20, 0x5d, 0x81, 0xbe, 0x22, 0x7b, 0xa6, 0x15, 0x10, 0xf5, 0x67, 0xd4, 0x6b, 0x83, 0xed,
+            0xd1, 0x1f, 0x30, 0x1b, 0xf1, 0xe7, 0x04, 0x1b, 0xe9, 0x91, 0xb2, 0x2f, 0xdb, 0xee, 0x82, 0xdb,
+            0xdc, 0xe7, 0xab, 0x0e, 0x0e, 0xe4, 0x2a, 0x79, 0x5c, 0xa9, 0x65, 0xa4, 0x39, 0x53, 0x2a, 0x39
+        },
+        {
+            0x4b, 0x53, 0x73, 0x45, 0x38, 0xb1, 0x13, 0xc1, 0x63, 0x71, 0x04, 0x88, 0x7e, 0x9f, 0x21, 0x50,
+            0xfa, 0x4a, 0xd9, 0xec, 0x70, 0x55, 0x2d, 0x8e, 0xd6, 0x2f, 0x01, 0x34, 0xa4, 0x7a, 0x2f, 0x4e,
+            0x81, 0x34, 0xb2, 0x36, 0x69, 0x32, 0x98, 0x3b, 0x41, 0x27, 0xcb, 0xcb, 0xa5, 0x9c, 0xda, 0x04,
+            0xbf, 0x6d, 0x00, 0x05, 0xb5, 0xba, 0x04, 0xde, 0xa9, 0x28, 0x79, 0xf1, 0x5e, 0x80, 0xa2, 0x8a
+        }
+    };
+    static const unsigned int algos[5] = {2, 3, 4, 5, 12};
+
+    // Test each algo both out-of-place and in-place, via whichever implementation is selected
+    MinotaurHasher hasher;
+    for (int i = 0; i < 5; i++) {
+        unsigned char out[64];
+        hasher.HashAlgo(algos[i], data, out);
+        if (memcmp(out, result[i], 64) != 0) return false;
+        memcpy(out, data, 64);
+        hasher.HashAlgo(algos[i], out, out);
+        if (memcmp(out, result[i], 64) != 0) return false;
+    }
+
+    // Test the 4-lane implementations, if available, against the single-lane ones
+    for (unsigned int algo = 0; algo < MINOTAUR_ALGO_COUNT; algo++) {
+        if (!algo4Way[algo])
+            continue;
+        unsigned char in[256], out[256], expected[64];
+        for (int i = 0; i < 256; i++)
+            in[i] = i * 7 + algo;
+        algo4Way[algo](in, out);
+        for (int lane = 0; lane < 4; lane++) {
+            hasher.HashAlgo(algo, in + lane * 64, expected);
+            if (memcmp(out + lane * 64, expected, 64) != 0) return false;
+        }
+    }
+
+    return true;
+}
+
+#if defined(USE_ASM) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
+// We can't use cpuid.h's __get_cpuid as it does not support subleafs.
+void inline cpuid(uint32_t leaf, uint32_t subleaf, uint32_t& a, uint32_t& b, uint32_t& c, uint32_t& d)
+{
+#ifdef __GNUC__
+    __cpuid_count(leaf, subleaf, a, b, c, d);
+#else
+  __asm__ ("cpuid" : "=a"(a), "=b"(b), "=c"(c), "=d"(d) : "0"(leaf), "2"(subleaf));
+#endif
+}
+
+#if defined(ENABLE_AVX2) && !defined(BUILD_RING_INTERNAL)
+/** Check whether the OS has enabled AVX registers. */
+bool AVXEnabled()
+{
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return (a & 6) == 6;
+}
+#endif
+#endif
+} // namespace
+
+void MinotaurHasher::HashAlgo(unsigned int algo, const unsigned char in[64], unsigned char out[64]) {
+    switch (algo) {
+        case 0:
+            sph_blake512_init(&context_blake);
+            sph_blake512(&context_blake, in, 64);
+            sph_blake512_close(&context_blake, out);
+            break;
+        case 1:
+            sph_bmw512_init(&context_bmw);
+            sph_bmw512(&context_bmw, in, 64);
+            sph_bmw512_close(&context_bmw, out);
+            break;
+        case 2:
+            if (Cubehash512) {
+                Cubehash512(in, out);
+                break;
+            }
+            sph_cubehash512_init(&context_cubehash);
+            sph_cubehash512(&context_cubehash, in, 64);
+            sph_cubehash512_close(&context_cubehash, out);
+            break;
+        case 3:
+            if (Echo512) {
+                Echo512(in, out);
+                break;
+            }
+            sph_echo512_init(&context_echo);
+            sph_echo512(&context_echo, in, 64);
+            sph_echo512_close(&context_echo, out);
+            break;
+        case 4:
+            if (Fugue512) {
+                Fugue512(in, out);
+                break;
+            }
+            sph_fugue512_init(&context_fugue);
+            sph_fugue512(&context_fugue, in, 64);
+            sph_fugue512_close(&context_fugue, out);
+            break;
+        case 5:
+            if (Groestl512) {
+                Groestl512(in, out);
+                break;
+            }
+            sph_groestl512_init(&context_groestl);
+            sph_groestl512(&context_groestl, in, 64);
+            sph_groestl512_close(&context_groestl, out);
+            break;
+        case 6:
+            sph_hamsi512_init(&context_hamsi);
+            sph_hamsi512(&context_hamsi, in, 64);
+            sph_hamsi512_close(&context_hamsi, out);
+            break;
+        case 7:
+            sph_sha512_init(&context_sha2);
+            sph_sha512(&context_sha2, in, 64);
+            sph_sha512_close(&context_sha2, out);
+            break;
+        case 8:
+            sph_jh512_init(&context_jh);
+            sph_jh512(&context_jh, in, 64);
+            sph_jh512_close(&context_jh, out);
+            break;
+        case 9:
+            sph_keccak512_init(&context_keccak);
+            sph_keccak512(&context_keccak, in, 64);
+            sph_keccak512_close(&context_keccak, out);
+            break;
+        case 10:
+            sph_luffa512_init(&context_luffa);
+            sph_luffa512(&context_luffa, in, 64);
+            sph_luffa512_close(&context_luffa, out);
+            break;
+        case 11:
+            sph_shabal512_init(&context_shabal);
+            sph_shabal512(&context_shabal, in, 64);
+            sph_shabal512_close(&context_shabal, out);
+            break;
+        case 12:
+            if (Shavite512) {
+                Shavite512(in, out);
+                break;
+            }
+            sph_shavite512_init(&context_shavite);
+            sph_shavite512(&context_shavite, in, 64);
+            sph_shavite512_close(&context_shavite, out);
+            break;
+        case 13:
+            sph_simd512_init(&context_simd);
+            sph_simd512(&context_simd, in, 64);
+            sph_simd512_close(&context_simd, out);
+            break;
+        case 14:
+            sph_skein512_init(&context_skein);
+            sph_skein512(&context_skein, in, 64);
+            sph_skein512_close(&context_skein, out);
+            break;
+        case 15:
+            sph_whirlpool_init(&context_whirlpool);
+            sph_whirlpool(&context_whirlpool, in, 64);
+            sph_whirlpool_close(&context_whirlpool, out);
+            break;
+        default:
+            assert(false);
+            break;
+    }
+}
+
+void MinotaurHasher::Hash(const void *data, size_t len, unsigned char out[OUTPUT_SIZE]) {
+    // Find initial sha512 hash of the variable length data
+    unsigned char initial[64];
+    sph_sha512_init(&context_sha2);
+    sph_sha512(&context_sha2, data, len);
+    sph_sha512_close(&context_sha2, initial);
+
+    HashInitial(initial, out);
+}
+
+void MinotaurHasher::HashInitial(const unsigned char initial[64], unsigned char out[OUTPUT_SIZE]) {
+    // Send the initial hash through the torture garden. Algos are assigned to nodes based on the initial hash.
+    unsigned char hash[64];
+    memcpy(hash, initial, sizeof(hash));
+    unsigned int node = 0;
+    for (int depth = 0; depth < MINOTAUR_GARDEN_DEPTH; depth++) {
+        HashAlgo(initial[node] % MINOTAUR_ALGO_COUNT, hash, hash);
+
+#ifdef MINOTAUR_DEBUG
+        printf("* Ran algo %d. Partial hash:\t", initial[node] % MINOTAUR_ALGO_COUNT);
+        for (int i = 63; i >= 0; i--)
+            printf("%02x", hash[i]);
+        printf("\n");
+        fflush(0);
+#endif
+
+        if (node == MINOTAUR_GARDEN_NODES - 1)
+            break;
+        node = gardenChildren[node][hash[63] & 1];      // Last byte of output hash even: go left, odd: go right
+    }
+
+    // Return truncated result
+    memcpy(out, hash, OUTPUT_SIZE);
+}
+
+void MinotaurBatch::Hash(const unsigned char* const data[], size_t len, unsigned int count, unsigned char* out) {
+    assert(count <= MAX_LANES);
+
+    // Find initial sha512 hash of each lane's data
+    unsigned char initial[MAX_LANES][64];
+    unsigned char hash[MAX_LANES][64];
+    unsigned int node[MAX_LANES];
+    for (unsigned int lane = 0; lane < count; lane++) {
+        sph_sha512_init(&context_sha2);
+        sph_sha512(&context_sha2, data[lane], len);
+        sph_sha512_close(&context_sha2, initial[lane]);
+        memcpy(hash[lane], initial[lane], 64);
+        node[lane] = 0;
+    }
+
+    // Every path through the garden has the same length, so lanes stay in step; at each depth, group lanes by algo
+    for (int depth = 0; depth < MINOTAUR_GARDEN_DEPTH; depth++) {
+        unsigned int group[MINOTAUR_ALGO_COUNT][MAX_LANES];
+        unsigned int groupSize[MINOTAUR_ALGO_COUNT] = {};
+        for (unsigned int lane = 0; lane < count; lane++) {
+            unsigned int algo = initial[lane][node[lane]] % MINOTAUR_ALGO_COUNT;
+            group[algo][groupSize[algo]++] = lane;
+        }
+
+        for (unsigned int algo = 0; algo < MINOTAUR_ALGO_COUNT; algo++) {
+            unsigned int i = 0;
+            if (algo4Way[algo]) {
+                // Hash 4 lanes at a time while at least 2 remain; spare lanes are filled with (ignored) copies of the first
+                unsigned char buf[256];
+                while (groupSize[algo] - i >= 2) {
+                    unsigned int n = std::min(4u, groupSize[algo] - i);
+                    for (unsigned int j = 0; j < 4; j++)
+                        memcpy(buf + j * 64, hash[group[algo][i + (j < n ? j : 0)]], 64);
+                    algo4Way[algo](buf, buf);
+                    for (unsigned int j = 0; j < n; j++)
+                        memcpy(hash[group[algo][i + j]], buf + j * 64, 64);
+                    i += n;
+                }
+            }
+            for (; i < groupSize[algo]; i++)
+                hasher.HashAlgo(algo, hash[group[algo][i]], hash[group[algo][i]]);
+        }
+
+        for (unsigned int lane = 0; lane < count; lane++)
+            if (node[lane] != MINOTAUR_GARDEN_NODES - 1)
+                node[lane] = gardenChildren[node[lane]][hash[lane][63] & 1];
+    }
+
+    // Return truncated results
+    for (unsigned int lane = 0; lane < count; lane++)
+        memcpy(out + lane * MinotaurHasher::OUTPUT_SIZE, hash[lane], MinotaurHasher::OUTPUT_SIZE);
+}
+
+MinotaurHasher& GetThreadMinotaurHasher() {
+    static thread_local MinotaurHasher hasher;
+    return hasher;
+}
+
+std::string MinotaurAutoDetect()
+{
+    std::string ret = "standard";
+#if defined(USE_ASM) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
+#if defined(ENABLE_AESNI) && !defined(BUILD_RING_INTERNAL)
+    {
+        uint32_t eax, ebx, ecx, edx;
+        cpuid(1, 0, eax, ebx, ecx, edx);
+        bool have_ssse3 = (ecx >> 9) & 1;
+        bool have_aesni = (ecx >> 25) & 1;
+        if (have_ssse3 && have_aesni) {
+            Echo512 = minotaur_aesni::Echo512;
+            Fugue512 = minotaur_aesni::Fugue512;
+            Groestl512 = minotaur_aesni::Groestl512;
+            Shavite512 = minotaur_aesni::Shavite512;
+            ret = "aesni(echo,fugue,groestl,shavite)";
+        }
+    }
+#endif
+
+#if defined(ENABLE_AVX2) && !defined(BUILD_RING_INTERNAL)
+    {
+        uint32_t eax, ebx, ecx, edx;
+        cpuid(0, 0, eax, ebx, ecx, edx);
+        uint32_t max_leaf = eax;
+        cpuid(1, 0, eax, ebx, ecx, edx);
+        bool have_xsave = (ecx >> 27) & 1;
+        bool have_avx = (ecx >> 28) & 1;
+        bool enabled_avx = have_xsave && have_avx && AVXEnabled();
+        bool have_avx2 = false;
+        if (max_leaf >= 7) {
+            cpuid(7, 0, eax, ebx, ecx, edx);
+            have_avx2 = (ebx >> 5) & 1;
+        }
+        if (have_avx2 && enabled_avx) {
+            Cubehash512 = minotaur_avx2::Cubehash512;
+            algo4Way[0] = minotaur_avx2::Blake512_4way;
+            algo4Way[9] = minotaur_avx2::Keccak512_4way;
+            algo4Way[14] = minotaur_avx2::Skein512_4way;
+            ret = (ret == "standard" ? "" : ret + ",") + "avx2(cubehash,4way blake,keccak,skein)";
+        }
+    }
+#endif
+#endif
+
+    assert(SelfTest());
+    return ret;
+}
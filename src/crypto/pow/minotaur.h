@@ -9,6 +9,8 @@
 
 #include <uint256.h>
 
+#include <string>
+
 #include "sph_blake.h"
 #include "sph_bmw.h"
 #include "sph_cubehash.h"
@@ -36,13 +38,27 @@ extern "C" {
 #define MINOTAUR_LYRA_ROWS	16	// Lyra2's memory usage = MINOTAUR_LYRA_ROWS * 256 * 768 bits.
 //#define MINOTAUR_DEBUG
 
-// Graph of hash algos plus SPH contexts
-struct TortureNode {
-    unsigned int algo;
-    TortureNode *childLeft;
-    TortureNode *childRight;
-};
-struct TortureGarden {
+// Number of nodes in the torture garden. Every path through the garden visits MINOTAUR_GARDEN_DEPTH of them.
+#define MINOTAUR_GARDEN_NODES 22
+#define MINOTAUR_GARDEN_DEPTH 7
+
+// Reusable Minotaur hasher. Holds the SPH contexts for all algos so that hashing doesn't rebuild the garden each time.
+// Not thread-safe; each thread should use its own instance (see GetThreadMinotaurHasher()).
+class MinotaurHasher {
+public:
+    static const size_t OUTPUT_SIZE = 32;
+
+    // Produce a Minotaur 32-byte hash from len bytes at data, written to out
+    void Hash(const void *data, size_t len, unsigned char out[OUTPUT_SIZE]);
+
+    // Produce a Minotaur 32-byte hash given the initial sha512 hash of the data, written to out. For callers that keep
+    // their own sha512 state, such as a midstate over a prefix shared by many inputs.
+    void HashInitial(const unsigned char initial[64], unsigned char out[OUTPUT_SIZE]);
+
+    // Get a 64-byte hash for given 64-byte input using given algo index. in and out may be the same buffer.
+    void HashAlgo(unsigned int algo, const unsigned char in[64], unsigned char out[64]);
+
+private:
     sph_blake512_context context_blake;
     sph_bmw512_context context_bmw;
     sph_cubehash512_context context_cubehash;
@@ -59,173 +75,39 @@ struct TortureGarden {
     sph_skein512_context context_skein;
     sph_whirlpool_context context_whirlpool;
     sph_sha512_context context_sha2;
-
-    TortureNode nodes[22];
 };
 
-// Get a 64-byte hash for given 64-byte input, using given TortureGarden contexts and given algo index
-uint512 GetHash(uint512 inputHash, TortureGarden *garden, unsigned int algo) {
-    uint512 outputHash;
-    switch (algo) {
-        case 0:
-            sph_blake512_init(&garden->context_blake);
-            sph_blake512(&garden->context_blake, static_cast<const void*>(&inputHash), 64);
-            sph_blake512_close(&garden->context_blake, static_cast<void*>(&outputHash));
-            break;
-        case 1:
-            sph_bmw512_init(&garden->context_bmw);
-            sph_bmw512(&garden->context_bmw, static_cast<const void*>(&inputHash), 64);
-            sph_bmw512_close(&garden->context_bmw, static_cast<void*>(&outputHash));        
-            break;
-        case 2:
-            sph_cubehash512_init(&garden->context_cubehash);
-            sph_cubehash512(&garden->context_cubehash, static_cast<const void*>(&inputHash), 64);
-            sph_cubehash512_close(&garden->context_cubehash, static_cast<void*>(&outputHash));
-            break;
-        case 3:
-            sph_echo512_init(&garden->context_echo);
-            sph_echo512(&garden->context_echo, static_cast<const void*>(&inputHash), 64);
-            sph_echo512_close(&garden->context_echo, static_cast<void*>(&outputHash));
-            break;
-        case 4:
-            sph_fugue512_init(&garden->context_fugue);
-            sph_fugue512(&garden->context_fugue, static_cast<const void*>(&inputHash), 64);
-            sph_fugue512_close(&garden->context_fugue, static_cast<void*>(&outputHash));
-            break;
-        case 5:
-            sph_groestl512_init(&garden->context_groestl);
-            sph_groestl512(&garden->context_groestl, static_cast<const void*>(&inputHash), 64);
-            sph_groestl512_close(&garden->context_groestl, static_cast<void*>(&outputHash));
-            break;
-        case 6:
-            sph_hamsi512_init(&garden->context_hamsi);
-            sph_hamsi512(&garden->context_hamsi, static_cast<const void*>(&inputHash), 64);
-            sph_hamsi512_close(&garden->context_hamsi, static_cast<void*>(&outputHash));
-            break;
-        case 7:
-            sph_sha512_init(&garden->context_sha2);
-            sph_sha512(&garden->context_sha2, static_cast<const void*>(&inputHash), 64);
-            sph_sha512_close(&garden->context_sha2, static_cast<void*>(&outputHash));
-            break;
-        case 8:
-            sph_jh512_init(&garden->context_jh);
-            sph_jh512(&garden->context_jh, static_cast<const void*>(&inputHash), 64);
-            sph_jh512_close(&garden->context_jh, static_cast<void*>(&outputHash));
-            break;
-        case 9:
-            sph_keccak512_init(&garden->context_keccak);
-            sph_keccak512(&garden->context_keccak, static_cast<const void*>(&inputHash), 64);
-            sph_keccak512_close(&garden->context_keccak, static_cast<void*>(&outputHash));
-            break;
-        case 10:
-            sph_luffa512_init(&garden->context_luffa);
-            sph_luffa512(&garden->context_luffa, static_cast<const void*>(&inputHash), 64);
-            sph_luffa512_close(&garden->context_luffa, static_cast<void*>(&outputHash));
-            break;
-        case 11:
-            sph_shabal512_init(&garden->context_shabal);
-            sph_shabal512(&garden->context_shabal, static_cast<const void*>(&inputHash), 64);
-            sph_shabal512_close(&garden->context_shabal, static_cast<void*>(&outputHash));
-            break;
-        case 12:
-            sph_shavite512_init(&garden->context_shavite);
-            sph_shavite512(&garden->context_shavite, static_cast<const void*>(&inputHash), 64);
-            sph_shavite512_close(&garden->context_shavite, static_cast<void*>(&outputHash));
-            break;
-        case 13:
-            sph_simd512_init(&garden->context_simd);
-            sph_simd512(&garden->context_simd, static_cast<const void*>(&inputHash), 64);
-            sph_simd512_close(&garden->context_simd, static_cast<void*>(&outputHash));
-            break;
-        case 14:
-            sph_skein512_init(&garden->context_skein);
-            sph_skein512(&garden->context_skein, static_cast<const void*>(&inputHash), 64);
-            sph_skein512_close(&garden->context_skein, static_cast<void*>(&outputHash));
-            break;
-        case 15:
-            sph_whirlpool_init(&garden->context_whirlpool);
-            sph_whirlpool(&garden->context_whirlpool, static_cast<const void*>(&inputHash), 64);
-            sph_whirlpool_close(&garden->context_whirlpool, static_cast<void*>(&outputHash));
-            break;
-        default:
-            assert(false);
-            break;
-    }
-
-    return outputHash;
-}
+// Hashes several equal-length inputs at once, such as a run of nonces for one block header.
+// Lanes take different paths through the garden, so at each depth they're grouped by the algo they need next;
+// groups are hashed 4 lanes at a time where a multi-lane implementation of that algo is available (see MinotaurAutoDetect()).
+// Not thread-safe; each thread should use its own instance.
+class MinotaurBatch {
+public:
+    static const unsigned int MAX_LANES = 32;
 
-// Recursively traverse a given torture garden starting with a given hash and given node within the garden. The hash is overwritten with the final hash.
-uint512 TraverseGarden(TortureGarden *garden, uint512 hash, TortureNode *node) {
-    uint512 partialHash = GetHash(hash, garden, node->algo);
+    // Produce the Minotaur hashes of count inputs (at most MAX_LANES) of len bytes each, at data[0] .. data[count - 1].
+    // out receives count 32-byte hashes, back to back.
+    void Hash(const unsigned char* const data[], size_t len, unsigned int count, unsigned char* out);
 
-#ifdef MINOTAUR_DEBUG
-    printf("* Ran algo %d. Partial hash:\t%s\n", node->algo, partialHash.ToString().c_str());
-    fflush(0);
-#endif
-
-    if (partialHash.ByteAt(63) % 2 == 0) {      // Last byte of output hash is even
-        if (node->childLeft != NULL)
-            return TraverseGarden(garden, partialHash, node->childLeft);
-    } else {                                    // Last byte of output hash is odd
-        if (node->childRight != NULL)
-            return TraverseGarden(garden, partialHash, node->childRight);
-    }
+private:
+    MinotaurHasher hasher;
+    sph_sha512_context context_sha2;
+};
 
-    return partialHash;
-}
+/** Autodetect the best available implementations of Minotaur's algos.
+ *  Returns the name of the implementation.
+ */
+std::string MinotaurAutoDetect();
 
-// Associate child nodes with a parent node
-void LinkNodes(TortureNode *parent, TortureNode *childLeft, TortureNode *childRight) {
-    parent->childLeft = childLeft;
-    parent->childRight = childRight;
-}
+// Get the calling thread's MinotaurHasher
+MinotaurHasher& GetThreadMinotaurHasher();
 
 // Produce a Minotaur 32-byte hash from variable length data
 template<typename T> uint256 Minotaur(const T begin, const T end) {
-    // Create torture garden nodes. Note that both sides of 19 and 20 lead to 21, and 21 has no children (to make traversal complete).
-    // Every path through the garden stops at 7 nodes.
-    TortureGarden garden;
-    LinkNodes(&garden.nodes[0], &garden.nodes[1], &garden.nodes[2]);
-    LinkNodes(&garden.nodes[1], &garden.nodes[3], &garden.nodes[4]);
-    LinkNodes(&garden.nodes[2], &garden.nodes[5], &garden.nodes[6]);
-    LinkNodes(&garden.nodes[3], &garden.nodes[7], &garden.nodes[8]);
-    LinkNodes(&garden.nodes[4], &garden.nodes[9], &garden.nodes[10]);
-    LinkNodes(&garden.nodes[5], &garden.nodes[11], &garden.nodes[12]);
-    LinkNodes(&garden.nodes[6], &garden.nodes[13], &garden.nodes[14]);
-    LinkNodes(&garden.nodes[7], &garden.nodes[15], &garden.nodes[16]);
-    LinkNodes(&garden.nodes[8], &garden.nodes[15], &garden.nodes[16]);
-    LinkNodes(&garden.nodes[9], &garden.nodes[15], &garden.nodes[16]);
-    LinkNodes(&garden.nodes[10], &garden.nodes[15], &garden.nodes[16]);
-    LinkNodes(&garden.nodes[11], &garden.nodes[17], &garden.nodes[18]);
-    LinkNodes(&garden.nodes[12], &garden.nodes[17], &garden.nodes[18]);
-    LinkNodes(&garden.nodes[13], &garden.nodes[17], &garden.nodes[18]);
-    LinkNodes(&garden.nodes[14], &garden.nodes[17], &garden.nodes[18]);
-    LinkNodes(&garden.nodes[15], &garden.nodes[19], &garden.nodes[20]);
-    LinkNodes(&garden.nodes[16], &garden.nodes[19], &garden.nodes[20]);
-    LinkNodes(&garden.nodes[17], &garden.nodes[19], &garden.nodes[20]);
-    LinkNodes(&garden.nodes[18], &garden.nodes[19], &garden.nodes[20]);
-    LinkNodes(&garden.nodes[19], &garden.nodes[21], &garden.nodes[21]);
-    LinkNodes(&garden.nodes[20], &garden.nodes[21], &garden.nodes[21]);
-    garden.nodes[21].childLeft = NULL;
-    garden.nodes[21].childRight = NULL;
-        
-    // Find initial sha512 hash of the variable length data
-    uint512 hash;
     static unsigned char empty[1];
-    sph_sha512_init(&garden.context_sha2);
-    sph_sha512(&garden.context_sha2, (begin == end ? empty : static_cast<const void*>(&begin[0])), (end - begin) * sizeof(begin[0]));
-    sph_sha512_close(&garden.context_sha2, static_cast<void*>(&hash));
-
-    // Assign algos to torture net nodes based on initial hash
-    for (int i = 0; i < 22; i++)
-        garden.nodes[i].algo = hash.ByteAt(i) % MINOTAUR_ALGO_COUNT;
-
-    // Send the initial hash through the torture garden
-    hash = TraverseGarden(&garden, hash, &garden.nodes[0]);
-
-    // Return truncated result
-    return uint256(hash);
+    uint256 hash;
+    GetThreadMinotaurHasher().Hash((begin == end ? empty : static_cast<const void*>(&begin[0])), (end - begin) * sizeof(begin[0]), hash.begin());
+    return hash;
 }
 
 #endif // RING_CRYPTO_POW_MINOTAUR_H
@@ -0,0 +1,496 @@
+// Copyright (c) 2019 The Ring Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Ring-fork: Minotaur: AES-NI implementations of the AES-based algos, specialised for Minotaur's 64-byte inputs.
+// Each function gives the same output as the corresponding SPH 512-bit hash run over a single 64-byte input.
+
+#ifdef ENABLE_AESNI
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+#include <immintrin.h>
+
+namespace minotaur_aesni {
+namespace {
+
+const __m128i ZERO = _mm_setzero_si128();
+
+// Multiply each byte by 2 in GF(2^8) (AES polynomial)
+inline __attribute__((always_inline)) __m128i XTime(__m128i x)
+{
+    return _mm_xor_si128(_mm_add_epi8(x, x), _mm_and_si128(_mm_cmplt_epi8(x, ZERO), _mm_set1_epi8(0x1b)));
+}
+
+////// ECHO-512
+
+inline __attribute__((always_inline)) void EchoMixColumn(__m128i* W, int ia, int ib, int ic, int id)
+{
+    __m128i a = W[ia], b = W[ib], c = W[ic], d = W[id];
+    __m128i ab = _mm_xor_si128(a, b);
+    __m128i bc = _mm_xor_si128(b, c);
+    __m128i cd = _mm_xor_si128(c, d);
+    __m128i abx = XTime(ab);
+    __m128i bcx = XTime(bc);
+    __m128i cdx = XTime(cd);
+    W[ia] = _mm_xor_si128(abx, _mm_xor_si128(bc, d));
+    W[ib] = _mm_xor_si128(bcx, _mm_xor_si128(a, cd));
+    W[ic] = _mm_xor_si128(cdx, _mm_xor_si128(ab, d));
+    W[id] = _mm_xor_si128(_mm_xor_si128(abx, bcx), _mm_xor_si128(cdx, _mm_xor_si128(ab, c)));
+}
+
+////// SHAvite-512
+
+const uint32_t SHAVITE_IV512[16] = {
+    0x72FCCDD8, 0x79CA4727, 0x128A077B, 0x40D55AEC,
+    0xD1901A06, 0x430AE307, 0xB29F5CD1, 0xDF07FBFC,
+    0x8E45D73D, 0x681AB538, 0xBDE86578, 0xDD577E47,
+    0xE275EADE, 0x502D9FCD, 0xB9357178, 0x022A4B9A
+};
+
+// Message expansion step with the AES round: rk[u..u+3] = AES(rk[u-31], rk[u-30], rk[u-29], rk[u-32]) ^ rk[u-4..u-1]
+inline __attribute__((always_inline)) __m128i ShaviteExpandAES(const __m128i* k, int j)
+{
+    return _mm_xor_si128(_mm_aesenc_si128(_mm_shuffle_epi32(k[j - 8], 0x39), ZERO), k[j - 1]);
+}
+
+// Message expansion step without the AES round: rk[u..u+3] = rk[u-32..u-29] ^ rk[u-7..u-4]
+inline __attribute__((always_inline)) __m128i ShaviteExpandLinear(const __m128i* k, int j)
+{
+    return _mm_xor_si128(k[j - 8], _mm_alignr_epi8(k[j - 1], k[j - 2], 4));
+}
+
+////// Groestl-512
+
+// Shuffles that, applied before AESENCLAST, cancel its ShiftRows and rotate the row left by Groestl's ShiftBytes amount
+const __m128i GROESTL_SHIFT_P[8] = {
+    _mm_set_epi64x(0x0306090c0f020508ULL, 0x0b0e0104070a0d00ULL),   // 0
+    _mm_set_epi64x(0x04070a0d00030609ULL, 0x0c0f0205080b0e01ULL),   // 1
+    _mm_set_epi64x(0x05080b0e0104070aULL, 0x0d000306090c0f02ULL),   // 2
+    _mm_set_epi64x(0x06090c0f0205080bULL, 0x0e0104070a0d0003ULL),   // 3
+    _mm_set_epi64x(0x070a0d000306090cULL, 0x0f0205080b0e0104ULL),   // 4
+    _mm_set_epi64x(0x080b0e0104070a0dULL, 0x000306090c0f0205ULL),   // 5
+    _mm_set_epi64x(0x090c0f0205080b0eULL, 0x0104070a0d000306ULL),   // 6
+    _mm_set_epi64x(0x0e0104070a0d0003ULL, 0x06090c0f0205080bULL)    // 11
+};
+const __m128i GROESTL_SHIFT_Q[8] = {
+    _mm_set_epi64x(0x04070a0d00030609ULL, 0x0c0f0205080b0e01ULL),   // 1
+    _mm_set_epi64x(0x06090c0f0205080bULL, 0x0e0104070a0d0003ULL),   // 3
+    _mm_set_epi64x(0x080b0e0104070a0dULL, 0x000306090c0f0205ULL),   // 5
+    _mm_set_epi64x(0x0e0104070a0d0003ULL, 0x06090c0f0205080bULL),   // 11
+    _mm_set_epi64x(0x0306090c0f020508ULL, 0x0b0e0104070a0d00ULL),   // 0
+    _mm_set_epi64x(0x05080b0e0104070aULL, 0x0d000306090c0f02ULL),   // 2
+    _mm_set_epi64x(0x070a0d000306090cULL, 0x0f0205080b0e0104ULL),   // 4
+    _mm_set_epi64x(0x090c0f0205080b0eULL, 0x0104070a0d000306ULL)    // 6
+};
+
+// Column index in the high nibble of each byte, as used by the round constants
+const __m128i GROESTL_COLUMNS = _mm_set_epi64x(0xf0e0d0c0b0a09080ULL, 0x7060504030201000ULL);
+
+// SubBytes, ShiftBytes and MixBytes on a row-major state (each register holds one row of 16 bytes)
+inline __attribute__((always_inline)) void GroestlRoundTail(__m128i* R, const __m128i* shift)
+{
+    __m128i A[8], X2[8], X4[8];
+    for (int i = 0; i < 8; i++) {
+        A[i] = _mm_aesenclast_si128(_mm_shuffle_epi8(R[i], shift[i]), ZERO);
+        X2[i] = XTime(A[i]);
+        X4[i] = XTime(X2[i]);
+    }
+    // MixBytes: circulant matrix (02, 02, 03, 04, 05, 03, 05, 07)
+    for (int i = 0; i < 8; i++) {
+        const int i1 = (i + 1) & 7, i2 = (i + 2) & 7, i3 = (i + 3) & 7, i4 = (i + 4) & 7, i5 = (i + 5) & 7, i6 = (i + 6) & 7, i7 = (i + 7) & 7;
+        __m128i t = _mm_xor_si128(X2[i], X2[i1]);
+        t = _mm_xor_si128(t, _mm_xor_si128(X2[i2], A[i2]));
+        t = _mm_xor_si128(t, X4[i3]);
+        t = _mm_xor_si128(t, _mm_xor_si128(X4[i4], A[i4]));
+        t = _mm_xor_si128(t, _mm_xor_si128(X2[i5], A[i5]));
+        t = _mm_xor_si128(t, _mm_xor_si128(X4[i6], A[i6]));
+        t = _mm_xor_si128(t, _mm_xor_si128(_mm_xor_si128(X4[i7], X2[i7]), A[i7]));
+        R[i] = t;
+    }
+}
+
+void GroestlP(__m128i* R)
+{
+    for (int r = 0; r < 14; r++) {
+        R[0] = _mm_xor_si128(R[0], _mm_xor_si128(GROESTL_COLUMNS, _mm_set1_epi8(r)));
+        GroestlRoundTail(R, GROESTL_SHIFT_P);
+    }
+}
+
+void GroestlQ(__m128i* R)
+{
+    const __m128i ones = _mm_set1_epi8((char)0xff);
+    for (int r = 0; r < 14; r++) {
+        for (int i = 0; i < 7; i++)
+            R[i] = _mm_xor_si128(R[i], ones);
+        R[7] = _mm_xor_si128(R[7], _mm_xor_si128(ones, _mm_xor_si128(GROESTL_COLUMNS, _mm_set1_epi8(r))));
+        GroestlRoundTail(R, GROESTL_SHIFT_Q);
+    }
+}
+
+// Convert between the column-major byte order of a Groestl block and row-major registers
+void GroestlToRows(__m128i* R, const unsigned char* block)
+{
+    alignas(16) unsigned char rows[8][16];
+    for (int j = 0; j < 16; j++)
+        for (int i = 0; i < 8; i++)
+            rows[i][j] = block[8 * j + i];
+    for (int i = 0; i < 8; i++)
+        R[i] = _mm_load_si128((const __m128i*)rows[i]);
+}
+
+void GroestlFromRows(unsigned char* block, const __m128i* R)
+{
+    alignas(16) unsigned char rows[8][16];
+    for (int i = 0; i < 8; i++)
+        _mm_store_si128((__m128i*)rows[i], R[i]);
+    for (int j = 0; j < 16; j++)
+        for (int i = 0; i < 8; i++)
+            block[8 * j + i] = rows[i][j];
+}
+
+////// Fugue-512
+
+const uint32_t FUGUE_IV512[16] = {
+    0x8807a57e, 0xe616af75, 0xc5d3e4db, 0xac9ab027,
+    0xd915f117, 0xb6eecc54, 0x06e8020b, 0x4a92efd1,
+    0xaac6e2c9, 0xddb21398, 0xcae65838, 0x437f203f,
+    0x25ea78e7, 0x951fddd6, 0xda6ed11d, 0xe13e3567
+};
+
+// The state's 32-bit words are kept in byte order (as they'd be serialised big-endian), so 4 consecutive words
+// loaded into a register hold row r of column c at byte 4c + r, as AES does.
+// Shuffles on such a register: undo and apply AES's ShiftRows; move each column's rows up by 1, 2 or 3; spread
+// byte (i, i) across row i.
+const __m128i FUGUE_INV_SHIFT = _mm_set_epi64x(0x0306090c0f020508ULL, 0x0b0e0104070a0d00ULL);
+const __m128i FUGUE_SHIFT = _mm_set_epi64x(0x0b06010c07020d08ULL, 0x030e09040f0a0500ULL);
+const __m128i FUGUE_ROW1 = _mm_set_epi64x(0x0c0f0e0d080b0a09ULL, 0x0407060500030201ULL);
+const __m128i FUGUE_ROW2 = _mm_set_epi64x(0x0d0c0f0e09080b0aULL, 0x0504070601000302ULL);
+const __m128i FUGUE_ROW3 = _mm_set_epi64x(0x0e0d0c0f0a09080bULL, 0x0605040702010003ULL);
+const __m128i FUGUE_DIAG = _mm_set_epi64x(0x0f0a05000f0a0500ULL, 0x0f0a05000f0a0500ULL);
+
+// Multiplication by 4 and 7 in GF(2^8), by low and high nibble
+const __m128i FUGUE_MUL4_LO = _mm_set_epi64x(0x3c3834302c282420ULL, 0x1c1814100c080400ULL);
+const __m128i FUGUE_MUL4_HI = _mm_set_epi64x(0xedad6d2df6b67636ULL, 0xdb9b5b1bc0804000ULL);
+const __m128i FUGUE_MUL7_LO = _mm_set_epi64x(0x2d2a232431363f38ULL, 0x15121b1c090e0700ULL);
+const __m128i FUGUE_MUL7_HI = _mm_set_epi64x(0xe69606763d4dddadULL, 0x4b3babdb90e07000ULL);
+const __m128i NIBBLE = _mm_set1_epi8(0x0f);
+
+// Columns (words) 0 - 2, 0 - 1, 2 and 3
+const __m128i FUGUE_COLS012 = _mm_set_epi32(0, -1, -1, -1);
+const __m128i FUGUE_COLS01 = _mm_set_epi32(0, 0, -1, -1);
+const __m128i FUGUE_COL2 = _mm_set_epi32(0, -1, 0, 0);
+const __m128i FUGUE_COL3 = _mm_set_epi32(-1, 0, 0, 0);
+
+// SMIX on 4 state words: SubBytes, then the super-mix. With T the substituted state and M = circ(1, 4, 7, 1), output
+// row i, column j is (M.T)[i][(i + j) % 4] ^ M[(i + j) % 4][i] . (T[i][0] ^ .. ^ T[i][3] ^ T[i][i]). The first term is
+// the column mix with rows shifted as by AES's ShiftRows; the second's coefficient comes to 1, 1, 7, 4 for columns 0 - 3.
+inline __attribute__((always_inline)) __m128i FugueSmix(__m128i x)
+{
+    __m128i t = _mm_aesenclast_si128(_mm_shuffle_epi8(x, FUGUE_INV_SHIFT), ZERO);
+
+    __m128i lo = _mm_and_si128(t, NIBBLE);
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(t, 4), NIBBLE);
+    __m128i t4 = _mm_xor_si128(_mm_shuffle_epi8(FUGUE_MUL4_LO, lo), _mm_shuffle_epi8(FUGUE_MUL4_HI, hi));
+    __m128i t7 = _mm_xor_si128(_mm_shuffle_epi8(FUGUE_MUL7_LO, lo), _mm_shuffle_epi8(FUGUE_MUL7_HI, hi));
+    __m128i mixed = _mm_xor_si128(_mm_xor_si128(t, _mm_shuffle_epi8(t, FUGUE_ROW3)),
+                                  _mm_xor_si128(_mm_shuffle_epi8(t7, FUGUE_ROW2), _mm_shuffle_epi8(t4, FUGUE_ROW1)));
+
+    __m128i d = _mm_xor_si128(_mm_xor_si128(t, _mm_shuffle_epi32(t, 0x39)), _mm_xor_si128(_mm_shuffle_epi32(t, 0x4e), _mm_shuffle_epi32(t, 0x93)));
+    d = _mm_xor_si128(d, _mm_shuffle_epi8(t, FUGUE_DIAG));
+    lo = _mm_and_si128(d, NIBBLE);
+    hi = _mm_and_si128(_mm_srli_epi16(d, 4), NIBBLE);
+    __m128i d4 = _mm_xor_si128(_mm_shuffle_epi8(FUGUE_MUL4_LO, lo), _mm_shuffle_epi8(FUGUE_MUL4_HI, hi));
+    __m128i d7 = _mm_xor_si128(_mm_shuffle_epi8(FUGUE_MUL7_LO, lo), _mm_shuffle_epi8(FUGUE_MUL7_HI, hi));
+    __m128i rows = _mm_xor_si128(_mm_and_si128(d, FUGUE_COLS01), _mm_xor_si128(_mm_and_si128(d7, FUGUE_COL2), _mm_and_si128(d4, FUGUE_COL3)));
+
+    return _mm_xor_si128(_mm_shuffle_epi8(mixed, FUGUE_SHIFT), rows);
+}
+
+// The 36-word state, rotated by moving its logical start instead of the words. The 4 words SMIX works on (the window)
+// are carried from one step to the next in a register, and are only stale in memory meanwhile; everything else is
+// read and written in memory off the SMIX dependency chain.
+class FugueState
+{
+public:
+    void Init()
+    {
+        memset(S, 0, 20 * sizeof(uint32_t));
+        for (int i = 0; i < 16; i++)
+            WriteBE32(S + 20 + i, FUGUE_IV512[i]);
+        base = 0;
+        window = Load(0);
+    }
+
+    // Absorb one input word, as 4 bytes: TIX4 on the window and memory, then 4 subrounds
+    void Round(const unsigned char* q)
+    {
+        uint32_t word, old = _mm_cvtsi128_si32(window);
+        memcpy(&word, q, 4);
+        Word(22) ^= old;
+        Word(8) ^= word;
+        Word(4) ^= Word(27);
+        Word(7) ^= Word(30);
+        window = _mm_or_si128(_mm_and_si128(window, _mm_set_epi32(-1, -1, -1, 0)), _mm_cvtsi32_si128(word));
+        window = _mm_xor_si128(window, _mm_set_epi32(0, 0, Word(24), 0));
+        for (int i = 0; i < 4; i++)
+            Subround();
+    }
+
+    // Ror by 3, CMIX36 and SMIX. The new window's words 0 - 2 and 18 - 20 take words 4 - 6, the old window's words 1 - 3.
+    void Subround()
+    {
+        int next = Wrap(base - 3);
+        __m128i rotated = _mm_shuffle_epi32(window, 0x39);
+        __m128i x = _mm_xor_si128(_mm_and_si128(Load(next), FUGUE_COLS012), rotated);
+        Store(base, window);
+        int p = Wrap(next + 18);
+        Store(p, _mm_xor_si128(Load(p), _mm_and_si128(rotated, FUGUE_COLS012)));
+        base = next;
+        window = FugueSmix(x);
+    }
+
+    // Final stage step: xor word 0 into words 4, a, b and c, Ror by n and SMIX. Word c becomes the new window's word 0.
+    void FinalStep(int a, int b, int c, int n)
+    {
+        assert(c + n == 36);
+        uint32_t s0 = _mm_cvtsi128_si32(window);
+        Word(4) ^= s0;
+        Word(a) ^= s0;
+        Word(b) ^= s0;
+        Store(base, window);
+        base = Wrap(base - n);
+        window = FugueSmix(_mm_xor_si128(Load(base), _mm_cvtsi32_si128(s0)));
+    }
+
+    // Final xor of word 0, and the output words
+    void Output(unsigned char out[64])
+    {
+        uint32_t s0 = _mm_cvtsi128_si32(window);
+        Store(base, window);
+        Word(4) ^= s0;
+        Word(9) ^= s0;
+        Word(18) ^= s0;
+        Word(27) ^= s0;
+        static const int outWords[16] = {1, 2, 3, 4, 9, 10, 11, 12, 18, 19, 20, 21, 27, 28, 29, 30};
+        for (int i = 0; i < 16; i++)
+            memcpy(out + 4 * i, &Word(outWords[i]), 4);
+    }
+
+private:
+    uint32_t S[40];         // 36 words, with room for 4-word stores to run past the end
+    int base;               // Where word 0 is
+    __m128i window;         // Words 0 - 3
+
+    static int Wrap(int p) { return p < 0 ? p + 36 : (p >= 36 ? p - 36 : p); }
+
+    uint32_t& Word(int i) { return S[Wrap(base + i)]; }
+
+    __m128i Load(int p)
+    {
+        if (p <= 32)
+            return _mm_loadu_si128((const __m128i*)(S + p));
+        return _mm_set_epi32(S[Wrap(p + 3)], S[Wrap(p + 2)], S[Wrap(p + 1)], S[p]);
+    }
+
+    void Store(int p, __m128i x)
+    {
+        _mm_storeu_si128((__m128i*)(S + p), x);
+        for (int i = 36; i < p + 4; i++)
+            S[i - 36] = S[i];
+    }
+
+    static void WriteBE32(uint32_t* p, uint32_t x)
+    {
+        unsigned char* b = (unsigned char*)p;
+        b[0] = x >> 24;
+        b[1] = x >> 16;
+        b[2] = x >> 8;
+        b[3] = x;
+    }
+};
+
+} // namespace
+
+void Echo512(const unsigned char in[64], unsigned char out[64])
+{
+    // Chaining value is 8 words of (512, 0); the single padded message block holds the input, the padding bit,
+    // the 16-bit output size at byte 110 and the 128-bit bit counter (512) at byte 112
+    alignas(16) unsigned char block[64] = {0x80};
+    block[46] = 0x00;
+    block[47] = 0x02;
+    block[48] = 0x00;
+    block[49] = 0x02;
+
+    __m128i V[8], M[8], W[16];
+    for (int i = 0; i < 8; i++)
+        V[i] = _mm_set_epi64x(0, 512);
+    for (int i = 0; i < 4; i++)
+        M[i] = _mm_loadu_si128((const __m128i*)(in + 16 * i));
+    for (int i = 0; i < 4; i++)
+        M[i + 4] = _mm_load_si128((const __m128i*)(block + 16 * i));
+    for (int i = 0; i < 8; i++) {
+        W[i] = V[i];
+        W[i + 8] = M[i];
+    }
+
+    // The counter only ever reaches 512 + 160 here, so it can be incremented in its low word only
+    __m128i K = _mm_set_epi32(0, 0, 0, 512);
+    const __m128i one = _mm_set_epi32(0, 0, 0, 1);
+    for (int r = 0; r < 10; r++) {
+        // BIG.SubWords
+        for (int n = 0; n < 16; n++) {
+            W[n] = _mm_aesenc_si128(_mm_aesenc_si128(W[n], K), ZERO);
+            K = _mm_add_epi32(K, one);
+        }
+
+        // BIG.ShiftRows
+        __m128i t = W[1];
+        W[1] = W[5]; W[5] = W[9]; W[9] = W[13]; W[13] = t;
+        t = W[2]; W[2] = W[10]; W[10] = t;
+        t = W[6]; W[6] = W[14]; W[14] = t;
+        t = W[15];
+        W[15] = W[11]; W[11] = W[7]; W[7] = W[3]; W[3] = t;
+
+        // BIG.MixColumns
+        EchoMixColumn(W, 0, 1, 2, 3);
+        EchoMixColumn(W, 4, 5, 6, 7);
+        EchoMixColumn(W, 8, 9, 10, 11);
+        EchoMixColumn(W, 12, 13, 14, 15);
+    }
+
+    // BIG.Final; only the first 4 words of the chaining value make up the output
+    for (int i = 0; i < 4; i++)
+        _mm_storeu_si128((__m128i*)(out + 16 * i), _mm_xor_si128(_mm_xor_si128(V[i], M[i]), _mm_xor_si128(W[i], W[i + 8])));
+}
+
+void Shavite512(const unsigned char in[64], unsigned char out[64])
+{
+    // Single padded message block: input, padding bit, 128-bit bit counter (512) at byte 110 and the 16-bit output size (512) at byte 126
+    alignas(16) unsigned char block[64] = {0x80};
+    block[46] = 0x00;
+    block[47] = 0x02;
+    block[63] = 0x02;
+
+    // Message expansion
+    __m128i k[112];
+    for (int i = 0; i < 4; i++)
+        k[i] = _mm_loadu_si128((const __m128i*)(in + 16 * i));
+    for (int i = 0; i < 4; i++)
+        k[i + 4] = _mm_load_si128((const __m128i*)(block + 16 * i));
+
+    const uint32_t count0 = 512, count1 = 0, count2 = 0, count3 = 0;
+    int j = 8;
+    while (true) {
+        for (int s = 0; s < 4; s++) {
+            k[j] = ShaviteExpandAES(k, j);
+            if (j == 8)
+                k[j] = _mm_xor_si128(k[j], _mm_set_epi32(~count3, count2, count1, count0));
+            else if (j == 110)
+                k[j] = _mm_xor_si128(k[j], _mm_set_epi32(~count2, count3, count0, count1));
+            j++;
+
+            k[j] = ShaviteExpandAES(k, j);
+            if (j == 41)
+                k[j] = _mm_xor_si128(k[j], _mm_set_epi32(~count0, count1, count2, count3));
+            else if (j == 79)
+                k[j] = _mm_xor_si128(k[j], _mm_set_epi32(~count1, count0, count3, count2));
+            j++;
+        }
+        if (j == 112)
+            break;
+        for (int s = 0; s < 8; s++) {
+            k[j] = ShaviteExpandLinear(k, j);
+            j++;
+        }
+    }
+
+    // 14 rounds of the Feistel-like construction over 4 128-bit words
+    __m128i H[4], P[4];
+    for (int i = 0; i < 4; i++)
+        P[i] = H[i] = _mm_loadu_si128((const __m128i*)(SHAVITE_IV512 + 4 * i));
+    j = 0;
+    for (int r = 0; r < 14; r++) {
+        __m128i x = _mm_aesenc_si128(_mm_xor_si128(P[1], k[j]), k[j + 1]);
+        x = _mm_aesenc_si128(x, k[j + 2]);
+        x = _mm_aesenc_si128(x, k[j + 3]);
+        P[0] = _mm_xor_si128(P[0], _mm_aesenc_si128(x, ZERO));
+        j += 4;
+
+        x = _mm_aesenc_si128(_mm_xor_si128(P[3], k[j]), k[j + 1]);
+        x = _mm_aesenc_si128(x, k[j + 2]);
+        x = _mm_aesenc_si128(x, k[j + 3]);
+        P[2] = _mm_xor_si128(P[2], _mm_aesenc_si128(x, ZERO));
+        j += 4;
+
+        __m128i t = P[3];
+        P[3] = P[2]; P[2] = P[1]; P[1] = P[0]; P[0] = t;
+    }
+
+    for (int i = 0; i < 4; i++)
+        _mm_storeu_si128((__m128i*)(out + 16 * i), _mm_xor_si128(H[i], P[i]));
+}
+
+void Groestl512(const unsigned char in[64], unsigned char out[64])
+{
+    // Single padded message block: input, padding bit and the 64-bit big-endian block count (1)
+    unsigned char block[128] = {0};
+    memcpy(block, in, 64);
+    block[64] = 0x80;
+    block[127] = 0x01;
+
+    // IV is the output size (512) big-endian in the last bytes of an otherwise zero state
+    unsigned char iv[128] = {0};
+    iv[126] = 0x02;
+
+    __m128i H[8], M[8], P[8];
+    GroestlToRows(H, iv);
+    GroestlToRows(M, block);
+
+    // Compression: H = P(H ^ M) ^ Q(M) ^ H
+    for (int i = 0; i < 8; i++)
+        P[i] = _mm_xor_si128(H[i], M[i]);
+    GroestlP(P);
+    GroestlQ(M);
+    for (int i = 0; i < 8; i++)
+        H[i] = _mm_xor_si128(H[i], _mm_xor_si128(P[i], M[i]));
+
+    // Output transformation: trunc(P(H) ^ H)
+    for (int i = 0; i < 8; i++)
+        P[i] = H[i];
+    GroestlP(P);
+    for (int i = 0; i < 8; i++)
+        H[i] = _mm_xor_si128(H[i], P[i]);
+    GroestlFromRows(block, H);
+    memcpy(out, block + 64, 64);
+}
+
+void Fugue512(const unsigned char in[64], unsigned char out[64])
+{
+    FugueState state;
+    state.Init();
+
+    // The input words, then the 64-bit big-endian bit count (512)
+    static const unsigned char count[8] = {0, 0, 0, 0, 0, 0, 0x02, 0};
+    for (int i = 0; i < 16; i++)
+        state.Round(in + 4 * i);
+    state.Round(count);
+    state.Round(count + 4);
+
+    // Final stage: 32 subrounds, then 13 rounds of 4 steps
+    for (int i = 0; i < 32; i++)
+        state.Subround();
+    for (int i = 0; i < 13; i++) {
+        state.FinalStep(9, 18, 27, 9);
+        state.FinalStep(10, 18, 27, 9);
+        state.FinalStep(10, 19, 27, 9);
+        state.FinalStep(10, 19, 28, 8);
+    }
+    state.Output(out);
+}
+
+} // namespace minotaur_aesni
+
+#endif
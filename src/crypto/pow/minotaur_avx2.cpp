@@ -0,0 +1,417 @@
+// Copyright (c) 2019 The Ring Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Ring-fork: Minotaur: AVX2 implementations of some of Minotaur's algos, specialised for its 64-byte inputs.
+// The _4way functions hash 4 independent 64-byte inputs (laid out back to back) for MinotaurBatch; each gives the
+// same output as the corresponding SPH 512-bit hash run over each input in turn. CubeHash's state is wide enough to
+// vectorise a single input instead.
+
+#ifdef ENABLE_AVX2
+
+#include <stdint.h>
+#include <immintrin.h>
+
+namespace minotaur_avx2 {
+namespace {
+
+__m256i inline K(uint64_t x) { return _mm256_set1_epi64x(x); }
+
+__m256i inline Add(__m256i x, __m256i y) { return _mm256_add_epi64(x, y); }
+__m256i inline Add(__m256i x, __m256i y, __m256i z) { return Add(Add(x, y), z); }
+__m256i inline Xor(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+__m256i inline Xor(__m256i x, __m256i y, __m256i z) { return Xor(Xor(x, y), z); }
+__m256i inline AndNot(__m256i x, __m256i y) { return _mm256_andnot_si256(x, y); }
+__m256i inline RotL(__m256i x, int n) { return _mm256_or_si256(_mm256_slli_epi64(x, n), _mm256_srli_epi64(x, 64 - n)); }
+__m256i inline RotR(__m256i x, int n) { return _mm256_or_si256(_mm256_srli_epi64(x, n), _mm256_slli_epi64(x, 64 - n)); }
+__m256i inline RotR32(__m256i x) { return _mm256_shuffle_epi32(x, 0xb1); }
+__m256i inline RotR16(__m256i x) { return _mm256_shuffle_epi8(x, _mm256_setr_epi8(2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9, 2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9)); }
+__m256i inline ByteSwap(__m256i x) { return _mm256_shuffle_epi8(x, _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8)); }
+
+// Transpose four rows of four 64-bit words, converting between "4 consecutive words of each lane" and "1 word of all 4 lanes"
+void inline Transpose(__m256i& a, __m256i& b, __m256i& c, __m256i& d)
+{
+    __m256i t0 = _mm256_unpacklo_epi64(a, b);
+    __m256i t1 = _mm256_unpackhi_epi64(a, b);
+    __m256i t2 = _mm256_unpacklo_epi64(c, d);
+    __m256i t3 = _mm256_unpackhi_epi64(c, d);
+    a = _mm256_permute2x128_si256(t0, t2, 0x20);
+    b = _mm256_permute2x128_si256(t1, t3, 0x20);
+    c = _mm256_permute2x128_si256(t0, t2, 0x31);
+    d = _mm256_permute2x128_si256(t1, t3, 0x31);
+}
+
+// Load the 8 64-bit little-endian words of each of 4 consecutive 64-byte inputs, as 8 vectors of 4 lanes
+void inline Load(__m256i* w, const unsigned char* in)
+{
+    for (int half = 0; half < 8; half += 4) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(in + 0 * 64 + half * 8));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(in + 1 * 64 + half * 8));
+        __m256i c = _mm256_loadu_si256((const __m256i*)(in + 2 * 64 + half * 8));
+        __m256i d = _mm256_loadu_si256((const __m256i*)(in + 3 * 64 + half * 8));
+        Transpose(a, b, c, d);
+        w[half + 0] = a;
+        w[half + 1] = b;
+        w[half + 2] = c;
+        w[half + 3] = d;
+    }
+}
+
+// Inverse of Load()
+void inline Store(unsigned char* out, const __m256i* w)
+{
+    for (int half = 0; half < 8; half += 4) {
+        __m256i a = w[half + 0], b = w[half + 1], c = w[half + 2], d = w[half + 3];
+        Transpose(a, b, c, d);
+        _mm256_storeu_si256((__m256i*)(out + 0 * 64 + half * 8), a);
+        _mm256_storeu_si256((__m256i*)(out + 1 * 64 + half * 8), b);
+        _mm256_storeu_si256((__m256i*)(out + 2 * 64 + half * 8), c);
+        _mm256_storeu_si256((__m256i*)(out + 3 * 64 + half * 8), d);
+    }
+}
+
+////// BLAKE-512
+
+const uint64_t BLAKE_IV[8] = {
+    0x6A09E667F3BCC908ULL, 0xBB67AE8584CAA73BULL, 0x3C6EF372FE94F82BULL, 0xA54FF53A5F1D36F1ULL,
+    0x510E527FADE682D1ULL, 0x9B05688C2B3E6C1FULL, 0x1F83D9ABFB41BD6BULL, 0x5BE0CD19137E2179ULL
+};
+
+const uint64_t BLAKE_C[16] = {
+    0x243F6A8885A308D3ULL, 0x13198A2E03707344ULL, 0xA4093822299F31D0ULL, 0x082EFA98EC4E6C89ULL,
+    0x452821E638D01377ULL, 0xBE5466CF34E90C6CULL, 0xC0AC29B7C97C50DDULL, 0x3F84D5B5B5470917ULL,
+    0x9216D5D98979FB1BULL, 0xD1310BA698DFB5ACULL, 0x2FFD72DBD01ADFB7ULL, 0xB8E1AFED6A267E96ULL,
+    0xBA7C9045F12C7F99ULL, 0x24A19947B3916CF7ULL, 0x0801F2E2858EFC16ULL, 0x636920D871574E69ULL
+};
+
+const unsigned char BLAKE_SIGMA[10][16] = {
+    { 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15},
+    {14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3},
+    {11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4},
+    { 7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8},
+    { 9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13},
+    { 2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9},
+    {12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11},
+    {13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10},
+    { 6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5},
+    {10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0}
+};
+
+void inline BlakeG(const __m256i* m, const unsigned char* s, int i, __m256i& a, __m256i& b, __m256i& c, __m256i& d)
+{
+    a = Add(a, b, Xor(m[s[2 * i]], K(BLAKE_C[s[2 * i + 1]])));
+    d = RotR32(Xor(d, a));
+    c = Add(c, d);
+    b = RotR(Xor(b, c), 25);
+    a = Add(a, b, Xor(m[s[2 * i + 1]], K(BLAKE_C[s[2 * i]])));
+    d = RotR16(Xor(d, a));
+    c = Add(c, d);
+    b = RotR(Xor(b, c), 11);
+}
+
+////// Keccak-512
+
+const uint64_t KECCAK_RC[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808AULL, 0x8000000080008000ULL,
+    0x000000000000808BULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008AULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000AULL,
+    0x000000008000808BULL, 0x800000000000008BULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800AULL, 0x800000008000000AULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+void inline KeccakChi(__m256i* a, const __m256i* b)
+{
+    a[0] = Xor(b[0], AndNot(b[1], b[2]));
+    a[1] = Xor(b[1], AndNot(b[2], b[3]));
+    a[2] = Xor(b[2], AndNot(b[3], b[4]));
+    a[3] = Xor(b[3], AndNot(b[4], b[0]));
+    a[4] = Xor(b[4], AndNot(b[0], b[1]));
+}
+
+void KeccakF(__m256i* a)
+{
+    for (int round = 0; round < 24; round++) {
+        // Theta
+        __m256i c0 = Xor(Xor(a[0], a[5], a[10]), Xor(a[15], a[20]));
+        __m256i c1 = Xor(Xor(a[1], a[6], a[11]), Xor(a[16], a[21]));
+        __m256i c2 = Xor(Xor(a[2], a[7], a[12]), Xor(a[17], a[22]));
+        __m256i c3 = Xor(Xor(a[3], a[8], a[13]), Xor(a[18], a[23]));
+        __m256i c4 = Xor(Xor(a[4], a[9], a[14]), Xor(a[19], a[24]));
+        __m256i d0 = Xor(c4, RotL(c1, 1));
+        __m256i d1 = Xor(c0, RotL(c2, 1));
+        __m256i d2 = Xor(c1, RotL(c3, 1));
+        __m256i d3 = Xor(c2, RotL(c4, 1));
+        __m256i d4 = Xor(c3, RotL(c0, 1));
+
+        // Rho and pi, with theta's column parities applied on the way
+        __m256i b[25];
+        b[0] = Xor(a[0], d0);
+        b[1] = RotL(Xor(a[6], d1), 44);
+        b[2] = RotL(Xor(a[12], d2), 43);
+        b[3] = RotL(Xor(a[18], d3), 21);
+        b[4] = RotL(Xor(a[24], d4), 14);
+        b[5] = RotL(Xor(a[3], d3), 28);
+        b[6] = RotL(Xor(a[9], d4), 20);
+        b[7] = RotL(Xor(a[10], d0), 3);
+        b[8] = RotL(Xor(a[16], d1), 45);
+        b[9] = RotL(Xor(a[22], d2), 61);
+        b[10] = RotL(Xor(a[1], d1), 1);
+        b[11] = RotL(Xor(a[7], d2), 6);
+        b[12] = RotL(Xor(a[13], d3), 25);
+        b[13] = RotL(Xor(a[19], d4), 8);
+        b[14] = RotL(Xor(a[20], d0), 18);
+        b[15] = RotL(Xor(a[4], d4), 27);
+        b[16] = RotL(Xor(a[5], d0), 36);
+        b[17] = RotL(Xor(a[11], d1), 10);
+        b[18] = RotL(Xor(a[17], d2), 15);
+        b[19] = RotL(Xor(a[23], d3), 56);
+        b[20] = RotL(Xor(a[2], d2), 62);
+        b[21] = RotL(Xor(a[8], d3), 55);
+        b[22] = RotL(Xor(a[14], d4), 39);
+        b[23] = RotL(Xor(a[15], d0), 41);
+        b[24] = RotL(Xor(a[21], d1), 2);
+
+        // Chi
+        KeccakChi(a + 0, b + 0);
+        KeccakChi(a + 5, b + 5);
+        KeccakChi(a + 10, b + 10);
+        KeccakChi(a + 15, b + 15);
+        KeccakChi(a + 20, b + 20);
+
+        // Iota
+        a[0] = Xor(a[0], K(KECCAK_RC[round]));
+    }
+}
+
+////// Skein-512
+
+const uint64_t SKEIN_IV[8] = {
+    0x4903ADFF749C51CEULL, 0x0D95DE399746DF03ULL, 0x8FD1934127C79BCEULL, 0x9A255629FF352CB1ULL,
+    0x5DB62599DF6CA7B0ULL, 0xEABE394CA9D5C3F4ULL, 0x991112C71A75B523ULL, 0xAE18A40B660FCC33ULL
+};
+
+// Key injection S: add subkey S (built from the 9 key words, 3 tweak words and S) to the state
+template <int S>
+void inline SkeinInject(__m256i* p, const __m256i* k, const __m256i* t)
+{
+    p[0] = Add(p[0], k[(S + 0) % 9]);
+    p[1] = Add(p[1], k[(S + 1) % 9]);
+    p[2] = Add(p[2], k[(S + 2) % 9]);
+    p[3] = Add(p[3], k[(S + 3) % 9]);
+    p[4] = Add(p[4], k[(S + 4) % 9]);
+    p[5] = Add(p[5], k[(S + 5) % 9], t[S % 3]);
+    p[6] = Add(p[6], k[(S + 6) % 9], t[(S + 1) % 3]);
+    p[7] = Add(p[7], k[(S + 7) % 9], K(S));
+}
+
+void inline SkeinMix(__m256i& x0, __m256i& x1, int rc)
+{
+    x0 = Add(x0, x1);
+    x1 = Xor(RotL(x1, rc), x0);
+}
+
+// Eight Threefish-512 rounds, with key injections S and S + 1
+template <int S>
+void inline SkeinRounds(__m256i* p, const __m256i* k, const __m256i* t)
+{
+    SkeinInject<S>(p, k, t);
+    SkeinMix(p[0], p[1], 46); SkeinMix(p[2], p[3], 36); SkeinMix(p[4], p[5], 19); SkeinMix(p[6], p[7], 37);
+    SkeinMix(p[2], p[1], 33); SkeinMix(p[4], p[7], 27); SkeinMix(p[6], p[5], 14); SkeinMix(p[0], p[3], 42);
+    SkeinMix(p[4], p[1], 17); SkeinMix(p[6], p[3], 49); SkeinMix(p[0], p[5], 36); SkeinMix(p[2], p[7], 39);
+    SkeinMix(p[6], p[1], 44); SkeinMix(p[0], p[7],  9); SkeinMix(p[2], p[5], 54); SkeinMix(p[4], p[3], 56);
+    SkeinInject<S + 1>(p, k, t);
+    SkeinMix(p[0], p[1], 39); SkeinMix(p[2], p[3], 30); SkeinMix(p[4], p[5], 34); SkeinMix(p[6], p[7], 24);
+    SkeinMix(p[2], p[1], 13); SkeinMix(p[4], p[7], 50); SkeinMix(p[6], p[5], 10); SkeinMix(p[0], p[3], 17);
+    SkeinMix(p[4], p[1], 25); SkeinMix(p[6], p[3], 29); SkeinMix(p[0], p[5], 39); SkeinMix(p[2], p[7], 43);
+    SkeinMix(p[6], p[1],  8); SkeinMix(p[0], p[7], 35); SkeinMix(p[2], p[5], 56); SkeinMix(p[4], p[3], 22);
+}
+
+// One UBI block with a tweak that is the same for all lanes: h = Threefish(key = h, tweak = (t0, t1), m) ^ m
+void SkeinUBI(__m256i* h, const __m256i* m, uint64_t t0, uint64_t t1)
+{
+    __m256i k[9];
+    k[8] = K(0x1BD11BDAA9FC1A22ULL);
+    for (int i = 0; i < 8; i++) {
+        k[i] = h[i];
+        k[8] = Xor(k[8], h[i]);
+    }
+    const __m256i t[3] = {K(t0), K(t1), K(t0 ^ t1)};
+
+    __m256i p[8];
+    for (int i = 0; i < 8; i++)
+        p[i] = m[i];
+
+    SkeinRounds<0>(p, k, t);
+    SkeinRounds<2>(p, k, t);
+    SkeinRounds<4>(p, k, t);
+    SkeinRounds<6>(p, k, t);
+    SkeinRounds<8>(p, k, t);
+    SkeinRounds<10>(p, k, t);
+    SkeinRounds<12>(p, k, t);
+    SkeinRounds<14>(p, k, t);
+    SkeinRounds<16>(p, k, t);
+    SkeinInject<18>(p, k, t);
+
+    for (int i = 0; i < 8; i++)
+        h[i] = Xor(m[i], p[i]);
+}
+
+////// CubeHash-512
+
+const uint32_t CUBEHASH_IV[32] = {
+    0x2AEA2A61, 0x50F494D4, 0x2D538B8B, 0x4167D83E, 0x3FEE2313, 0xC701CF8C, 0xCC39968E, 0x50AC5695,
+    0x4D42C787, 0xA647A8B3, 0x97CF0BEF, 0x825B4537, 0xEEF864D2, 0xF22090C4, 0xD0E5CD33, 0xA23911AE,
+    0xFCD398D9, 0x148FE485, 0x1B017BEF, 0xB6444532, 0x6A536159, 0x2FF5781C, 0x91FA7934, 0x0DBADEA9,
+    0xD65C8A2B, 0xA5A70E75, 0xB1C62456, 0xBC796576, 0x1921C8F7, 0xE7989AF1, 0x7795D246, 0xD43E3B44
+};
+
+__m256i inline RotL32(__m256i x, int n) { return _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - n)); }
+
+// Two CubeHash rounds on the state x0-x7, x8-x15, x16-x23, x24-x31 held in a, b, c, d.
+// The swaps between x0-x7 and x8-x15 are done by exchanging the roles of a and b, so two rounds leave them in place.
+void inline CubehashTwoRounds(__m256i& a, __m256i& b, __m256i& c, __m256i& d)
+{
+    c = _mm256_add_epi32(c, a);
+    d = _mm256_add_epi32(d, b);
+    a = RotL32(a, 7);
+    b = RotL32(b, 7);
+    b = Xor(b, c);                                                  // b and a have swapped roles here
+    a = Xor(a, d);
+    c = _mm256_shuffle_epi32(c, 0x4e);
+    d = _mm256_shuffle_epi32(d, 0x4e);
+    c = _mm256_add_epi32(c, b);
+    d = _mm256_add_epi32(d, a);
+    b = RotL32(b, 11);
+    a = RotL32(a, 11);
+    b = _mm256_permute4x64_epi64(b, 0x4e);
+    a = _mm256_permute4x64_epi64(a, 0x4e);
+    b = Xor(b, c);
+    a = Xor(a, d);
+    c = _mm256_shuffle_epi32(c, 0xb1);
+    d = _mm256_shuffle_epi32(d, 0xb1);
+
+    c = _mm256_add_epi32(c, b);
+    d = _mm256_add_epi32(d, a);
+    b = RotL32(b, 7);
+    a = RotL32(a, 7);
+    a = Xor(a, c);                                                  // and back again
+    b = Xor(b, d);
+    c = _mm256_shuffle_epi32(c, 0x4e);
+    d = _mm256_shuffle_epi32(d, 0x4e);
+    c = _mm256_add_epi32(c, a);
+    d = _mm256_add_epi32(d, b);
+    a = RotL32(a, 11);
+    b = RotL32(b, 11);
+    a = _mm256_permute4x64_epi64(a, 0x4e);
+    b = _mm256_permute4x64_epi64(b, 0x4e);
+    a = Xor(a, c);
+    b = Xor(b, d);
+    c = _mm256_shuffle_epi32(c, 0xb1);
+    d = _mm256_shuffle_epi32(d, 0xb1);
+}
+
+void inline CubehashSixteenRounds(__m256i& a, __m256i& b, __m256i& c, __m256i& d)
+{
+    for (int i = 0; i < 8; i++)
+        CubehashTwoRounds(a, b, c, d);
+}
+
+} // namespace
+
+void Cubehash512(const unsigned char in[64], unsigned char out[64])
+{
+    __m256i a = _mm256_loadu_si256((const __m256i*)(CUBEHASH_IV + 0));
+    __m256i b = _mm256_loadu_si256((const __m256i*)(CUBEHASH_IV + 8));
+    __m256i c = _mm256_loadu_si256((const __m256i*)(CUBEHASH_IV + 16));
+    __m256i d = _mm256_loadu_si256((const __m256i*)(CUBEHASH_IV + 24));
+
+    // Two 32-byte message blocks, then the padding block (a single 0x80 byte)
+    a = Xor(a, _mm256_loadu_si256((const __m256i*)(in + 0)));
+    CubehashSixteenRounds(a, b, c, d);
+    a = Xor(a, _mm256_loadu_si256((const __m256i*)(in + 32)));
+    CubehashSixteenRounds(a, b, c, d);
+    a = Xor(a, _mm256_setr_epi32(0x80, 0, 0, 0, 0, 0, 0, 0));
+    CubehashSixteenRounds(a, b, c, d);
+
+    // Finalisation: flip the last state bit, then 10 x 16 rounds
+    d = Xor(d, _mm256_setr_epi32(0, 0, 0, 0, 0, 0, 0, 1));
+    for (int i = 0; i < 10; i++)
+        CubehashSixteenRounds(a, b, c, d);
+
+    _mm256_storeu_si256((__m256i*)(out + 0), a);
+    _mm256_storeu_si256((__m256i*)(out + 32), b);
+}
+
+void Blake512_4way(const unsigned char in[256], unsigned char out[256])
+{
+    // A 64-byte message fits in a single block: message, 0x80 padding byte, the final 0x01 bit and the 512-bit length
+    __m256i m[16];
+    Load(m, in);
+    for (int i = 0; i < 8; i++)
+        m[i] = ByteSwap(m[i]);
+    m[8] = K(0x8000000000000000ULL);
+    m[9] = m[10] = m[11] = m[12] = K(0);
+    m[13] = K(1);
+    m[14] = K(0);
+    m[15] = K(512);
+
+    __m256i v[16];
+    for (int i = 0; i < 8; i++)
+        v[i] = K(BLAKE_IV[i]);
+    for (int i = 0; i < 4; i++)
+        v[8 + i] = K(BLAKE_C[i]);
+    v[12] = K(512 ^ BLAKE_C[4]);
+    v[13] = K(512 ^ BLAKE_C[5]);
+    v[14] = K(BLAKE_C[6]);
+    v[15] = K(BLAKE_C[7]);
+
+    for (int r = 0; r < 16; r++) {
+        const unsigned char* s = BLAKE_SIGMA[r % 10];
+        BlakeG(m, s, 0, v[0], v[4], v[8], v[12]);
+        BlakeG(m, s, 1, v[1], v[5], v[9], v[13]);
+        BlakeG(m, s, 2, v[2], v[6], v[10], v[14]);
+        BlakeG(m, s, 3, v[3], v[7], v[11], v[15]);
+        BlakeG(m, s, 4, v[0], v[5], v[10], v[15]);
+        BlakeG(m, s, 5, v[1], v[6], v[11], v[12]);
+        BlakeG(m, s, 6, v[2], v[7], v[8], v[13]);
+        BlakeG(m, s, 7, v[3], v[4], v[9], v[14]);
+    }
+
+    __m256i h[8];
+    for (int i = 0; i < 8; i++)
+        h[i] = ByteSwap(Xor(K(BLAKE_IV[i]), v[i], v[i + 8]));
+    Store(out, h);
+}
+
+void Keccak512_4way(const unsigned char in[256], unsigned char out[256])
+{
+    // A 64-byte message fits in the 72-byte rate: message, then Keccak's 0x01 ... 0x80 padding in the ninth word
+    __m256i a[25];
+    Load(a, in);
+    a[8] = K(0x8000000000000001ULL);
+    for (int i = 9; i < 25; i++)
+        a[i] = K(0);
+
+    KeccakF(a);
+    Store(out, a);
+}
+
+void Skein512_4way(const unsigned char in[256], unsigned char out[256])
+{
+    // Message UBI: one first+final block of 64 bytes. Output UBI: one first+final block holding the counter 0 (8 bytes).
+    __m256i h[8], m[8];
+    for (int i = 0; i < 8; i++)
+        h[i] = K(SKEIN_IV[i]);
+    Load(m, in);
+    SkeinUBI(h, m, 64, 0xF000000000000000ULL);
+
+    for (int i = 0; i < 8; i++)
+        m[i] = K(0);
+    SkeinUBI(h, m, 8, 0xFF00000000000000ULL);
+    Store(out, h);
+}
+
+} // namespace minotaur_avx2
+
+#endif
@@ -0,0 +1,221 @@
+// Copyright (c) 2019 The Ring Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Ring-fork: Hive: Network hive population index
+
+#include <index/hiveindex.h>
+#include <chainparams.h>
+#include <pow.h>
+#include <util/system.h>
+#include <validation.h>
+
+constexpr char DB_HIVE_COUNTS = 'h';
+
+std::unique_ptr<HiveIndex> g_hiveindex;
+
+/** DCTs and dwarves created in one block */
+struct CHiveBlockCounts
+{
+    int nDCTs;
+    int nDwarves;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(VARINT(nDCTs, VarIntMode::NONNEGATIVE_SIGNED));
+        READWRITE(VARINT(nDwarves, VarIntMode::NONNEGATIVE_SIGNED));
+    }
+
+    CHiveBlockCounts() : nDCTs(0), nDwarves(0) {}
+    CHiveBlockCounts(int nDCTsIn, int nDwarvesIn) : nDCTs(nDCTsIn), nDwarves(nDwarvesIn) {}
+};
+
+/**
+ * Access to the hiveindex database (indexes/hiveindex/)
+ *
+ * Alongside the block locator kept by every index, the database stores the DCT and dwarf
+ * counts of each block by height. Records above the best block are left behind by reorgs
+ * and are overwritten as the index catches up again.
+ */
+class HiveIndex::DB : public BaseIndex::DB
+{
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /// Write the counts of the block at the given height.
+    bool WriteCounts(int nHeight, const CHiveBlockCounts& counts);
+
+    /// Read the counts of all heights up to and including nBestHeight. Returns false if any are missing.
+    bool ReadCounts(int nBestHeight, std::vector<CHiveBlockCounts>& vCounts);
+};
+
+HiveIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
+    BaseIndex::DB(GetDataDir() / "indexes" / "hiveindex", n_cache_size, f_memory, f_wipe)
+{}
+
+bool HiveIndex::DB::WriteCounts(int nHeight, const CHiveBlockCounts& counts)
+{
+    return Write(std::make_pair(DB_HIVE_COUNTS, nHeight), counts);
+}
+
+bool HiveIndex::DB::ReadCounts(int nBestHeight, std::vector<CHiveBlockCounts>& vCounts)
+{
+    vCounts.assign(nBestHeight + 1, CHiveBlockCounts());
+    int nFound = 0;
+
+    std::unique_ptr<CDBIterator> it(NewIterator());
+    for (it->Seek(DB_HIVE_COUNTS); it->Valid(); it->Next()) {
+        std::pair<char, int> key;
+        if (!it->GetKey(key) || key.first != DB_HIVE_COUNTS) break;
+        if (key.second < 0 || key.second > nBestHeight) continue;
+
+        if (!it->GetValue(vCounts[key.second])) {
+            return error("%s: cannot parse counts for height %d", __func__, key.second);
+        }
+        nFound++;
+    }
+
+    return nFound == nBestHeight + 1;
+}
+
+HiveIndex::HiveIndex(size_t n_cache_size, bool f_memory, bool f_wipe)
+    : m_db(MakeUnique<HiveIndex::DB>(n_cache_size, f_memory, f_wipe))
+{}
+
+HiveIndex::~HiveIndex() {}
+
+bool HiveIndex::Init()
+{
+    LOCK(cs_main);
+
+    if (!BaseIndex::Init()) {
+        return false;
+    }
+
+    CBlockLocator locator;
+    const CBlockIndex* pindex = m_db->ReadBestBlock(locator) ? FindForkInGlobalIndex(chainActive, locator) : nullptr;
+
+    // The blocks still to be indexed must be on disk; once built, the index doesn't need them
+    for (const CBlockIndex* pindexNext = pindex ? chainActive.Next(pindex) : chainActive.Genesis(); pindexNext; pindexNext = chainActive.Next(pindexNext)) {
+        if (IsBlockPruned(pindexNext)) {
+            return error("%s: block %s has been pruned; restart with -reindex to build the hive index",
+                         __func__, pindexNext->GetBlockHash().ToString());
+        }
+    }
+
+    std::vector<CHiveBlockCounts> vCounts;
+    if (pindex && !m_db->ReadCounts(pindex->nHeight, vCounts)) {
+        return error("%s: hive index database is missing block counts; restart with -reindex to rebuild it", __func__);
+    }
+
+    LOCK(m_mutex);
+    m_dct_totals.clear();
+    m_dwarf_totals.clear();
+    m_dct_totals.reserve(vCounts.size());
+    m_dwarf_totals.reserve(vCounts.size());
+    int64_t nDCTs = 0, nDwarves = 0;
+    for (const CHiveBlockCounts& counts : vCounts) {
+        m_dct_totals.push_back(nDCTs += counts.nDCTs);
+        m_dwarf_totals.push_back(nDwarves += counts.nDwarves);
+    }
+    m_best = pindex;
+
+    return true;
+}
+
+bool HiveIndex::WriteBlock(const CBlock& block, const CBlockIndex* pindex)
+{
+    CHiveBlockCounts counts;
+    CountBlockDwarves(block, pindex->nHeight, Params().GetConsensus(), counts.nDCTs, counts.nDwarves);
+    if (!m_db->WriteCounts(pindex->nHeight, counts)) {
+        return false;
+    }
+
+    LOCK(m_mutex);
+    const size_t nHeight = pindex->nHeight;
+    if (m_dct_totals.size() < nHeight) {
+        return error("%s: block %s at height %d is beyond the indexed chain (height %d)",
+                     __func__, pindex->GetBlockHash().ToString(), pindex->nHeight, (int)m_dct_totals.size() - 1);
+    }
+
+    // After a reorg the block replaces the totals from the old branch
+    m_dct_totals.resize(nHeight);
+    m_dwarf_totals.resize(nHeight);
+    m_dct_totals.push_back((nHeight > 0 ? m_dct_totals.back() : 0) + counts.nDCTs);
+    m_dwarf_totals.push_back((nHeight > 0 ? m_dwarf_totals.back() : 0) + counts.nDwarves);
+    m_best = pindex;
+
+    return true;
+}
+
+void HiveIndex::BlockDisconnected(const std::shared_ptr<const CBlock>& block)
+{
+    const CBlockIndex* pindex;
+    {
+        LOCK(cs_main);
+        pindex = LookupBlockIndex(block->GetHash());
+    }
+
+    LOCK(m_mutex);
+    if (pindex && pindex == m_best) {
+        m_dct_totals.resize(pindex->nHeight);
+        m_dwarf_totals.resize(pindex->nHeight);
+        m_best = pindex->pprev;
+    }
+}
+
+BaseIndex::DB& HiveIndex::GetDB() const { return *m_db; }
+
+void HiveIndex::SumCounts(int from, int to, int64_t& dcts, int64_t& dwarves) const
+{
+    from = std::max(from, 0);
+    to = std::min(to, (int)m_dct_totals.size() - 1);
+    if (from > to) {
+        dcts = dwarves = 0;
+        return;
+    }
+
+    dcts = m_dct_totals[to] - (from > 0 ? m_dct_totals[from - 1] : 0);
+    dwarves = m_dwarf_totals[to] - (from > 0 ? m_dwarf_totals[from - 1] : 0);
+}
+
+bool HiveIndex::GetNetworkHiveInfo(const CBlockIndex* pindexTip, const Consensus::Params& consensusParams,
+                                   int& immatureDwarves, int& immatureDCTs, int& matureDwarves, int& matureDCTs,
+                                   DwarfPopGraphPoint* graph) const
+{
+    const int gestation = consensusParams.dwarfGestationBlocks;
+    const int totalDwarfLifespan = consensusParams.dwarfLifespanBlocks + gestation;
+    const int tipHeight = pindexTip->nHeight;
+
+    // DCTs count from the last totalDwarfLifespan blocks, but never from before minHiveCheckBlock
+    const int firstHeight = std::max(tipHeight - totalDwarfLifespan + 1, consensusParams.minHiveCheckBlock);
+
+    LOCK(m_mutex);
+    if (m_best != pindexTip) {
+        return false;
+    }
+
+    int64_t dcts, dwarves;
+    SumCounts(std::max(tipHeight - gestation + 1, firstHeight), tipHeight, dcts, dwarves);
+    immatureDCTs = dcts;
+    immatureDwarves = dwarves;
+    SumCounts(firstHeight, tipHeight - gestation, dcts, dwarves);
+    matureDCTs = dcts;
+    matureDwarves = dwarves;
+
+    // At tipHeight + pos, dwarves from DCTs in the last gestation blocks are immature, and those from
+    // the lifespan blocks before them are mature
+    if (graph) {
+        for (int pos = 1; pos < totalDwarfLifespan; pos++) {
+            const int height = tipHeight + pos;
+            SumCounts(std::max(height - gestation + 1, firstHeight), std::min(height, tipHeight), dcts, dwarves);
+            graph[pos].immaturePop = dwarves;
+            SumCounts(std::max(height - totalDwarfLifespan + 1, firstHeight), std::min(height - gestation, tipHeight), dcts, dwarves);
+            graph[pos].maturePop = dwarves;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,82 @@
+// Copyright (c) 2019 The Ring Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Ring-fork: Hive: Network hive population index
+
+#ifndef RING_INDEX_HIVEINDEX_H
+#define RING_INDEX_HIVEINDEX_H
+
+#include <chain.h>
+#include <index/base.h>
+#include <sync.h>
+
+#include <vector>
+
+struct DwarfPopGraphPoint;
+
+namespace Consensus { struct Params; };
+
+/**
+ * HiveIndex keeps the number of DCTs and dwarves created at each height of the active
+ * chain, so the network hive population can be answered without reading blocks from disk.
+ * The per-height counts are written to a LevelDB database and held in memory as prefix sums,
+ * so any window of heights is summed in constant time. Once built the index needs no block
+ * data, so it keeps working on pruned nodes.
+ */
+class HiveIndex final : public BaseIndex
+{
+protected:
+    class DB;
+
+private:
+    const std::unique_ptr<DB> m_db;
+
+    mutable Mutex m_mutex;
+
+    /// Running totals of DCTs and dwarves created up to and including each height
+    std::vector<int64_t> m_dct_totals GUARDED_BY(m_mutex);
+    std::vector<int64_t> m_dwarf_totals GUARDED_BY(m_mutex);
+
+    /// The block the running totals end at
+    const CBlockIndex* m_best GUARDED_BY(m_mutex){nullptr};
+
+    /// Sum the counts over heights [from, to], clamped to the heights indexed.
+    void SumCounts(int from, int to, int64_t& dcts, int64_t& dwarves) const EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+
+protected:
+    /// Drop the disconnected block's counts, so a chain that shrinks without a reorg
+    /// (invalidateblock) isn't answered from stale totals.
+    void BlockDisconnected(const std::shared_ptr<const CBlock>& block) override;
+
+    /// Override base class init to load the running totals from the database.
+    bool Init() override;
+
+    bool WriteBlock(const CBlock& block, const CBlockIndex* pindex) override;
+
+    BaseIndex::DB& GetDB() const override;
+
+    const char* GetName() const override { return "hiveindex"; }
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit HiveIndex(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an incomplete type.
+    virtual ~HiveIndex() override;
+
+    /// Count the network's gestating and live dwarves as of the given tip, as GetNetworkHiveInfo does.
+    ///
+    /// @param[in]   pindexTip  The chain tip to answer for.
+    /// @param[out]  graph  If not null, filled with the population forecast for the next
+    ///              gestation + lifespan blocks.
+    /// @return  false if the index isn't in sync with pindexTip
+    bool GetNetworkHiveInfo(const CBlockIndex* pindexTip, const Consensus::Params& consensusParams,
+                            int& immatureDwarves, int& immatureDCTs, int& matureDwarves, int& matureDCTs,
+                            DwarfPopGraphPoint* graph = nullptr) const;
+};
+
+/// The global hive population index, used in GetNetworkHiveInfo. May be null.
+extern std::unique_ptr<HiveIndex> g_hiveindex;
+
+#endif // RING_INDEX_HIVEINDEX_H
@@ -18,11 +18,13 @@
 #include <checkpoints.h>
 #include <compat/sanity.h>
 #include <consensus/validation.h>
+#include <crypto/pow/minotaur.h>
 #include <fs.h>
 #include <httpserver.h>
 #include <httprpc.h>
 #include <interfaces/chain.h>
 #include <index/txindex.h>
+#include <index/hiveindex.h>    // Ring-fork: Hive
 #include <key.h>
 #include <validation.h>
 #include <miner.h>
@@ -40,6 +42,7 @@
 #include <script/sigcache.h>
 #include <scheduler.h>
 #include <shutdown.h>
+#include <stratum.h>
 #include <timedata.h>
 #include <txdb.h>
 #include <txmempool.h>
@@ -179,6 +182,7 @@ static CScheduler scheduler;
 void Interrupt()
 {
     InterruptHTTPServer();
+    InterruptStratumServer();   // Ring-fork: Stratum
     InterruptHTTPRPC();
     InterruptRPC();
     InterruptREST();
@@ -189,6 +193,9 @@ void Interrupt()
     if (g_txindex) {
         g_txindex->Interrupt();
     }
+    if (g_hiveindex) {          // Ring-fork: Hive
+        g_hiveindex->Interrupt();
+    }
 }
 
 void Shutdown(InitInterfaces& interfaces)
@@ -216,6 +223,7 @@ void Shutdown(InitInterfaces& interfaces)
     StopREST();
     StopRPC();
     StopHTTPServer();
+    StopStratumServer();        // Ring-fork: Stratum
     for (const auto& client : interfaces.chain_clients) {
         client->flush();
     }
@@ -226,6 +234,7 @@ void Shutdown(InitInterfaces& interfaces)
     if (peerLogic) UnregisterValidationInterface(peerLogic.get());
     if (g_connman) g_connman->Stop();
     if (g_txindex) g_txindex->Stop();
+    if (g_hiveindex) g_hiveindex->Stop();   // Ring-fork: Hive
 
     StopTorControl();
 
@@ -240,6 +249,7 @@ void Shutdown(InitInterfaces& interfaces)
     g_connman.reset();
     g_banman.reset();
     g_txindex.reset();
+    g_hiveindex.reset();        // Ring-fork: Hive
 
     if (g_is_mempool_loaded && gArgs.GetArg("-persistmempool", DEFAULT_PERSIST_MEMPOOL)) {
         DumpMempool();
@@ -409,6 +419,7 @@ void SetupServerArgs()
 #else
     hidden_args.emplace_back("-sysperms");
 #endif
+    gArgs.AddArg("-hiveindex", strprintf("Maintain an index of the network hive population, used by the getnetworkhiveinfo rpc call and the Hive tab. Works with -prune, but must be built while the blocks are still on disk (default: %u)", DEFAULT_HIVEINDEX), false, OptionsCategory::OPTIONS);   // Ring-fork: Hive
     gArgs.AddArg("-txindex", strprintf("Maintain a full transaction index, used by the getrawtransaction rpc call (default: %u)", DEFAULT_TXINDEX), false, OptionsCategory::OPTIONS);
 
     gArgs.AddArg("-addnode=<ip>", "Add a node to connect to and attempt to keep the connection open (see the `addnode` RPC command help for more info). This option can be specified multiple times to add multiple nodes.", false, OptionsCategory::CONNECTION);
@@ -489,6 +500,8 @@ void SetupServerArgs()
     gArgs.AddArg("-checkblockindex", strprintf("Do a full consistency check for mapBlockIndex, setBlockIndexCandidates, chainActive and mapBlocksUnlinked occasionally. (default: %u, regtest: %u)", defaultChainParams->DefaultConsistencyChecks(), regtestChainParams->DefaultConsistencyChecks()), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-checkmempool=<n>", strprintf("Run checks every <n> transactions (default: %u, regtest: %u)", defaultChainParams->DefaultConsistencyChecks(), regtestChainParams->DefaultConsistencyChecks()), true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-checkpoints", strprintf("Disable expensive verification for known chain history (default: %u)", DEFAULT_CHECKPOINTS_ENABLED), true, OptionsCategory::DEBUG_TEST);
+    gArgs.AddArg("-assumecheckpointedpow", strprintf("Skip the pow check of headers known to lead to a checkpoint during header sync (default: %u)", DEFAULT_ASSUME_CHECKPOINTED_POW), true, OptionsCategory::DEBUG_TEST);  // Ring-fork
+    gArgs.AddArg("-checkassumedpow", strprintf("Check the pow of headers accepted without a pow check in the background (default: %u)", DEFAULT_CHECK_ASSUMED_POW), true, OptionsCategory::DEBUG_TEST);                   // Ring-fork
     gArgs.AddArg("-deprecatedrpc=<method>", "Allows deprecated RPC method(s) to be used", true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-dropmessagestest=<n>", "Randomly drop 1 of every <n> network messages", true, OptionsCategory::DEBUG_TEST);
     gArgs.AddArg("-stopafterblockimport", strprintf("Stop running after importing blocks from disk (default: %u)", DEFAULT_STOPAFTERBLOCKIMPORT), true, OptionsCategory::DEBUG_TEST);
@@ -551,10 +564,26 @@ void SetupServerArgs()
     gArgs.AddArg("-gen", strprintf("Generate coins (default: %u)", DEFAULT_GENERATE), false, OptionsCategory::WALLET);
     gArgs.AddArg("-genproclimit=<n>", strprintf("Set the number of threads for coin generation if enabled (-1 = all cores, default: %d)", DEFAULT_GENERATE_THREADS), false, OptionsCategory::WALLET);
 
+    // Ring-fork: Stratum work server args
+    gArgs.AddArg("-stratum", strprintf("Serve work to external miners over stratum (default: %u)", DEFAULT_STRATUM), false, OptionsCategory::BLOCK_CREATION);
+    gArgs.AddArg("-stratumaddress=<addr>", "Address to pay the rewards of blocks mined through the stratum server to (required with -stratum)", false, OptionsCategory::BLOCK_CREATION);
+    gArgs.AddArg("-stratumbind=<addr>[:port]", "Bind the stratum server to given address. Use [host]:port notation for IPv6. This option can be specified multiple times (default: 127.0.0.1 and ::1)", false, OptionsCategory::BLOCK_CREATION);
+    gArgs.AddArg("-stratumport=<port>", strprintf("Listen for stratum connections on <port> (default: %u)", DEFAULT_STRATUM_PORT), false, OptionsCategory::BLOCK_CREATION);
+    gArgs.AddArg("-stratumdifficulty=<n>", strprintf("Share difficulty new stratum connections start at (default: %s)", std::to_string(DEFAULT_STRATUM_DIFFICULTY)), false, OptionsCategory::BLOCK_CREATION);
+    gArgs.AddArg("-stratumshareinterval=<n>", strprintf("Seconds between shares that stratum share difficulty is adjusted for (default: %u)", DEFAULT_STRATUM_SHARE_INTERVAL), false, OptionsCategory::BLOCK_CREATION);
+    gArgs.AddArg("-stratummaxconnections=<n>", strprintf("Maximum number of stratum connections (default: %u)", DEFAULT_STRATUM_MAX_CONNECTIONS), false, OptionsCategory::BLOCK_CREATION);
+
     // Ring-fork: Hive: Mining optimisations
-    gArgs.AddArg("-hivecheckdelay=<ms>", strprintf("Time between Hive checks in ms. This should be left at default unless performance degradation is observed (default: %u)", DEFAULT_HIVE_CHECK_DELAY), false, OptionsCategory::WALLET);
+    gArgs.AddArg("-hivecheckdelay=<ms>", strprintf("Deprecated and ignored; hive checks now start as soon as the tip changes (default: %u)", DEFAULT_HIVE_CHECK_DELAY), false, OptionsCategory::WALLET);
     gArgs.AddArg("-hivecheckthreads=<threads>", strprintf("Number of threads to use when checking bees, -1 for all available cores, or -2 for one less than all available cores (default: %u)", DEFAULT_HIVE_THREADS), false, OptionsCategory::WALLET);
     gArgs.AddArg("-hiveearlyabort", strprintf("Abort Hive checking as quickly as possible when a new block comes in. This should be left enabled unless performance degradation is observed. (default: %u)", DEFAULT_HIVE_EARLY_OUT), false, OptionsCategory::WALLET);
+    gArgs.AddArg("-hivespeculative", strprintf("Start Hive checking against a new block as soon as its header is accepted, before the block is downloaded and connected (default: %u)", DEFAULT_HIVE_SPECULATIVE), false, OptionsCategory::WALLET);
+
+    // Ring-fork: Pop: Headless solver
+    gArgs.AddArg("-popsolve", strprintf("Solve available pop games in the background and submit solutions that meet the score target (default: %u)", DEFAULT_POP_SOLVE), false, OptionsCategory::WALLET);
+    gArgs.AddArg("-popsolvebeam=<n>", strprintf("Beam width the pop solver starts each game with; it doubles on every unsuccessful pass (default: %u)", DEFAULT_POP_SOLVE_BEAM_WIDTH), false, OptionsCategory::WALLET);
+    gArgs.AddArg("-popsolvethreads=<threads>", strprintf("Number of threads to use when solving pop games, -1 for all available cores, or -2 for one less than all available cores (default: %u)", DEFAULT_POP_SOLVE_THREADS), false, OptionsCategory::WALLET);
+    gArgs.AddArg("-popsolvetime=<seconds>", strprintf("Maximum time the pop solver spends on a game (default: %u)", DEFAULT_POP_SOLVE_TIME), false, OptionsCategory::WALLET);
 
 #if HAVE_DECL_DAEMON
     gArgs.AddArg("-daemon", "Run in the background as a daemon and accept commands", false, OptionsCategory::OPTIONS);
@@ -1032,6 +1061,7 @@ bool AppInitParameterInteraction()
     }
     fCheckBlockIndex = gArgs.GetBoolArg("-checkblockindex", chainparams.DefaultConsistencyChecks());
     fCheckpointsEnabled = gArgs.GetBoolArg("-checkpoints", DEFAULT_CHECKPOINTS_ENABLED);
+    fAssumeCheckpointedPow = gArgs.GetBoolArg("-assumecheckpointedpow", DEFAULT_ASSUME_CHECKPOINTED_POW);  // Ring-fork
 
     hashAssumeValid = uint256S(gArgs.GetArg("-assumevalid", chainparams.GetConsensus().defaultAssumeValid.GetHex()));
     if (!hashAssumeValid.IsNull())
@@ -1210,6 +1240,9 @@ bool AppInitSanityChecks()
     // Initialize elliptic curve code
     std::string sha256_algo = SHA256AutoDetect();
     LogPrintf("Using the '%s' SHA256 implementation\n", sha256_algo);
+    // Ring-fork: Minotaur: Pick accelerated algo implementations
+    std::string minotaur_algo = MinotaurAutoDetect();
+    LogPrintf("Using the '%s' Minotaur implementation\n", minotaur_algo);
     RandomInit();
     ECC_Start();
     globalVerifyHandle.reset(new ECCVerifyHandle());
@@ -1291,6 +1324,12 @@ bool AppInitMain(InitInterfaces& interfaces)
     if (nScriptCheckThreads) {
         for (int i=0; i<nScriptCheckThreads-1; i++)
             threadGroup.create_thread(&ThreadScriptCheck);
+        // Ring-fork: Headers' pow hashes are computed on as many threads again
+        for (int i=0; i<nScriptCheckThreads-1; i++)
+            threadGroup.create_thread(&ThreadHeaderPowHash);
+        // Ring-fork: Hive and pop proofs of blocks loaded from file are checked on as many threads again
+        for (int i=0; i<nScriptCheckThreads-1; i++)
+            threadGroup.create_thread(&ThreadBlockProofCheck);
     }
 
     // Start the lightweight task scheduler thread
@@ -1464,6 +1503,8 @@ bool AppInitMain(InitInterfaces& interfaces)
     nTotalCache -= nBlockTreeDBCache;
     int64_t nTxIndexCache = std::min(nTotalCache / 8, gArgs.GetBoolArg("-txindex", DEFAULT_TXINDEX) ? nMaxTxIndexCache << 20 : 0);
     nTotalCache -= nTxIndexCache;
+    int64_t nHiveIndexCache = std::min(nTotalCache / 8, gArgs.GetBoolArg("-hiveindex", DEFAULT_HIVEINDEX) ? nMaxHiveIndexCache << 20 : 0);    // Ring-fork: Hive
+    nTotalCache -= nHiveIndexCache;
     int64_t nCoinDBCache = std::min(nTotalCache / 2, (nTotalCache / 4) + (1 << 23)); // use 25%-50% of the remainder for disk cache
     nCoinDBCache = std::min(nCoinDBCache, nMaxCoinsDBCache << 20); // cap total coins db cache
     nTotalCache -= nCoinDBCache;
@@ -1474,6 +1515,9 @@ bool AppInitMain(InitInterfaces& interfaces)
     if (gArgs.GetBoolArg("-txindex", DEFAULT_TXINDEX)) {
         LogPrintf("* Using %.1f MiB for transaction index database\n", nTxIndexCache * (1.0 / 1024 / 1024));
     }
+    if (gArgs.GetBoolArg("-hiveindex", DEFAULT_HIVEINDEX)) {     // Ring-fork: Hive
+        LogPrintf("* Using %.1f MiB for hive index database\n", nHiveIndexCache * (1.0 / 1024 / 1024));
+    }
     LogPrintf("* Using %.1f MiB for chain state database\n", nCoinDBCache * (1.0 / 1024 / 1024));
     LogPrintf("* Using %.1f MiB for in-memory UTXO set (plus up to %.1f MiB of unused mempool space)\n", nCoinCacheUsage * (1.0 / 1024 / 1024), nMempoolSizeMax * (1.0 / 1024 / 1024));
 
@@ -1648,6 +1692,9 @@ bool AppInitMain(InitInterfaces& interfaces)
         return false;
     }
 
+    // Ring-fork: Backfill pow hashes that older block index entries are missing, outside cs_main
+    StoreMissingPowHashes(chainparams);
+
     fs::path est_path = GetDataDir() / FEE_ESTIMATES_FILENAME;
     CAutoFile est_filein(fsbridge::fopen(est_path, "rb"), SER_DISK, CLIENT_VERSION);
     // Allowed to fail as this file IS missing on first startup.
@@ -1660,6 +1707,10 @@ bool AppInitMain(InitInterfaces& interfaces)
         g_txindex = MakeUnique<TxIndex>(nTxIndexCache, false, fReindex);
         g_txindex->Start();
     }
+    if (gArgs.GetBoolArg("-hiveindex", DEFAULT_HIVEINDEX)) {     // Ring-fork: Hive
+        g_hiveindex = MakeUnique<HiveIndex>(nHiveIndexCache, false, fReindex);
+        g_hiveindex->Start();
+    }
 
     // ********************************************************* Step 9: load wallet
     for (const auto& client : interfaces.chain_clients) {
@@ -1815,6 +1866,17 @@ bool AppInitMain(InitInterfaces& interfaces)
         return false;
     }
 
+    // Ring-fork: Check the pow of headers accepted without it in the background, if requested
+    if (gArgs.GetBoolArg("-checkassumedpow", DEFAULT_CHECK_ASSUMED_POW))
+        threadGroup.create_thread(std::bind(&ThreadCheckAssumedPow, std::cref(chainparams)));
+
+    // Ring-fork: Start the stratum work server if requested in args
+    if (gArgs.GetBoolArg("-stratum", DEFAULT_STRATUM)) {
+        if (!InitStratumServer())
+            return InitError(_("Unable to start stratum server. See debug log for details."));
+        StartStratumServer();
+    }
+
     // Ring-fork: In-wallet miner: Start mining if requested in args
     MineCoins(gArgs.GetBoolArg("-gen", DEFAULT_GENERATE), gArgs.GetArg("-genproclimit", DEFAULT_GENERATE_THREADS), chainparams);
 
@@ -1823,6 +1885,10 @@ bool AppInitMain(InitInterfaces& interfaces)
     // Ring-fork: Hive: Start the mining thread
 #ifdef ENABLE_WALLET
     threadGroup.create_thread(boost::bind(&DwarfMaster, boost::cref(chainparams)));
+
+    // Ring-fork: Pop: Start the headless solver if requested
+    if (gArgs.GetBoolArg("-popsolve", DEFAULT_POP_SOLVE))
+        threadGroup.create_thread(boost::bind(&PopSolver, boost::cref(chainparams)));
 #endif
 
     SetRPCWarmupFinished();
@@ -127,6 +127,7 @@ const CLogCategoryDesc LogCategories[] =
     {BCLog::LEVELDB, "leveldb"},
     {BCLog::HIVE, "hive"},  // Ring-fork: Hive
     {BCLog::POP, "pop"},    // Ring-fork: Pop
+    {BCLog::STRATUM, "stratum"},    // Ring-fork: Stratum
     {BCLog::ALL, "1"},
     {BCLog::ALL, "all"},
 };
@@ -55,6 +55,7 @@ namespace BCLog {
         LEVELDB     = (1 << 20),
         HIVE        = (1 << 21),    // Ring-fork: Hive logging
         POP         = (1 << 22),    // Ring-fork: Pop logging
+        STRATUM     = (1 << 23),    // Ring-fork: Stratum work server logging
         ALL         = ~(uint32_t)0,
     };
 
@@ -22,6 +22,7 @@
 #include <primitives/transaction.h>
 #include <script/standard.h>
 #include <timedata.h>
+#include <util/memory.h>
 #include <util/moneystr.h>
 #include <util/system.h>
 #include <validationinterface.h>
@@ -32,14 +33,13 @@
 #include <sync.h>                   // Ring-fork: Hive
 #include <key_io.h>                 // Ring-fork: Hive
 #include <boost/thread.hpp>         // Ring-fork: Hive: Mining optimisations
-
-static CCriticalSection cs_solution_vars;
-std::atomic<bool> solutionFound;    // Ring-fork: Hive: Mining optimisations: Thread-safe atomic flag to signal solution found (saves a slow mutex)
-std::atomic<bool> earlyAbort;       // Ring-fork: Hive: Mining optimisations: Thread-safe atomic flag to signal early abort needed
-CDwarfRange solvingRange;           // Ring-fork: Hive: Mining optimisations: The solving range (protected by mutex)
-uint32_t solvingDwarf;              // Ring-fork: Hive: Mining optimisations: The solving dwarf (protected by mutex)
+#include <crypto/pow/minotaur.h>    // Ring-fork: Hive: Mining optimisations
+#include <crypto/pop/game0/game0solver.h> // Ring-fork: Pop: Headless solver
+#include <shutdown.h>               // Ring-fork: Pop: Headless solver
 
 #include <algorithm>
+#include <deque>
+#include <map>
 #include <queue>
 #include <utility>
 #include <boost/thread/thread.hpp>  // Ring-fork: In-wallet miner
@@ -525,6 +525,17 @@ void BlockAssembler::addPackageTxs(int &nPackagesSelected, int &nDescendantsUpda
     }
 }
 
+// Ring-fork: In-wallet miner: Set the coinbase extranonce and update the merkle root to match
+static void SetExtraNonce(CBlock* pblock, int nHeight, unsigned int nExtraNonce)
+{
+    CMutableTransaction txCoinbase(*pblock->vtx[0]);
+    txCoinbase.vin[0].scriptSig = (CScript() << nHeight << CScriptNum(nExtraNonce)) + COINBASE_FLAGS;  // Height first in coinbase required for block.version=2
+    assert(txCoinbase.vin[0].scriptSig.size() <= 100);
+
+    pblock->vtx[0] = MakeTransactionRef(std::move(txCoinbase));
+    pblock->hashMerkleRoot = BlockMerkleRoot(*pblock);
+}
+
 void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned int& nExtraNonce)
 {
     // Update nExtraNonce
@@ -535,48 +546,241 @@ void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned
         hashPrevBlock = pblock->hashPrevBlock;
     }
     ++nExtraNonce;
-    unsigned int nHeight = pindexPrev->nHeight+1; // Height first in coinbase required for block.version=2
-    CMutableTransaction txCoinbase(*pblock->vtx[0]);
-    txCoinbase.vin[0].scriptSig = (CScript() << nHeight << CScriptNum(nExtraNonce)) + COINBASE_FLAGS;
-    assert(txCoinbase.vin[0].scriptSig.size() <= 100);
+    SetExtraNonce(pblock, pindexPrev->nHeight + 1, nExtraNonce);
+}
 
-    pblock->vtx[0] = MakeTransactionRef(std::move(txCoinbase));
-    pblock->hashMerkleRoot = BlockMerkleRoot(*pblock);
+// Ring-fork: In-wallet miner: Hashrate measurement. Each miner thread owns one cache line of counters, which only it writes
+// (relaxed atomics, no locks on the hashing path); the sampler thread reads them once a second and keeps enough history for
+// the rolling windows reported by GetMinerThreadStats(). The counters only ever grow, so rates are always sample differences.
+static const unsigned int MAX_MINER_COUNTERS = 256;                 // Threads beyond this share slots (nThread % MAX_MINER_COUNTERS)
+static const unsigned int MINER_SAMPLE_WINDOWS[] = {1, 10, 60};     // Seconds
+static const size_t MAX_MINER_SAMPLES = 61;
+
+struct alignas(64) CMinerThreadCounters
+{
+    std::atomic<uint64_t> nHashes{0};
+    std::atomic<uint64_t> nNearTarget{0};
+    std::atomic<int64_t> nJobTime{0};                               // Creation time of the job being mined, or 0 if idle
+};
+static_assert(sizeof(CMinerThreadCounters) == 64, "miner thread counters should fill exactly one cache line");
+
+static CMinerThreadCounters minerCounters[MAX_MINER_COUNTERS];
+
+struct CMinerSample
+{
+    int64_t nTimeMillis;
+    std::vector<uint64_t> vHashes;                                  // Per thread
+    std::vector<uint64_t> vNearTarget;
+};
+
+static Mutex cs_minerStats;
+static std::deque<CMinerSample> minerSamples GUARDED_BY(cs_minerStats);     // Oldest first; empty when the miner is off
+static CMinerSample minerBaseline GUARDED_BY(cs_minerStats);                // Counters when the miner was started
+static uint64_t nMinerStatsRun GUARDED_BY(cs_minerStats) = 0;               // Bumped on each (re)start, so a stopping sampler can't write
+
+static CMinerSample SampleMinerCounters(unsigned int nThreads) {
+    CMinerSample sample;
+    sample.nTimeMillis = GetTimeMillis();
+    for (unsigned int i = 0; i < nThreads; i++) {
+        const CMinerThreadCounters& counters = minerCounters[i % MAX_MINER_COUNTERS];
+        sample.vHashes.push_back(counters.nHashes.load(std::memory_order_relaxed));
+        sample.vNearTarget.push_back(counters.nNearTarget.load(std::memory_order_relaxed));
+    }
+    return sample;
+}
+
+// Ring-fork: In-wallet miner: Hashrate of thread i between the newest sample and the one nSeconds before it (or the oldest)
+static double SampledHashesPerSec(const std::deque<CMinerSample>& samples, unsigned int i, unsigned int nSeconds) EXCLUSIVE_LOCKS_REQUIRED(cs_minerStats) {
+    if (samples.size() < 2)
+        return 0;
+    const CMinerSample& newest = samples.back();
+    const CMinerSample& oldest = samples[samples.size() - 1 - std::min<size_t>(nSeconds, samples.size() - 1)];
+    if (newest.nTimeMillis <= oldest.nTimeMillis)
+        return 0;
+    return 1000.0 * (newest.vHashes[i] - oldest.vHashes[i]) / (newest.nTimeMillis - oldest.nTimeMillis);
 }
 
-// Ring-fork: In-wallet miner: Hashrate measurement vars
-double dHashesPerSec = 0.0;
-int64_t nHPSTimerStart = 0;
+// Ring-fork: In-wallet miner: Samples the miner threads' counters once a second
+void static MinerSamplerThread(unsigned int nThreads, uint64_t nRun) {
+    RenameThread("cpu-miner-stats");
 
-// Ring-fork: In-wallet miner: Scans nonces looking for a hash with at least some zero bits. The nonce is usually preserved between calls, but periodically or if the nonce is 0xffff0000 or above, the block is rebuilt and nNonce starts over at zero.
-bool static ScanHash(CBlockHeader *pblock, uint32_t& nNonce, uint256 *phash) {
-    uint256 hash;
+    {
+        LOCK(cs_minerStats);
+        if (nRun != nMinerStatsRun)
+            return;
+        minerBaseline = SampleMinerCounters(nThreads);
+        minerSamples.push_back(minerBaseline);
+    }
+
+    int64_t nLogTime = GetTime();
     while (true) {
-        nNonce++;
+        MilliSleep(1000);
+        LOCK(cs_minerStats);
+        if (nRun != nMinerStatsRun)
+            return;
+        minerSamples.push_back(SampleMinerCounters(nThreads));
+        if (minerSamples.size() > MAX_MINER_SAMPLES)
+            minerSamples.pop_front();
+
+        if (GetTime() - nLogTime > 30 * 60) {
+            nLogTime = GetTime();
+            double dHashesPerSec = 0;
+            for (unsigned int i = 0; i < nThreads; i++)
+                dHashesPerSec += SampledHashesPerSec(minerSamples, i, MINER_SAMPLE_WINDOWS[2]);
+            LogPrintf("Miner: Hashrate: %6.1f khash/s\n", dHashesPerSec/1000.0);
+        }
+    }
+}
 
-        pblock->nNonce = nNonce;
-        hash = pblock->GetPowHash();                                // Ring-fork: Seperate block hash and pow hash
+// Ring-fork: In-wallet miner: Total hashrate over the last 10s, or 0 if the miner is off
+double GetMinerHashesPerSec() {
+    LOCK(cs_minerStats);
+    if (minerSamples.empty())
+        return 0;
+    double dHashesPerSec = 0;
+    for (unsigned int i = 0; i < minerSamples.back().vHashes.size(); i++)
+        dHashesPerSec += SampledHashesPerSec(minerSamples, i, MINER_SAMPLE_WINDOWS[1]);
+    return dHashesPerSec;
+}
+
+// Ring-fork: In-wallet miner: Per-thread telemetry; empty if the miner is off
+std::vector<CMinerThreadStats> GetMinerThreadStats() {
+    std::vector<CMinerThreadStats> vStats;
+    LOCK(cs_minerStats);
+    if (minerSamples.empty())
+        return vStats;
+
+    const CMinerSample& newest = minerSamples.back();
+    int64_t nNow = GetTime();
+    for (unsigned int i = 0; i < newest.vHashes.size(); i++) {
+        CMinerThreadStats stats;
+        stats.nThread = i;
+        stats.dHashesPerSec1s = SampledHashesPerSec(minerSamples, i, MINER_SAMPLE_WINDOWS[0]);
+        stats.dHashesPerSec10s = SampledHashesPerSec(minerSamples, i, MINER_SAMPLE_WINDOWS[1]);
+        stats.dHashesPerSec60s = SampledHashesPerSec(minerSamples, i, MINER_SAMPLE_WINDOWS[2]);
+        stats.nHashes = newest.vHashes[i] - minerBaseline.vHashes[i];
+        stats.nNearTarget = newest.vNearTarget[i] - minerBaseline.vNearTarget[i];
+        int64_t nJobTime = minerCounters[i % MAX_MINER_COUNTERS].nJobTime.load(std::memory_order_relaxed);
+        stats.nTemplateAge = nJobTime ? std::max<int64_t>(0, nNow - nJobTime) : -1;
+        vStats.push_back(stats);
+    }
+    return vStats;
+}
 
-        if (hash.ByteAt(31) == 0 && hash.ByteAt(30) == 0) {         // Return the nonce if the hash has at least some zero bits, caller will check if it has enough to reach the target
-            memcpy(phash, &hash, 32);
-            return true;
+// Ring-fork: In-wallet miner: Work shared by all miner threads. MinerJobThread builds one block template per tip/mempool epoch and
+// publishes it as a new job; each MinerThread then mines its own copy with an extranonce no other thread uses for that job,
+// so their nonce spaces never overlap.
+struct CMinerJob
+{
+    uint64_t nId;
+    int64_t nTime;                                  // When the template was built
+    CBlock block;                                   // Template; coinbase extranonce and merkle root are set by each thread
+    const CBlockIndex* pindexPrev;
+    std::shared_ptr<CReserveScript> coinbaseScript;
+};
+
+static Mutex cs_minerJob;
+static std::condition_variable cvMinerJob;
+static std::shared_ptr<const CMinerJob> minerJob GUARDED_BY(cs_minerJob);   // Current job, or null when there's nothing to mine
+static std::atomic<uint64_t> nMinerJobId(0);                                  // Id of the current job; polled by miner threads to notice a refresh
+
+// Ring-fork: In-wallet miner: Replace the current job (null to stop miner threads) and wake all miner threads
+static void PublishMinerJob(std::shared_ptr<CMinerJob> job) {
+    {
+        LOCK(cs_minerJob);
+        uint64_t nId = nMinerJobId.load() + 1;
+        if (job)
+            job->nId = nId;
+        minerJob = job;
+        nMinerJobId.store(nId);
+    }
+    cvMinerJob.notify_all();
+}
+
+// Ring-fork: In-wallet miner: Wait for a job other than the one with the given id
+static std::shared_ptr<const CMinerJob> WaitForMinerJob(uint64_t nLastId) {
+    WAIT_LOCK(cs_minerJob, lock);
+    while (!minerJob || minerJob->nId == nLastId) {
+        cvMinerJob.wait_for(lock, std::chrono::milliseconds(500));
+        boost::this_thread::interruption_point();
+    }
+    return minerJob;
+}
+
+// Ring-fork: In-wallet miner: Retire the job with the given id once one of its blocks is found, so the other threads stop
+// hashing it straight away rather than at the job thread's next poll. The job thread then builds the next one.
+static void RetireMinerJob(uint64_t nId) {
+    {
+        LOCK(cs_minerJob);
+        if (!minerJob || minerJob->nId != nId)
+            return;
+        minerJob = nullptr;
+        nMinerJobId.store(nId + 1);
+    }
+    cvMinerJob.notify_all();
+}
+
+// Ring-fork: In-wallet miner: Scans nonces looking for a hash meeting hashTarget. The nonce is usually preserved between calls, but periodically or if the nonce is 0xffff0000 or above, the block is rebuilt and nNonce starts over at zero.
+// Every hash is checked against the target and credited to nHashes (and nNearTarget, if within MINER_NEAR_TARGET_BITS of it) as
+// the nonce passes it, so lanes after a solution in its batch aren't counted until they're hashed again on the next call. The scan
+// stops early once job nJobId has been replaced or retired.
+bool ScanHash(CBlockHeader *pblock, uint32_t& nNonce, uint256 *phash, const arith_uint256& hashTarget, std::atomic<uint64_t>& nHashes, std::atomic<uint64_t>& nNearTarget, uint64_t nJobId) {
+    // Hash a run of consecutive nonces per batch; each lane is a copy of the header with its own nonce
+    static const unsigned int BATCH_SIZE = MinotaurBatch::MAX_LANES;
+    MinotaurBatch batch;
+    CBlockHeader headers[BATCH_SIZE];
+    const unsigned char* data[BATCH_SIZE];
+    unsigned char hashes[BATCH_SIZE * 32];
+    for (unsigned int i = 0; i < BATCH_SIZE; i++) {
+        headers[i] = *pblock;
+        data[i] = (const unsigned char*)&headers[i].nVersion;           // Ring-fork: Seperate block hash and pow hash (hash the header in place, same as GetPowHash())
+    }
+
+    while (true) {
+        for (unsigned int i = 0; i < BATCH_SIZE; i++)
+            headers[i].nNonce = nNonce + 1 + i;
+        batch.Hash(data, 80, BATCH_SIZE, hashes);
+
+        uint64_t nNear = 0;
+        for (unsigned int i = 0; i < BATCH_SIZE; i++) {
+            uint256 hash;
+            memcpy(hash.begin(), hashes + i * 32, 32);
+            arith_uint256 hashArith = UintToArith256(hash);
+            if ((hashArith >> MINER_NEAR_TARGET_BITS) > hashTarget)
+                continue;
+            nNear++;
+            if (hashArith <= hashTarget) {                              // Found a good solution; the lanes after it are left unscanned
+                nHashes.fetch_add(i + 1, std::memory_order_relaxed);
+                nNearTarget.fetch_add(nNear, std::memory_order_relaxed);
+                nNonce += i + 1;
+                pblock->nNonce = nNonce;
+                *phash = hash;
+                return true;
+            }
         }
+        nHashes.fetch_add(BATCH_SIZE, std::memory_order_relaxed);
+        if (nNear)
+            nNearTarget.fetch_add(nNear, std::memory_order_relaxed);
+        nNonce += BATCH_SIZE;
+        pblock->nNonce = nNonce;
 
-        if ((nNonce & 0xffff) == 0)                                 // If nothing found after trying for a while, return -1
+        if ((nNonce & 0xffff) < BATCH_SIZE)                             // If nothing found after trying for a while, return -1
             return false;
 
-        if ((nNonce & 0xfff) == 0)                                  // Fire an interrupt to measure hashrate
+        if (nMinerJobId.load(std::memory_order_relaxed) != nJobId)     // Job replaced or retired
+            return false;
+
+        if ((nNonce & 0xfff) < BATCH_SIZE)                              // Fire an interrupt to measure hashrate
             boost::this_thread::interruption_point();
     }
 }
 
-// Ring-fork: In-wallet miner: Single thread in the thread group
-void static MinerThread(const CChainParams& chainparams) {
-    LogPrintf("Miner: Thread started\n");
-    SetThreadPriority(THREAD_PRIORITY_LOWEST);
-    RenameThread("cpu-miner");
+// Ring-fork: In-wallet miner: Builds the block template shared by the miner threads, and replaces it whenever the tip changes,
+// the mempool has changed for a while, or mining should pause. The only thread in the group touching chainActive and the mempool.
+void static MinerJobThread(const CChainParams& chainparams) {
+    LogPrintf("Miner: Job thread started\n");
+    RenameThread("cpu-miner-job");
 
-    unsigned int nExtraNonce = 0;
     try {
         // Check P2P exists
         if(!g_connman)
@@ -606,6 +810,7 @@ void static MinerThread(const CChainParams& chainparams) {
                 do {
                     if (g_connman->GetNodeCount(CConnman::CONNECTIONS_ALL) > 0 && !IsInitialBlockDownload())
                         break;
+                    PublishMinerJob(nullptr);
                     if (IsInitialBlockDownload())
                         LogPrintf("Miner: Initial block download; sleeping for 10 seconds.\n");
                     else
@@ -616,31 +821,83 @@ void static MinerThread(const CChainParams& chainparams) {
 
             // Create a block
             unsigned int nTransactionsUpdatedLast = mempool.GetTransactionsUpdated();
-            CBlockIndex* pindexPrev = chainActive.Tip();
+            CBlockIndex* pindexPrev;
+            {
+                LOCK(cs_main);
+                pindexPrev = chainActive.Tip();
+            }
             std::unique_ptr<CBlockTemplate> pblocktemplate(BlockAssembler(Params()).CreateNewBlock(coinbaseScript->reserveScript));
             if (!pblocktemplate.get())
                 throw std::runtime_error("Couldn't get block template. Probably keypool ran out; please call keypoolrefill before restarting the mining thread");
 
-            CBlock *pblock = &pblocktemplate->block;
-            {
-                LOCK(cs_main);
-                IncrementExtraNonce(pblock, pindexPrev, nExtraNonce);
-            }
+            std::shared_ptr<CMinerJob> job = std::make_shared<CMinerJob>();
+            job->nTime = GetTime();
+            job->block = pblocktemplate->block;
+            job->pindexPrev = pindexPrev;
+            job->coinbaseScript = coinbaseScript;
+            PublishMinerJob(job);
+            LogPrintf("Miner: Running (%u transactions in block)\n", job->block.vtx.size());
 
-            // Scan for a good nonce
-            LogPrintf("Miner: Running (%u transactions in block)\n", pblock->vtx.size());
+            // Wait until the job needs replacing
             int64_t nStart = GetTime();
-            arith_uint256 hashTarget = arith_uint256().SetCompact(pblock->nBits);
-            uint256 hash;
-            uint32_t nNonce = 0;
-            uint32_t nOldNonce = 0;
             while (true) {
-                bool fFound = ScanHash(pblock, nNonce, &hash);
-                uint32_t nHashesDone = nNonce - nOldNonce;
-                nOldNonce = nNonce;
+                MilliSleep(250);
+                if (nMinerJobId.load() != job->nId)                                                                 // Job retired after a block was found
+                    break;
+                if (!chainparams.MineBlocksOnDemand() && g_connman->GetNodeCount(CConnman::CONNECTIONS_ALL) == 0)   // No peers and not in regtest
+                    break;
+                if (mempool.GetTransactionsUpdated() != nTransactionsUpdatedLast && GetTime() - nStart > 60)        // Transactions updated, or been trying a while
+                    break;
+                LOCK(cs_main);
+                if (pindexPrev != chainActive.Tip())                                                                // Tip changed
+                    break;
+            }
+        }
+    }
+    catch (const boost::thread_interrupted&) {
+        LogPrintf("Miner: Job thread terminated\n");
+        throw;
+    }
+    catch (const std::runtime_error &e) {
+        PublishMinerJob(nullptr);
+        LogPrintf("Miner: Runtime error: %s\n", e.what());
+        return;
+    }
+}
 
-                if (fFound) {                                       // Found a potential (has at least some zeroes)
-                    if (UintToArith256(hash) <= hashTarget) {       // Found a good solution :)
+// Ring-fork: In-wallet miner: Single hashing thread in the thread group. Mines the current job with extranonces
+// nThread, nThread + nThreads, nThread + 2 * nThreads...
+void static MinerThread(const CChainParams& chainparams, unsigned int nThread, unsigned int nThreads) {
+    LogPrintf("Miner: Thread started\n");
+    SetThreadPriority(THREAD_PRIORITY_LOWEST);
+    RenameThread("cpu-miner");
+
+    CMinerThreadCounters& counters = minerCounters[nThread % MAX_MINER_COUNTERS];
+    counters.nJobTime.store(0, std::memory_order_relaxed);
+
+    try {
+        uint64_t nJobId = 0;
+        while (true) {
+            counters.nJobTime.store(0, std::memory_order_relaxed);
+            std::shared_ptr<const CMinerJob> job = WaitForMinerJob(nJobId);
+            nJobId = job->nId;
+            counters.nJobTime.store(job->nTime, std::memory_order_relaxed);
+            const CBlockIndex* pindexPrev = job->pindexPrev;
+            unsigned int nExtraNonce = nThread;
+
+            // Mine the job until it's replaced, moving to this thread's next extranonce whenever the nonce space runs out
+            while (nMinerJobId.load(std::memory_order_relaxed) == nJobId) {
+                CBlock block(job->block);
+                CBlock *pblock = &block;
+                SetExtraNonce(pblock, pindexPrev->nHeight + 1, nExtraNonce);
+                nExtraNonce += nThreads;
+
+                // Scan for a good nonce
+                arith_uint256 hashTarget = arith_uint256().SetCompact(pblock->nBits);
+                uint256 hash;
+                uint32_t nNonce = 0;
+                while (true) {
+                    if (ScanHash(pblock, nNonce, &hash, hashTarget, counters.nHashes, counters.nNearTarget, nJobId)) {    // Found a good solution :)
                         pblock->nNonce = nNonce;
                         assert(hash == pblock->GetPowHash());       // Ring-fork: Seperate block hash and pow hash
 
@@ -663,8 +920,12 @@ void static MinerThread(const CChainParams& chainparams) {
                             break;
                         }
 
+                        RetireMinerJob(nJobId);                     // Stop the other threads mining the now stale job
                         SetThreadPriority(THREAD_PRIORITY_LOWEST);
-                        coinbaseScript->KeepScript();
+                        {
+                            LOCK(cs_minerJob);                      // The coinbase script is shared by all threads mining the job
+                            job->coinbaseScript->KeepScript();
+                        }
 
                         uiInterface.NotifyBlockFound(); // Fire UI notification
 
@@ -674,57 +935,26 @@ void static MinerThread(const CChainParams& chainparams) {
 
                         break;
                     }
-                }
 
-                // Meter hashes/sec
-                static int64_t nHashCounter;
-                if (nHPSTimerStart == 0) {
-                    nHPSTimerStart = GetTimeMillis();
-                    nHashCounter = 0;
-                } else
-                    nHashCounter += nHashesDone;
-                if (GetTimeMillis() - nHPSTimerStart > 4000) {
-                    static CCriticalSection cs;
-                    {
-                        LOCK(cs);
-                        if (GetTimeMillis() - nHPSTimerStart > 4000) {
-                            dHashesPerSec = 1000.0 * nHashCounter / (GetTimeMillis() - nHPSTimerStart);
-                            nHPSTimerStart = GetTimeMillis();
-                            nHashCounter = 0;
-                            static int64_t nLogTime;
-                            if (GetTime() - nLogTime > 30 * 60) {
-                                nLogTime = GetTime();
-                                LogPrintf("Miner: Hashrate: %6.1f khash/s\n", dHashesPerSec/1000.0);
-                            }
-                        }
-                    }
+                    // Check whether to break or continue
+                    boost::this_thread::interruption_point();
+                    if (nMinerJobId.load(std::memory_order_relaxed) != nJobId)                                          // Job replaced
+                        break;
+                    if (nNonce >= 0xffff0000)                                                                           // Nonce space maxed out
+                        break;
+                    if (UpdateTime(pblock, chainparams.GetConsensus(), pindexPrev) < 0)                                 // Clock ran backwards
+                        break;
+                    if (chainparams.GetConsensus().fPowAllowMinDifficultyBlocks)                                        // Changing pblock->nTime can change work required on testnet due to diff reset
+                        hashTarget.SetCompact(pblock->nBits);
                 }
-
-                // Check whether to break or continue
-                boost::this_thread::interruption_point();
-                if (!chainparams.MineBlocksOnDemand() && g_connman->GetNodeCount(CConnman::CONNECTIONS_ALL) == 0)   // No peers and not in regtest
-                    break;
-                if (nNonce >= 0xffff0000)                                                                           // Nonce space maxed out
-                    break;
-                if (mempool.GetTransactionsUpdated() != nTransactionsUpdatedLast && GetTime() - nStart > 60)        // Transactions updated, or been trying a while
-                    break;
-                if (pindexPrev != chainActive.Tip())                                                                // Tip changed
-                    break;
-                if (UpdateTime(pblock, chainparams.GetConsensus(), pindexPrev) < 0)                                 // Clock ran backwards
-                    break;
-                if (chainparams.GetConsensus().fPowAllowMinDifficultyBlocks)                                        // Changing pblock->nTime can change work required on testnet due to diff reset
-                    hashTarget.SetCompact(pblock->nBits);
             }
         }
     }
     catch (const boost::thread_interrupted&) {
+        counters.nJobTime.store(0, std::memory_order_relaxed);
         LogPrintf("Miner: Thread terminated\n");
         throw;
     }
-    catch (const std::runtime_error &e) {
-        LogPrintf("Miner: Runtime error: %s\n", e.what());
-        return;
-    }
 }
 
 // Ring-fork: In-wallet miner: Mining thread controller
@@ -738,175 +968,367 @@ void MineCoins(bool fGenerate, int nThreads, const CChainParams& chainparams) {
         minerThreads->interrupt_all();
         delete minerThreads;
         minerThreads = NULL;
+        PublishMinerJob(nullptr);
     }
 
     uiInterface.NotifyGenerateChanged();        // Fire UI notification
 
-    dHashesPerSec = 0;
+    uint64_t nStatsRun;
+    {
+        LOCK(cs_minerStats);
+        minerSamples.clear();
+        nStatsRun = ++nMinerStatsRun;
+    }
 
     if (nThreads == 0 || !fGenerate)
         return;
 
     minerThreads = new boost::thread_group();
+    minerThreads->create_thread(boost::bind(&MinerJobThread, boost::cref(chainparams)));
+    minerThreads->create_thread(boost::bind(&MinerSamplerThread, (unsigned int)nThreads, nStatsRun));
     for (int i = 0; i < nThreads; i++)          // Start threads
-        minerThreads->create_thread(boost::bind(&MinerThread, boost::cref(chainparams)));
+        minerThreads->create_thread(boost::bind(&MinerThread, boost::cref(chainparams), i, nThreads));
 }
 
-// Ring-fork: Hive: Dwarf management thread
-void DwarfMaster(const CChainParams& chainparams) {
-    const Consensus::Params& consensusParams = chainparams.GetConsensus();
+// Ring-fork: Hive: Mining optimisations: Persistent hive check pool. Each BusyDwarves round publishes a job covering all
+// mature dwarves; the pool's workers claim HIVE_CHECK_CHUNK_SIZE dwarves at a time from the job's shared cursor until a
+// solution is found, the dwarves run out or the job is cancelled. A job is live only while its generation is current, so
+// cancelling is just a matter of bumping nHiveCheckGeneration.
+static const int HIVE_CHECK_CHUNK_SIZE = 256;           // Dwarves claimed per step; a few ms of hashing
+static const int HIVE_CHECK_CANCEL_INTERVAL = 32;       // Dwarves between cancellation checks within a chunk
 
-    LogPrintf("DwarfMaster: Thread started\n");
-    RenameThread("hive-dwarfmaster");
+struct CHiveCheckJob
+{
+    uint64_t nGeneration;
+    std::string deterministicRandString;
+    arith_uint256 dwarfHashTarget;
+    std::vector<CDwarfRange> vRanges;                   // One per mature DCT
+    std::vector<int> vRangeStart;                       // Index of each range's first dwarf across the whole job
+    int nTotal;
+    std::atomic<int> nCursor{0};                        // Next unclaimed dwarf
+    std::atomic<int> nDone{0};                          // Dwarves checked
+    std::atomic<int> nHashed{0};                        // Dwarves hashed, counting chunks left part-checked
+    std::atomic<bool> fSolved{false};
+    CDwarfRange solvingRange;                           // Set with fSolved, under cs_hiveCheck
+    uint32_t nSolvingDwarf;
+};
+
+static Mutex cs_hiveCheck;
+static std::condition_variable cvHiveCheckWork;         // Signalled when a job is published
+static std::condition_variable cvHiveCheckDone;         // Signalled when a job is solved or finished
+static std::shared_ptr<CHiveCheckJob> hiveCheckJob GUARDED_BY(cs_hiveCheck);
+static std::atomic<uint64_t> nHiveCheckGeneration(0);
+static std::atomic<int64_t> nHiveCheckCancelTime(0);    // When the last cancel was made, in microseconds
+
+// Ring-fork: Hive: Mining optimisations: Check chunks of the given job until it's solved, exhausted or cancelled
+static void CheckHiveJob(CHiveCheckJob& job) {
+    CDwarfHasher dwarfHasher(job.deterministicRandString);
+    size_t nRange = job.vRanges.size();
+    while (true) {
+        int nStart = job.nCursor.fetch_add(HIVE_CHECK_CHUNK_SIZE);
+        if (nStart >= job.nTotal)
+            return;
+        int nEnd = std::min(nStart + HIVE_CHECK_CHUNK_SIZE, job.nTotal);
 
-    int height;
-    {
-        LOCK(cs_main);
-        height = chainActive.Tip()->nHeight;
-    }
+        for (int n = nStart; n < nEnd; n++) {
+            if ((n - nStart) % HIVE_CHECK_CANCEL_INTERVAL == 0 && (job.fSolved.load(std::memory_order_relaxed) || nHiveCheckGeneration.load(std::memory_order_relaxed) != job.nGeneration)) {
+                job.nHashed.fetch_add(n - nStart);
+                return;
+            }
 
-    try {
-        while (true) {
-            // Ring-fork: Hive: Mining optimisations: Parameterised sleep time
-            int sleepTime = std::max((int64_t) 1, gArgs.GetArg("-hivecheckdelay", DEFAULT_HIVE_CHECK_DELAY));
-            MilliSleep(sleepTime);
-            int newHeight;
-            {
-                LOCK(cs_main);
-                newHeight = chainActive.Tip()->nHeight;
+            // Chunks can span DCTs; move to the range holding dwarf n
+            if (nRange == job.vRanges.size() || n < job.vRangeStart[nRange] || n >= job.vRangeStart[nRange] + job.vRanges[nRange].count) {
+                nRange = std::upper_bound(job.vRangeStart.begin(), job.vRangeStart.end(), n) - job.vRangeStart.begin() - 1;
+                dwarfHasher.SetTxid(job.vRanges[nRange].txid);
             }
-            if (newHeight != height) {
-                // Height changed; release the dwarves!
-                height = newHeight;
-                try {
-                    BusyDwarves(consensusParams, height);
-                } catch (const std::runtime_error &e) {
-                    LogPrintf("! DwarfMaster: Error: %s\n", e.what());
+            uint32_t nDwarf = job.vRanges[nRange].offset + n - job.vRangeStart[nRange];
+
+            if (dwarfHasher.CheckTarget(nDwarf, job.dwarfHashTarget)) {
+                job.nHashed.fetch_add(n - nStart + 1);
+                LOCK(cs_hiveCheck);
+                if (!job.fSolved.load()) {
+                    job.solvingRange = job.vRanges[nRange];
+                    job.nSolvingDwarf = nDwarf;
+                    job.fSolved.store(true);
                 }
+                cvHiveCheckDone.notify_all();
+                return;
             }
         }
-    } catch (const boost::thread_interrupted&) {
-        LogPrintf("!!! DwarfMaster: FATAL: Thread interrupted\n");
-        throw;
+
+        job.nHashed.fetch_add(nEnd - nStart);
+        if (job.nDone.fetch_add(nEnd - nStart) + (nEnd - nStart) >= job.nTotal) {
+            LOCK(cs_hiveCheck);
+            cvHiveCheckDone.notify_all();
+        }
     }
 }
 
-// Ring-fork: Hive: Mining optimisations: Thread to signal abort on new block
-void AbortWatchThread(int height) {
-    // Loop until any exit condition
+// Ring-fork: Hive: Mining optimisations: Hive check pool worker; checks each published job once
+void static HiveCheckThread() {
+    RenameThread("hive-check");
+
+    uint64_t nLastGeneration = 0;
     while (true) {
-        // Yield to OS
-        MilliSleep(1);
+        std::shared_ptr<CHiveCheckJob> job;
+        {
+            WAIT_LOCK(cs_hiveCheck, lock);
+            while (!hiveCheckJob || hiveCheckJob->nGeneration == nLastGeneration) {
+                cvHiveCheckWork.wait_for(lock, std::chrono::milliseconds(500));
+                boost::this_thread::interruption_point();
+            }
+            job = hiveCheckJob;
+        }
+        nLastGeneration = job->nGeneration;
+        CheckHiveJob(*job);
+    }
+}
 
-        // Check pre-existing abort conditions
-        if (solutionFound.load() || earlyAbort.load())
-            return;
+// Ring-fork: Hive: Mining optimisations: The pool's threads. Only touched from the DwarfMaster thread (or a benchmark standing in for it).
+static boost::thread_group* hiveCheckThreads = nullptr;
+static int nHiveCheckThreads = 0;
+
+void StopHiveCheckThreads() {
+    nHiveCheckGeneration++;
+    if (hiveCheckThreads) {
+        hiveCheckThreads->interrupt_all();
+        hiveCheckThreads->join_all();
+        delete hiveCheckThreads;
+        hiveCheckThreads = nullptr;
+    }
+    nHiveCheckThreads = 0;
+    LOCK(cs_hiveCheck);
+    hiveCheckJob.reset();
+}
 
-        // Get tip height, keeping lock scope as short as possible
-        int newHeight;
-        {
-            LOCK(cs_main);
-            newHeight = chainActive.Tip()->nHeight;
+// Ring-fork: Hive: Mining optimisations: Start the pool, or resize it if the thread count setting changed
+static void EnsureHiveCheckThreads(int nThreads) {
+    if (nThreads == nHiveCheckThreads)
+        return;
+    StopHiveCheckThreads();
+    hiveCheckThreads = new boost::thread_group();
+    for (int i = 0; i < nThreads; i++)
+        hiveCheckThreads->create_thread(&HiveCheckThread);
+    nHiveCheckThreads = nThreads;
+}
+
+// Ring-fork: Hive: Mining optimisations: Publish a job covering the given dwarves to the pool, started with nThreads workers
+static std::shared_ptr<CHiveCheckJob> PublishHiveCheckJob(const std::string& deterministicRandString, const arith_uint256& dwarfHashTarget, const std::vector<CDwarfRange>& vRanges, int nThreads) {
+    EnsureHiveCheckThreads(nThreads);
+    std::shared_ptr<CHiveCheckJob> job = std::make_shared<CHiveCheckJob>();
+    job->deterministicRandString = deterministicRandString;
+    job->dwarfHashTarget = dwarfHashTarget;
+    job->vRanges = vRanges;
+    job->vRangeStart.reserve(vRanges.size());
+    job->nTotal = 0;
+    for (const CDwarfRange& range : vRanges) {
+        job->vRangeStart.push_back(job->nTotal);
+        job->nTotal += range.count;
+    }
+
+    {
+        LOCK(cs_hiveCheck);
+        job->nGeneration = ++nHiveCheckGeneration;
+        hiveCheckJob = job;
+    }
+    cvHiveCheckWork.notify_all();
+    return job;
+}
+
+// Ring-fork: Hive: Mining optimisations: Wait for the pool to solve or run out of a published job, or for the job to be cancelled
+static HiveCheckResult WaitHiveCheckJob(CHiveCheckJob& job, CDwarfRange& solvingRange, uint32_t& solvingDwarf) {
+    {
+        WAIT_LOCK(cs_hiveCheck, lock);
+        while (!job.fSolved.load() && job.nDone.load() < job.nTotal && nHiveCheckGeneration.load() == job.nGeneration) {
+            cvHiveCheckDone.wait_for(lock, std::chrono::milliseconds(100));
+            boost::this_thread::interruption_point();
         }
+    }
+
+    if (!job.fSolved.load())
+        return nHiveCheckGeneration.load() != job.nGeneration ? HIVE_CHECK_ABORTED : HIVE_CHECK_NONE;
+
+    LOCK(cs_hiveCheck);
+    solvingRange = job.solvingRange;
+    solvingDwarf = job.nSolvingDwarf;
+    return HIVE_CHECK_SOLVED;
+}
+
+HiveCheckResult CheckHiveDwarves(const std::string& deterministicRandString, const arith_uint256& dwarfHashTarget, const std::vector<CDwarfRange>& vRanges, int nThreads, CDwarfRange& solvingRange, uint32_t& solvingDwarf) {
+    std::shared_ptr<CHiveCheckJob> job = PublishHiveCheckJob(deterministicRandString, dwarfHashTarget, vRanges, nThreads);
+    return WaitHiveCheckJob(*job, solvingRange, solvingDwarf);
+}
 
-        // Check for abort from tip height change
-        if (newHeight != height) {
-            //LogPrintf("*** ABORT FIRE\n");
-            earlyAbort.store(true);
+void CancelHiveCheck() {
+    nHiveCheckCancelTime.store(GetTimeMicros());
+    nHiveCheckGeneration++;
+    LOCK(cs_hiveCheck);
+    cvHiveCheckDone.notify_all();
+}
+
+bool GetHiveCheckProgress(int& nClaimed, int& nChecked) {
+    LOCK(cs_hiveCheck);
+    if (!hiveCheckJob || hiveCheckJob->nGeneration != nHiveCheckGeneration.load() || hiveCheckJob->fSolved.load())
+        return false;
+    nClaimed = std::min(hiveCheckJob->nCursor.load(), hiveCheckJob->nTotal);
+    nChecked = hiveCheckJob->nDone.load();
+    return nChecked < hiveCheckJob->nTotal;
+}
+
+// Ring-fork: Hive: Tip and block notifications driving DwarfMaster. The tip DwarfMaster last saw is kept here rather than
+// read from chainActive, so waiting for a new tip (and watching for one during a round) never touches cs_main.
+static Mutex cs_hiveTip;
+static std::condition_variable cvHiveTip;
+static const CBlockIndex* pindexHiveTip GUARDED_BY(cs_hiveTip) = nullptr;
+static int64_t nHiveTipTime GUARDED_BY(cs_hiveTip) = 0;  // When pindexHiveTip arrived, in microseconds
+static const CBlockIndex* pindexHiveRound GUARDED_BY(cs_hiveTip) = nullptr;   // Block the current round builds on, or nullptr if there's no round to abort
+static bool fHiveRoundSpeculative GUARDED_BY(cs_hiveTip) = false;
+
+bool IsHiveRoundStaleOnTip(const CBlockIndex* pindexRoundPrev, bool fSpeculative, const CBlockIndex* pindexTip) {
+    if (!pindexTip || pindexTip == pindexRoundPrev)
+        return false;
+    return !(fSpeculative && pindexTip == pindexRoundPrev->pprev);
+}
+
+bool IsHiveRoundStaleOnBlock(const CBlockIndex* pindexRoundPrev, const CBlockIndex* pindexBlock) {
+    return pindexBlock->pprev == pindexRoundPrev;   // A competitor for the block the round is mining
+}
+
+// Ring-fork: Hive: Mining optimisations: Cancel the current round, if it's abortable and a new header or block makes it stale
+static void CancelStaleHiveRound(const CBlockIndex* pindexBlock) {
+    {
+        LOCK(cs_hiveTip);
+        if (!pindexHiveRound || !IsHiveRoundStaleOnBlock(pindexHiveRound, pindexBlock))
             return;
-        }
+        pindexHiveRound = nullptr;
     }
+    CancelHiveCheck();
 }
 
-// Ring-fork: Hive: Mining optimisations: Thread to check a single bin
-void CheckBin(int threadID, std::vector<CDwarfRange> bin, std::string deterministicRandString, arith_uint256 dwarfHashTarget) {
-    // Iterate over ranges in this bin
-    int checkCount = 0;
-    for (std::vector<CDwarfRange>::const_iterator it = bin.begin(); it != bin.end(); it++) {
-        CDwarfRange dwarfRange = *it;
-        //LogPrintf("THREAD #%i: Checking %i-%i in %s\n", threadID, dwarfRange.offset, dwarfRange.offset + dwarfRange.count - 1, dwarfRange.txid);
-        // Iterate over dwarves in this range
-        for (int i = dwarfRange.offset; i < dwarfRange.offset + dwarfRange.count; i++) {
-            // Check abort conditions (Only every N dwarves. The atomic load is expensive, but much cheaper than a mutex - esp on Windows, see https://www.arangodb.com/2015/02/comparing-atomic-mutex-rwlocks/)
-            if(checkCount++ % 1000 == 0) {
-                if (solutionFound.load() || earlyAbort.load()) {
-                    //LogPrintf("THREAD #%i: Solution found elsewhere or early abort requested, ending early\n", threadID);
-                    return;
-                }
-            }
-            // Hash the dwarf
-            arith_uint256 dwarfHash(CBlockHeader::MinotaurHashArbitrary(std::string(deterministicRandString + dwarfRange.txid + std::to_string(i)).c_str()).ToString());
-            dwarfHash = arith_uint256(CBlockHeader::MinotaurHashArbitrary(dwarfHash.ToString().c_str()).ToString());
-
-            // Compare to target and write out result if successful
-            if (dwarfHash < dwarfHashTarget) {
-                //LogPrintf("THREAD #%i: Solution found, returning\n", threadID);
-                LOCK(cs_solution_vars);                                 // Expensive mutex only happens at write-out
-                solutionFound.store(true);
-                solvingRange = dwarfRange;
-                solvingDwarf = i;
-                return;
+static void EndHiveRound() {
+    LOCK(cs_hiveTip);
+    pindexHiveRound = nullptr;
+}
+
+class HiveNotifier final : public CValidationInterface
+{
+protected:
+    void UpdatedBlockTip(const CBlockIndex* pindexNew, const CBlockIndex* pindexFork, bool fInitialDownload) override
+    {
+        bool fStale = false;
+        {
+            LOCK(cs_hiveTip);
+            pindexHiveTip = pindexNew;
+            nHiveTipTime = GetTimeMicros();
+            if (pindexHiveRound && IsHiveRoundStaleOnTip(pindexHiveRound, fHiveRoundSpeculative, pindexNew)) {
+                pindexHiveRound = nullptr;
+                fStale = true;
             }
         }
+        cvHiveTip.notify_all();
+        if (fStale)
+            CancelHiveCheck();
     }
-    //LogPrintf("THREAD #%i: Out of tasks\n", threadID);
+
+    // Called as soon as a competing block's header and PoW check out, before it's connected
+    void NewPoWValidBlock(const CBlockIndex* pindex, const std::shared_ptr<const CBlock>& block) override
+    {
+        CancelStaleHiveRound(pindex);
+    }
+};
+
+// Ring-fork: Hive: Mining optimisations: Recent rounds, for gethivemininginfo
+static Mutex cs_hiveRounds;
+static std::deque<CHiveRoundStats> hiveRounds GUARDED_BY(cs_hiveRounds);    // Oldest first
+
+static void RecordHiveRound(const CHiveRoundStats& stats) {
+    LOCK(cs_hiveRounds);
+    hiveRounds.push_back(stats);
+    if (hiveRounds.size() > HIVE_ROUND_HISTORY_SIZE)
+        hiveRounds.pop_front();
 }
 
-// Ring-fork: Hive: Attempt to mint the next block
-bool BusyDwarves(const Consensus::Params& consensusParams, int height) {
-    bool verbose = LogAcceptCategory(BCLog::HIVE);
+// Ring-fork: Hive: Mining optimisations: Note the submission of a block mined by the latest solved round for its height
+static void RecordHiveSubmit(int nHeight, int64_t nSubmitMicros, bool fAccepted) {
+    LOCK(cs_hiveRounds);
+    for (auto it = hiveRounds.rbegin(); it != hiveRounds.rend(); ++it) {
+        if (it->nHeight == nHeight && it->result == HIVE_CHECK_SOLVED) {
+            it->nSubmitMicros = nSubmitMicros;
+            it->fAccepted = fAccepted;
+            return;
+        }
+    }
+}
 
-    CBlockIndex* pindexPrev = chainActive.Tip();
-    assert(pindexPrev != nullptr);
+std::vector<CHiveRoundStats> GetHiveRoundStats() {
+    LOCK(cs_hiveRounds);
+    return std::vector<CHiveRoundStats>(hiveRounds.begin(), hiveRounds.end());
+}
 
-    // Sanity checks
+static std::unique_ptr<HiveNotifier> hiveNotifier;     // Never freed; the scheduler may still be delivering to it at shutdown
+
+// Ring-fork: Hive: Skip reasons shared by normal and speculative hive checks. Returns the wallet to mint with, or null to skip.
+static std::shared_ptr<CWallet> GetHiveWallet(const Consensus::Params& consensusParams, int height) {
     if(!g_connman) {
         LogPrint(BCLog::HIVE, "BusyDwarves: Skipping hive check: Peer-to-peer functionality missing or disabled\n");
-        return false;
+        return nullptr;
     }
     if (g_connman->GetNodeCount(CConnman::CONNECTIONS_ALL) == 0) {
         LogPrint(BCLog::HIVE, "BusyDwarves: Skipping hive check (not connected)\n");
-        return false;
+        return nullptr;
     }
     if (IsInitialBlockDownload()) {
         LogPrint(BCLog::HIVE, "BusyDwarves: Skipping hive check (in initial block download)\n");
-        return false;
+        return nullptr;
     }
     if (height < consensusParams.lastInitialDistributionHeight + consensusParams.slowStartBlocks) {
         LogPrint(BCLog::HIVE, "BusyDwarves: Skipping hive check (slow start has not finished)\n");
-        return false;
-    }
-
-    // Check that there aren't too many Hive blocks since the last Pow block
-    int hiveBlocksSincePow = 0;
-    CBlockIndex* pindexTemp = pindexPrev;
-    while (pindexTemp->GetBlockHeader().IsPopMined(consensusParams) || pindexTemp->GetBlockHeader().IsHiveMined(consensusParams)) {
-        if (pindexTemp->GetBlockHeader().IsHiveMined(consensusParams))
-            hiveBlocksSincePow++;
-
-        assert(pindexTemp->pprev);
-        pindexTemp = pindexTemp->pprev;
-    }
-    if (hiveBlocksSincePow >= consensusParams.maxConsecutiveHiveBlocks) {
-        LogPrintf("BusyDwarves: Skipping hive check (max Hive blocks without a POW block reached)\n");
-        return false;
+        return nullptr;
     }
 
     // Get wallet
     JSONRPCRequest request;
-    std::shared_ptr<CWallet> const wallet = GetWalletForJSONRPCRequest(request);
-    CWallet* const pwallet = wallet.get();
-
-    if (!EnsureWalletIsAvailable(pwallet, true)) {
+    std::shared_ptr<CWallet> wallet = GetWalletForJSONRPCRequest(request);
+    if (!EnsureWalletIsAvailable(wallet.get(), true)) {
         LogPrint(BCLog::HIVE, "BusyDwarves: Skipping hive check (wallet unavailable)\n");
-        return false;
+        return nullptr;
     }
-    if (pwallet->IsLocked()) {
+    if (wallet->IsLocked()) {
         LogPrint(BCLog::HIVE, "BusyDwarves: Skipping hive check, wallet is locked\n");
-        return false;
+        return nullptr;
     }
+    return wallet;
+}
 
-    LogPrintf("********************* Hive: Dwarves at work *********************\n");
+std::vector<CDwarfRange> GetMatureDwarfRanges(const std::vector<CDwarfCreationTransactionInfo>& dcts, bool fSpeculative, const Consensus::Params& consensusParams) {
+    std::vector<CDwarfRange> vRanges;
+    for (const CDwarfCreationTransactionInfo& dct : dcts) {
+        if (fSpeculative) {
+            bool fMatureNext = (dct.dwarfStatus == "mature" && dct.blocksLeft > 1) || dct.blocksLeft == consensusParams.dwarfLifespanBlocks + 1;
+            if (!fMatureNext)
+                continue;
+        } else if (dct.dwarfStatus != "mature")
+            continue;
+        vRanges.push_back({dct.txid, dct.rewardAddress, dct.communityContrib, 0, dct.dwarfCount});
+    }
+    return vRanges;
+}
+
+// Ring-fork: Hive: Check the wallet's dwarves against the hive target for a block on top of pindexPrev.
+// If fSpeculative, pindexPrev is a header one past the tip that isn't connected yet; the dwarves checked are the ones that
+// will be mature once it is.
+static HiveCheckResult FindHiveSolution(const Consensus::Params& consensusParams, const CBlockIndex* pindexPrev, bool fSpeculative, CWallet* pwallet, CDwarfRange& solvingRange, uint32_t& solvingDwarf) {
+    bool verbose = LogAcceptCategory(BCLog::HIVE);
+    int height = pindexPrev->nHeight;
+
+    // Check that there aren't too many Hive blocks since the last Pow block
+    int hiveBlocksSincePow = pindexPrev->GetHiveSincePow(consensusParams);
+    if (hiveBlocksSincePow >= consensusParams.maxConsecutiveHiveBlocks) {
+        LogPrintf("BusyDwarves: Skipping hive check (max Hive blocks without a POW block reached)\n");
+        return HIVE_CHECK_SKIPPED;
+    }
+
+    LogPrintf("********************* Hive: Dwarves at work%s *********************\n", fSpeculative ? " (speculative)" : "");
 
     // Find deterministicRandString
     std::string deterministicRandString = GetDeterministicRandString(pindexPrev);
@@ -917,21 +1339,16 @@ bool BusyDwarves(const Consensus::Params& consensusParams, int height) {
     dwarfHashTarget.SetCompact(GetNextHiveWorkRequired(pindexPrev, consensusParams));
     if (verbose) LogPrintf("BusyDwarves: dwarfHashTarget             = %s\n", dwarfHashTarget.ToString());
 
-    // Find bin size
-    std::vector<CDwarfCreationTransactionInfo> potentialDcts = pwallet->GetDCTs(false, false, consensusParams);
-    std::vector<CDwarfCreationTransactionInfo> dcts;
+    // Find mature DCTs. The wallet rates them against the connected tip; a speculative check is one block deeper, where DCTs in
+    // their last block are dead and DCTs in their last gestation block (blocksLeft is then the whole lifespan + 1) are mature.
+    std::vector<CDwarfRange> vRanges = GetMatureDwarfRanges(pwallet->GetDCTs(false, false, consensusParams), fSpeculative, consensusParams);
     int totalDwarves = 0;
-    for (std::vector<CDwarfCreationTransactionInfo>::const_iterator it = potentialDcts.begin(); it != potentialDcts.end(); it++) {
-        CDwarfCreationTransactionInfo dct = *it;
-        if (dct.dwarfStatus != "mature")
-            continue;
-        dcts.push_back(dct);
-        totalDwarves += dct.dwarfCount;
-    }
+    for (const CDwarfRange& range : vRanges)
+        totalDwarves += range.count;
 
     if (totalDwarves == 0) {
         LogPrint(BCLog::HIVE, "BusyDwarves: No mature dwarves found\n");
-        return false;
+        return HIVE_CHECK_SKIPPED;
     }
 
     int coreCount = GetNumCores();
@@ -943,100 +1360,75 @@ bool BusyDwarves(const Consensus::Params& consensusParams, int height) {
     else if (threadCount == 0)
         threadCount = 1;
 
-    int dwarvesPerBin = ceil(totalDwarves / (float)threadCount);  // We want to check this many dwarves per thread
-
-    // Bin the dwarves according to desired thead count
-    if (verbose) LogPrint(BCLog::HIVE, "BusyDwarves: Binning %i dwarves in %i bins (%i dwarves per bin)\n", totalDwarves, threadCount, dwarvesPerBin);
-    std::vector<CDwarfCreationTransactionInfo>::const_iterator dctIterator = dcts.begin();
-    CDwarfCreationTransactionInfo dct = *dctIterator;
-    std::vector<std::vector<CDwarfRange>> dwarfBins;
-    int dwarfOffset = 0;                                    // Track offset in current DCT
-    while(dctIterator != dcts.end()) {                      // Until we're out of DCTs
-        std::vector<CDwarfRange> currentBin;                // Create a new bin
-        int dwarvesInBin = 0;
-        while (dctIterator != dcts.end()) {                 // Keep filling it until full
-            int spaceLeft = dwarvesPerBin - dwarvesInBin;
-            if (dct.dwarfCount - dwarfOffset <= spaceLeft) {  // If there's room, add all the dwarves from this DCT...
-                CDwarfRange range = {dct.txid, dct.rewardAddress, dct.communityContrib, dwarfOffset, dct.dwarfCount - dwarfOffset};
-                currentBin.push_back(range);
-
-                dwarvesInBin += dct.dwarfCount - dwarfOffset;
-                dwarfOffset = 0;
-
-                do {                                        // ... and iterate to next DCT
-                    dctIterator++;
-                    if (dctIterator == dcts.end())
-                        break;
-                    dct = *dctIterator;
-                } while (dct.dwarfStatus != "mature");
-            } else {                                        // Can't fit the whole thing to current bin; add what we can fit and let the rest go in next bin
-                CDwarfRange range = {dct.txid, dct.rewardAddress, dct.communityContrib, dwarfOffset, spaceLeft};
-                currentBin.push_back(range);
-                dwarfOffset += spaceLeft;
-                break;
-            }
-        }
-        dwarfBins.push_back(currentBin);
-    }
-
-    // Create a worker thread for each bin
-    if (verbose) LogPrintf("BusyDwarves: Running bins\n");
-    solutionFound.store(false);
-    earlyAbort.store(false);
-    std::vector<std::vector<CDwarfRange>>::const_iterator dwarfBinIterator = dwarfBins.begin();
-    std::vector<boost::thread> binThreads;
+    // Publish a job covering all mature dwarves to the check pool
+    if (verbose) LogPrintf("BusyDwarves: Checking %i dwarves from %i DCTs with %i threads, %i dwarves at a time\n", totalDwarves, vRanges.size(), threadCount, HIVE_CHECK_CHUNK_SIZE);
     int64_t checkTime = GetTimeMillis();
-    int binID = 0;
-    while (dwarfBinIterator != dwarfBins.end()) {
-        std::vector<CDwarfRange> dwarfBin = *dwarfBinIterator;
-
-        if (verbose) {
-            LogPrintf("BusyDwarves: Bin #%i\n", binID);
-            std::vector<CDwarfRange>::const_iterator dwarfRangeIterator = dwarfBin.begin();
-            while (dwarfRangeIterator != dwarfBin.end()) {
-                CDwarfRange dwarfRange = *dwarfRangeIterator;
-                LogPrintf("offset = %i, count = %i, txid = %s\n", dwarfRange.offset, dwarfRange.count, dwarfRange.txid);
-                dwarfRangeIterator++;
+    CHiveRoundStats stats;
+    stats.nHeight = height + 1;
+    stats.fSpeculative = fSpeculative;
+    stats.nTime = GetTime();
+    stats.nDwarvesScheduled = totalDwarves;
+    stats.nThreads = threadCount;
+    stats.nAbortMicros = -1;
+    stats.nSubmitMicros = -1;
+    stats.fAccepted = false;
+    int64_t nStartMicros = GetTimeMicros();
+    std::shared_ptr<CHiveCheckJob> job = PublishHiveCheckJob(deterministicRandString, dwarfHashTarget, vRanges, threadCount);
+
+    // Wait for the pool to find a solution or run out of dwarves. With -hiveearlyout, a new tip or a competing block
+    // cancels the job meanwhile (see HiveNotifier).
+    bool useEarlyAbort = gArgs.GetBoolArg("-hiveearlyout", DEFAULT_HIVE_EARLY_OUT);
+    if (useEarlyAbort) {
+        bool fTipMoved;
+        {
+            LOCK(cs_hiveTip);
+            fTipMoved = IsHiveRoundStaleOnTip(pindexPrev, fSpeculative, pindexHiveTip);
+            if (!fTipMoved) {
+                pindexHiveRound = pindexPrev;
+                fHiveRoundSpeculative = fSpeculative;
             }
         }
-        binThreads.push_back(boost::thread(CheckBin, binID++, dwarfBin, deterministicRandString, dwarfHashTarget));   // Spawn the thread
-
-        dwarfBinIterator++;
+        if (fTipMoved)                                          // Tip moved before the round was abortable
+            CancelHiveCheck();
+    }
+    HiveCheckResult result;
+    try {
+        result = WaitHiveCheckJob(*job, solvingRange, solvingDwarf);
+    } catch (const boost::thread_interrupted&) {
+        EndHiveRound();
+        nHiveCheckGeneration++;
+        throw;
+    }
+    EndHiveRound();
+
+    int64_t nEndMicros = GetTimeMicros();
+    stats.result = result;
+    stats.nDwarvesChecked = std::min(job->nHashed.load(), totalDwarves);
+    stats.nCheckMicros = nEndMicros - nStartMicros;
+    if (result == HIVE_CHECK_ABORTED)
+        stats.nAbortMicros = std::max(nEndMicros - std::max(nHiveCheckCancelTime.load(), nStartMicros), (int64_t)0);
+    RecordHiveRound(stats);
+
+    if (result == HIVE_CHECK_ABORTED) {
+        LogPrintf("BusyDwarves: Chain state changed (check aborted after %ims)\n", GetTimeMillis() - checkTime);
+        return HIVE_CHECK_ABORTED;
     }
-
-    // Add an extra thread to watch external abort conditions (eg new incoming block)
-    bool useEarlyAbortThread = gArgs.GetBoolArg("-hiveearlyout", DEFAULT_HIVE_EARLY_OUT);
-    if (verbose && useEarlyAbortThread)
-        LogPrintf("BusyDwarves: Will use early-abort thread\n");
-
-    boost::thread* earlyAbortThread;
-    if (useEarlyAbortThread)
-        earlyAbortThread = new boost::thread(AbortWatchThread, height);
-
-    // Wait for bin worker threads to find a solution or abort (in which case the others will all stop), or to run out of dwarves
-    for(auto& t:binThreads)
-        t.join();
 
     checkTime = GetTimeMillis() - checkTime;
 
-    // Handle early aborts
-    if (useEarlyAbortThread) {
-        if (earlyAbort.load()) {
-            LogPrintf("BusyDwarves: Chain state changed (check aborted after %ims)\n", checkTime);
-            return false;
-        } else {
-            // We didn't abort; stop abort thread now
-            earlyAbort.store(true);
-            earlyAbortThread->join();
-        }
-    }
-
     // Check if a solution was found
-    if (!solutionFound.load()) {
+    if (result != HIVE_CHECK_SOLVED) {
         LogPrintf("BusyDwarves: No dwarf meets hash target (%i dwarves checked with %i threads in %ims)\n", totalDwarves, threadCount, checkTime);
-        return false;
+        return HIVE_CHECK_NONE;
     }
     LogPrintf("BusyDwarves: Dwarf meets hash target (check aborted after %ims). Solution with dwarf #%i from BCT %s. Honey address is %s.\n", checkTime, solvingDwarf, solvingRange.txid, solvingRange.rewardAddress);
+    return HIVE_CHECK_SOLVED;
+}
+
+// Ring-fork: Hive: Build, sign and submit a hive block on top of the tip pindexPrev, from a dwarf that meets the target
+static bool MintHiveBlock(const CBlockIndex* pindexPrev, CWallet* pwallet, const CDwarfRange& solvingRange, uint32_t solvingDwarf) {
+    bool verbose = LogAcceptCategory(BCLog::HIVE);
+    std::string deterministicRandString = GetDeterministicRandString(pindexPrev);
 
     // Assemble the Hive proof script
     std::vector<unsigned char> messageProofVec;
@@ -1120,12 +1512,267 @@ bool BusyDwarves(const Consensus::Params& consensusParams, int height) {
     }
 
     // Commit and propagate the block
+    int64_t nSubmitMicros = -1;
+    {
+        LOCK(cs_hiveTip);
+        if (pindexHiveTip == pindexPrev)
+            nSubmitMicros = GetTimeMicros() - nHiveTipTime;
+    }
     std::shared_ptr<const CBlock> shared_pblock = std::make_shared<const CBlock>(*pblock);
-    if (!ProcessNewBlock(Params(), shared_pblock, true, nullptr)) {
+    bool fAccepted = ProcessNewBlock(Params(), shared_pblock, true, nullptr);
+    RecordHiveSubmit(pindexPrev->nHeight + 1, nSubmitMicros, fAccepted);
+    if (!fAccepted) {
         LogPrintf("BusyDwarves: Block wasn't accepted\n");
         return false;
     }
 
     LogPrintf("BusyDwarves: ** Block mined\n");
     return true;
-}
\ No newline at end of file
+}
+// Ring-fork: Hive: Attempt to mint the next block
+bool BusyDwarves(const Consensus::Params& consensusParams, int height) {
+    const CBlockIndex* pindexPrev;
+    {
+        LOCK(cs_main);
+        pindexPrev = chainActive.Tip();
+    }
+    assert(pindexPrev != nullptr);
+
+    std::shared_ptr<CWallet> wallet = GetHiveWallet(consensusParams, height);
+    if (!wallet)
+        return false;
+
+    CDwarfRange solvingRange;
+    uint32_t solvingDwarf;
+    if (FindHiveSolution(consensusParams, pindexPrev, false, wallet.get(), solvingRange, solvingDwarf) != HIVE_CHECK_SOLVED)
+        return false;
+    return MintHiveBlock(pindexPrev, wallet.get(), solvingRange, solvingDwarf);
+}
+
+// Ring-fork: Hive: Speculative hive checking (-hivespeculative). As soon as a header one past the tip is accepted, check dwarves
+// against it, since the rand string and hive target only depend on headers. The result is used once that block connects.
+struct CHiveSpeculation
+{
+    const CBlockIndex* pindexPrev = nullptr;        // Header the check was for
+    HiveCheckResult result = HIVE_CHECK_SKIPPED;
+    CDwarfRange solvingRange;
+    uint32_t solvingDwarf = 0;
+};
+
+static const CBlockIndex* pindexHiveCandidate GUARDED_BY(cs_hiveTip) = nullptr;
+static std::atomic<bool> fHiveSpeculative(false);
+
+// Ring-fork: Hive: A new best header on the round's tip means a competing block is on its way, so the round is cancelled
+// without waiting for the block. With -hivespeculative, a header one past the tip is also the next candidate to check.
+static void HiveHeaderTip(bool fInitialDownload, const CBlockIndex* pindexHeader) {
+    if (fInitialDownload)
+        return;
+
+    CancelStaleHiveRound(pindexHeader);
+
+    if (!fHiveSpeculative.load())
+        return;
+    {
+        LOCK(cs_hiveTip);
+        if (!pindexHiveTip || pindexHeader->pprev != pindexHiveTip)
+            return;
+        pindexHiveCandidate = pindexHeader;
+    }
+    cvHiveTip.notify_all();
+}
+
+// Ring-fork: Hive: Dwarf management thread
+void DwarfMaster(const CChainParams& chainparams) {
+    const Consensus::Params& consensusParams = chainparams.GetConsensus();
+
+    LogPrintf("DwarfMaster: Thread started\n");
+    RenameThread("hive-dwarfmaster");
+
+    const CBlockIndex* pindexTip;
+    {
+        LOCK(cs_main);
+        pindexTip = chainActive.Tip();
+    }
+    {
+        LOCK(cs_hiveTip);
+        pindexHiveTip = pindexTip;
+        nHiveTipTime = GetTimeMicros();
+        pindexHiveCandidate = nullptr;
+    }
+    if (!hiveNotifier)
+        hiveNotifier = MakeUnique<HiveNotifier>();
+    RegisterValidationInterface(hiveNotifier.get());
+
+    fHiveSpeculative.store(gArgs.GetBoolArg("-hivespeculative", DEFAULT_HIVE_SPECULATIVE));
+    boost::signals2::connection headerTipConnection = uiInterface.NotifyHeaderTip_connect(HiveHeaderTip);
+    CHiveSpeculation speculation;
+
+    try {
+        while (true) {
+            // Wait for the tip to change, or a candidate for the next tip to check speculatively
+            const CBlockIndex* pindexCandidate = nullptr;
+            {
+                WAIT_LOCK(cs_hiveTip, lock);
+                while (pindexHiveTip == pindexTip && (!pindexHiveCandidate || pindexHiveCandidate == speculation.pindexPrev)) {
+                    cvHiveTip.wait_for(lock, std::chrono::milliseconds(500));
+                    boost::this_thread::interruption_point();
+                }
+                if (pindexHiveTip != pindexTip)
+                    pindexTip = pindexHiveTip;
+                else
+                    pindexCandidate = pindexHiveCandidate;
+            }
+
+            try {
+                if (pindexCandidate) {
+                    // Check against the candidate while its block downloads and connects
+                    speculation = CHiveSpeculation();
+                    speculation.pindexPrev = pindexCandidate;
+                    std::shared_ptr<CWallet> wallet = GetHiveWallet(consensusParams, pindexCandidate->nHeight);
+                    if (wallet)
+                        speculation.result = FindHiveSolution(consensusParams, pindexCandidate, true, wallet.get(), speculation.solvingRange, speculation.solvingDwarf);
+                    continue;
+                }
+
+                // Tip changed; use the speculative result if it was for this tip, otherwise release the dwarves!
+                if (speculation.pindexPrev == pindexTip && (speculation.result == HIVE_CHECK_SOLVED || speculation.result == HIVE_CHECK_NONE)) {
+                    LogPrint(BCLog::HIVE, "DwarfMaster: Using speculative hive check for %s\n", pindexTip->GetBlockHash().ToString());
+                    std::shared_ptr<CWallet> wallet = GetHiveWallet(consensusParams, pindexTip->nHeight);
+                    if (wallet && speculation.result == HIVE_CHECK_SOLVED)
+                        MintHiveBlock(pindexTip, wallet.get(), speculation.solvingRange, speculation.solvingDwarf);
+                } else {
+                    BusyDwarves(consensusParams, pindexTip->nHeight);
+                }
+                speculation = CHiveSpeculation();
+            } catch (const std::runtime_error &e) {
+                LogPrintf("! DwarfMaster: Error: %s\n", e.what());
+            }
+        }
+    } catch (const boost::thread_interrupted&) {
+        headerTipConnection.disconnect();
+        UnregisterValidationInterface(hiveNotifier.get());
+        StopHiveCheckThreads();
+        LogPrintf("!!! DwarfMaster: FATAL: Thread interrupted\n");
+        throw;
+    }
+}
+
+// Ring-fork: Pop: Headless solver. Picks the most pressing unclaimed game available to the wallet (private games first, as
+// only we can claim them, then those whose claim window closes soonest), searches for a solution meeting the current score
+// target with SolveGame0, and submits it. Each game gets up to -popsolvetime seconds, and its search is abandoned as soon
+// as its claim window closes or someone else claims it. Games that couldn't be solved aren't retried until the target drops.
+void PopSolver(const CChainParams& chainparams) {
+    const Consensus::Params& consensusParams = chainparams.GetConsensus();
+    bool verbose = LogAcceptCategory(BCLog::POP);
+
+    LogPrintf("PopSolver: Thread started\n");
+    RenameThread("pop-solver");
+
+    int coreCount = GetNumCores();
+    int threadCount = gArgs.GetArg("-popsolvethreads", DEFAULT_POP_SOLVE_THREADS);
+    if (threadCount == -2)
+        threadCount = std::max(1, coreCount - 1);
+    else if (threadCount < 0 || threadCount > coreCount)
+        threadCount = coreCount;
+    else if (threadCount == 0)
+        threadCount = 1;
+    int beamWidth = gArgs.GetArg("-popsolvebeam", DEFAULT_POP_SOLVE_BEAM_WIDTH);
+    int64_t maxSolveMillis = gArgs.GetArg("-popsolvetime", DEFAULT_POP_SOLVE_TIME) * 1000;
+
+    std::map<uint256, int> mapUnsolved;                     // Games searched without success, and the target they were searched for
+
+    try {
+        while (true) {
+            MilliSleep(1000);
+            boost::this_thread::interruption_point();
+
+            if (!g_connman || g_connman->GetNodeCount(CConnman::CONNECTIONS_ALL) == 0 || IsInitialBlockDownload())
+                continue;
+
+            JSONRPCRequest request;
+            std::shared_ptr<CWallet> wallet = GetWalletForJSONRPCRequest(request);
+            if (!EnsureWalletIsAvailable(wallet.get(), true))
+                continue;
+
+            std::vector<CAvailableGame> games = wallet->GetAvailableGames(consensusParams);
+            int tipHeight, targetScore;
+            {
+                LOCK(cs_main);
+                tipHeight = chainActive.Height();
+                targetScore = GetNextPopScoreRequired(chainActive.Tip(), consensusParams);
+            }
+
+            // Forget games no longer available, and pick the most pressing of the rest
+            std::map<uint256, int> mapStillUnsolved;
+            const CAvailableGame* game = nullptr;
+            for (const CAvailableGame& candidate : games) {
+                auto it = mapUnsolved.find(candidate.gameSourceHash);
+                if (it != mapUnsolved.end()) {
+                    mapStillUnsolved.insert(*it);
+                    if (targetScore >= it->second)
+                        continue;
+                }
+                if (candidate.blocksRemaining <= 0 || (candidate.isPrivate && wallet->IsLocked()))
+                    continue;
+                if (!game || (candidate.isPrivate && !game->isPrivate)
+                    || (candidate.isPrivate == game->isPrivate && candidate.blocksRemaining < game->blocksRemaining))
+                    game = &candidate;
+            }
+            mapUnsolved.swap(mapStillUnsolved);
+            if (!game)
+                continue;
+
+            // The claim has to make it into a block no deeper than the window allows
+            const uint256 gameSourceHash = game->gameSourceHash;
+            const int closeHeight = tipHeight + game->blocksRemaining;
+            int sourceHeight;
+            {
+                LOCK(cs_main);
+                const CBlockIndex* pindexSource = LookupBlockIndex(gameSourceHash);
+                if (!pindexSource)
+                    continue;
+                sourceHeight = pindexSource->nHeight;
+            }
+
+            if (verbose)
+                LogPrintf("PopSolver: Solving %s game %s for target %i with %i threads, %i blocks remaining\n", game->isPrivate ? "private" : "public", gameSourceHash.ToString(), targetScore, threadCount, game->blocksRemaining);
+            int64_t startTime = GetTimeMillis();
+            std::string stopReason;
+            auto fnInterrupt = [&]() {
+                if (boost::this_thread::interruption_requested() || ShutdownRequested())
+                    stopReason = "shutting down";
+                else if (GetTimeMillis() - startTime > maxSolveMillis)
+                    stopReason = "out of time";
+                else {
+                    LOCK(cs_main);
+                    if (chainActive.Height() >= closeHeight)
+                        stopReason = "claim window closed";
+                    else if (FindGameClaim(gameSourceHash, sourceHeight, chainActive.Tip(), consensusParams))
+                        stopReason = "claimed elsewhere";
+                }
+                return !stopReason.empty();
+            };
+            Game0SolverResult result = SolveGame0(gameSourceHash, targetScore, threadCount, beamWidth, fnInterrupt);
+            boost::this_thread::interruption_point();
+
+            LogPrint(BCLog::POP, "PopSolver: Searched %u positions in %i passes, %i ms; best score %i of %i%s%s\n", result.nPositions, result.nPasses, GetTimeMillis() - startTime, result.nScore, targetScore, stopReason.empty() ? "" : "; stopped: ", stopReason);
+            if (!result.fSolved) {
+                if (stopReason.empty() || stopReason == "out of time")
+                    mapUnsolved[gameSourceHash] = targetScore;
+                continue;
+            }
+
+            CAvailableGame solvedGame = *game;
+            std::string strFailReason;
+            if (wallet->SubmitSolution(&solvedGame, 0, result.solution, strFailReason)) {
+                LogPrintf("PopSolver: Submitted solution for game %s with score %i\n", gameSourceHash.ToString(), result.nScore);
+            } else {
+                LogPrintf("PopSolver: Couldn't submit solution for game %s: %s\n", gameSourceHash.ToString(), strFailReason);
+                mapUnsolved[gameSourceHash] = targetScore;
+            }
+        }
+    } catch (const boost::thread_interrupted&) {
+        LogPrintf("PopSolver: Thread terminated\n");
+        throw;
+    }
+}
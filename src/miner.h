@@ -12,18 +12,21 @@
 #include <txmempool.h>
 #include <validation.h>
 
+#include <atomic>
 #include <memory>
 #include <stdint.h>
+#include <string>
+#include <vector>
 
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/ordered_index.hpp>
 
+class arith_uint256;
 class CBlockIndex;
 class CChainParams;
 class CScript;
-
-class arith_uint256;    // Ring-fork: Hive: Mining optimisations
-struct CDwarfRange;     // Ring-fork: Hive: Mining optimisations
+struct CDwarfCreationTransactionInfo;
+struct CDwarfRange;
 
 namespace Consensus { struct Params; };
 
@@ -36,6 +39,28 @@ static const bool DEFAULT_PRINTPRIORITY = false;
 static const int DEFAULT_HIVE_CHECK_DELAY = 1;
 static const int DEFAULT_HIVE_THREADS = -2;
 static const bool DEFAULT_HIVE_EARLY_OUT = true;
+static const bool DEFAULT_HIVE_SPECULATIVE = false;
+
+// Ring-fork: Pop: Defaults for the headless solver
+static const bool DEFAULT_POP_SOLVE = false;
+static const int DEFAULT_POP_SOLVE_THREADS = 1;
+static const int DEFAULT_POP_SOLVE_BEAM_WIDTH = 64;
+static const int DEFAULT_POP_SOLVE_TIME = 120;
+
+// Ring-fork: In-wallet miner: Telemetry for one miner thread, as sampled once a second
+struct CMinerThreadStats
+{
+    int nThread;
+    double dHashesPerSec1s;         // Hashrate over the last 1s, 10s and 60s (shorter if the miner started more recently)
+    double dHashesPerSec10s;
+    double dHashesPerSec60s;
+    uint64_t nHashes;               // Hashes done since the miner was started
+    uint64_t nNearTarget;           // Hashes within MINER_NEAR_TARGET_BITS of the block target since the miner was started
+    int64_t nTemplateAge;           // Seconds since the template the thread is mining was built, or -1 if it's idle
+};
+
+// Ring-fork: In-wallet miner: A hash counts as near target if it's within 2^MINER_NEAR_TARGET_BITS of the block target
+static const unsigned int MINER_NEAR_TARGET_BITS = 8;
 
 struct CBlockTemplate
 {
@@ -218,12 +243,69 @@ void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned
 int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParams, const CBlockIndex* pindexPrev);
 
 void MineCoins(bool fGenerate, int nThreads, const CChainParams& chainparams);  // Ring-fork: In-wallet miner: Run miner threads
-extern double dHashesPerSec;                                                    // Ring-fork: In-wallet miner: Measure hashrate
-extern int64_t nHPSTimerStart;                                                  // Ring-fork: In-wallet miner: Measure hashrate
+double GetMinerHashesPerSec();                                                  // Ring-fork: In-wallet miner: Measure hashrate
+std::vector<CMinerThreadStats> GetMinerThreadStats();                           // Ring-fork: In-wallet miner: Measure hashrate per thread
+
+/**
+ * Ring-fork: In-wallet miner: Hash pblock with the nonces after nNonce until one meets hashTarget (returning true, with pblock,
+ * nNonce and phash set to it) or the scan pauses. Each hash is counted in nHashes, and in nNearTarget if it's within
+ * MINER_NEAR_TARGET_BITS of the target. Used by the miner threads, which pass the id of the job they're mining.
+ */
+bool ScanHash(CBlockHeader *pblock, uint32_t& nNonce, uint256 *phash, const arith_uint256& hashTarget, std::atomic<uint64_t>& nHashes, std::atomic<uint64_t>& nNearTarget, uint64_t nJobId);
 
 void DwarfMaster(const CChainParams& chainparams);                              // Ring-fork: Hive: Bee management thread
 bool BusyDwarves(const Consensus::Params& consensusParams, int height);         // Ring-fork: Hive: Attempt to mint the next block
-void CheckBin(int threadID, std::vector<CDwarfRange> bin, std::string deterministicRandString, arith_uint256 dwarfHashTarget); // Ring-fork: Hive: Mining optimisations: Thread to process a bin of beeranges
-void AbortWatchThread(int height);                                              // Ring-fork: Hive: Mining optimisations: Thread to watch for abort conditions
+void PopSolver(const CChainParams& chainparams);                                // Ring-fork: Pop: Headless solver thread
+
+// Ring-fork: Hive: Outcome of checking dwarves against the hive target
+enum HiveCheckResult {
+    HIVE_CHECK_SKIPPED,         // Nothing to check
+    HIVE_CHECK_ABORTED,         // Cancelled by a chain state change
+    HIVE_CHECK_NONE,            // Every dwarf checked; none meets the target
+    HIVE_CHECK_SOLVED,
+};
+
+/** Ring-fork: Hive: The dwarves that can mine the block after the tip (or, if fSpeculative, the block after that), one range per DCT */
+std::vector<CDwarfRange> GetMatureDwarfRanges(const std::vector<CDwarfCreationTransactionInfo>& dcts, bool fSpeculative, const Consensus::Params& consensusParams);
+
+/**
+ * Ring-fork: Hive: Mining optimisations: Check the dwarves in vRanges against the hive target on the hive check pool, started
+ * with nThreads workers, and wait until one meets it, they run out or the check is cancelled. BusyDwarves drives the pool
+ * itself; this is for callers standing in for it (eg benchmarks), so mustn't be used while DwarfMaster is running.
+ */
+HiveCheckResult CheckHiveDwarves(const std::string& deterministicRandString, const arith_uint256& dwarfHashTarget, const std::vector<CDwarfRange>& vRanges, int nThreads, CDwarfRange& solvingRange, uint32_t& solvingDwarf);
+void CancelHiveCheck();                                                         // Ring-fork: Hive: Cancel the hive check in progress
+bool GetHiveCheckProgress(int& nClaimed, int& nChecked);                        // Ring-fork: Hive: Dwarves claimed by workers and checked so far; false if no check is in progress
+void StopHiveCheckThreads();                                                    // Ring-fork: Hive: Cancel any hive check and stop the check pool
+
+/**
+ * Ring-fork: Hive: Mining optimisations: Whether a round checking dwarves for the block on top of pindexRoundPrev is stale
+ * once pindexTip becomes the tip. A speculative round builds on a header one past the tip, so it isn't stale until a tip
+ * other than that header or its parent arrives.
+ */
+bool IsHiveRoundStaleOnTip(const CBlockIndex* pindexRoundPrev, bool fSpeculative, const CBlockIndex* pindexTip);
+/** Ring-fork: Hive: Mining optimisations: Whether a round building on pindexRoundPrev is stale once pindexBlock's header or block is seen */
+bool IsHiveRoundStaleOnBlock(const CBlockIndex* pindexRoundPrev, const CBlockIndex* pindexBlock);
+
+// Ring-fork: Hive: Mining optimisations: Telemetry for one hive check round, as kept for gethivemininginfo
+struct CHiveRoundStats
+{
+    int nHeight;                    // Height of the block the round tried to mine
+    bool fSpeculative;              // Checked against a header before its block connected
+    int64_t nTime;                  // Unix time the round started
+    HiveCheckResult result;         // HIVE_CHECK_SOLVED, HIVE_CHECK_NONE or HIVE_CHECK_ABORTED
+    int nDwarvesScheduled;          // Mature dwarves published to the check pool
+    int nDwarvesChecked;            // Dwarves hashed by the time the round ended
+    int nThreads;
+    int64_t nCheckMicros;           // Wall time from publishing the dwarves to the round ending
+    int64_t nAbortMicros;           // Time from the round being cancelled to it ending, or -1 if it wasn't aborted
+    int64_t nSubmitMicros;          // Time from the tip arriving to our hive block reaching ProcessNewBlock, or -1 if none was submitted
+    bool fAccepted;                 // Whether the submitted block was accepted
+};
+
+// Ring-fork: Hive: Mining optimisations: Rounds kept in the history
+static const size_t HIVE_ROUND_HISTORY_SIZE = 100;
+
+std::vector<CHiveRoundStats> GetHiveRoundStats();                               // Ring-fork: Hive: Recent hive check rounds, oldest first
 
 #endif // RING_MINER_H
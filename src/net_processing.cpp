@@ -1386,7 +1386,7 @@ bool static ProcessHeadersMessage(CNode *pfrom, CConnman *connman, const std::ve
         //   don't connect before giving DoS points
         // - Once a headers message is received that is valid and does connect,
         //   nUnconnectingHeaders gets reset back to 0.
-        if (!LookupBlockIndex(headers[0].hashPrevBlock) && nCount < MAX_BLOCKS_TO_ANNOUNCE) {
+        if (!LookupBlockIndex(headers[0].hashPrevBlock) && !IsHeaderPowPending(headers[0].hashPrevBlock) && nCount < MAX_BLOCKS_TO_ANNOUNCE) {    // Ring-fork: Held headers connect too
             nodestate->nUnconnectingHeaders++;
             connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::GETHEADERS, chainActive.GetLocator(pindexBestHeader), uint256()));
             LogPrint(BCLog::NET, "received header %s: missing prev block %s, sending getheaders (%d) to end (peer=%d, nUnconnectingHeaders=%d)\n",
@@ -1479,6 +1479,21 @@ bool static ProcessHeadersMessage(CNode *pfrom, CConnman *connman, const std::ve
         nodestate->nUnconnectingHeaders = 0;
 
         assert(pindexLast);
+
+        // Ring-fork: The headers were held back until they're known to lead to a checkpoint, so there's no block index entry
+        // for them yet; carry on syncing from the last of them
+        const uint256 hashLastHeader = headers.back().GetHash();
+        if (pindexLast->GetBlockHash() != hashLastHeader && IsHeaderPowPending(hashLastHeader)) {
+            UpdateBlockAvailability(pfrom->GetId(), hashLastHeader);
+            if (nCount == MAX_HEADERS_RESULTS) {
+                CBlockLocator locator = chainActive.GetLocator(pindexLast);
+                locator.vHave.insert(locator.vHave.begin(), hashLastHeader);
+                LogPrint(BCLog::NET, "more getheaders (%d held) to end to peer=%d (startheight:%d)\n", pindexLast->nHeight, pfrom->GetId(), pfrom->nStartingHeight);
+                connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::GETHEADERS, locator, uint256()));
+            }
+            return true;
+        }
+
         UpdateBlockAvailability(pfrom->GetId(), pindexLast->GetBlockHash());
 
         // From here, pindexBestKnownBlock should be guaranteed to be non-null,
@@ -19,7 +19,9 @@
 #include <util/strencodings.h>  // Ring-fork: Hive
 #include <logging.h>            // Ring-fork: Hive
 #include <key_io.h>             // Ring-fork: Hive
-#include <crypto/pop/game0/game0.h>   // Ring-fork: Pop
+#include <crypto/pop/game0/game0bitboard.h>   // Ring-fork: Pop
+#include <crypto/pow/minotaur.h>      // Ring-fork: Hive
+#include <index/hiveindex.h>         // Ring-fork: Hive
 
 DwarfPopGraphPoint dwarfPopGraph[1024*40];       // Ring-fork: Hive
 
@@ -42,11 +44,7 @@ unsigned int GetNextWorkRequired(const CBlockIndex* pindexLast, const CBlockHead
 
     // Ring-fork: Hive: Skip over Hivemined blocks at tip
     // Ring-fork: Pop: Skip over pop blocks at tip too
-    while (pindexLast->GetBlockHeader().IsHiveMined(params) || pindexLast->GetBlockHeader().IsPopMined(params)) {
-        //LogPrintf("Skipping hivemined block at %i\n", pindex->nHeight);
-        assert(pindexLast->pprev); // should never fail
-        pindexLast = pindexLast->pprev;
-    }
+    pindexLast = pindexLast->GetLastPow(params);
 
     const CBlockIndex *pindex = pindexLast;
     arith_uint256 bnPastTargetAvg;
@@ -54,11 +52,7 @@ unsigned int GetNextWorkRequired(const CBlockIndex* pindexLast, const CBlockHead
     for (unsigned int i = 1; i <= nPastBlocks; i++) {
         // Ring-fork: Hive: Skip over Hivemined blocks; we only want to consider PoW blocks
         // Ring-fork: Pop: Skip over pop blocks too
-        while (pindex->GetBlockHeader().IsHiveMined(params) || pindex->GetBlockHeader().IsPopMined(params)) {
-            //LogPrintf("Skipping popmined block at %i\n", pindex->nHeight);
-            assert(pindex->pprev); // should never fail
-            pindex = pindex->pprev;
-        }
+        pindex = pindex->GetLastPow(params);
 
         arith_uint256 bnTarget = arith_uint256().SetCompact(pindex->nBits);
         bnPastTargetAvg += bnTarget/nPastBlocks;    // Simple moving average
@@ -95,7 +89,7 @@ int GetNextPopScoreRequired(const CBlockIndex* pindexLast, const Consensus::Para
 
     int score = 0;
     for (int i = 0; i < params.popScoreAdjustWindowSize; i++) {
-        if (pindexLast->GetBlockHeader().IsPopMined(params))
+        if (pindexLast->IsPopMined(params))
             score++;
 
         assert (pindexLast->pprev);
@@ -111,29 +105,40 @@ int GetNextPopScoreRequired(const CBlockIndex* pindexLast, const Consensus::Para
 
 // Ring-fork: Hive: SMA Hive Difficulty Adjust
 unsigned int GetNextHiveWorkRequired(const CBlockIndex* pindexLast, const Consensus::Params& params) {
+    // Cached on the block index with its chain context
+    unsigned int nBits = pindexLast->nNextHiveBits ? pindexLast->nNextHiveBits : CalculateNextHiveWorkRequired(pindexLast, params);
+
+    if (LogAcceptCategory(BCLog::HIVE) && !pindexLast->GetLastHive(params))     // Should only happen when chain is starting
+        LogPrintf("GetNextHiveWorkRequired: No previous hive blocks found.\n");
+    return nBits;
+}
+
+unsigned int CalculateNextHiveWorkRequired(const CBlockIndex* pindexLast, const Consensus::Params& params) {
     const arith_uint256 bnPowLimit = UintToArith256(params.powLimitHive);
 
     arith_uint256 dwarfHashTarget = 0;
     int hiveBlockCount = 0;
     int totalBlockCount = 0;
 
-    // Step back till we have found 24 hive blocks, or we ran out...
-    while (hiveBlockCount < params.hiveDifficultyWindow && pindexLast->pprev && pindexLast->nHeight >= params.minHiveCheckBlock) {
-        if (pindexLast->GetBlockHeader().IsHiveMined(params)) {
-            dwarfHashTarget += arith_uint256().SetCompact(pindexLast->nBits);
+    // Step back till we have found 24 hive blocks, or we ran out (stopping short of genesis and of minHiveCheckBlock).
+    // Only the hive blocks are visited, through the chain context; non-pop blocks stepped over are counted from the pop totals.
+    const int lowestHeight = std::max(params.minHiveCheckBlock, 1);
+    const CBlockIndex* pindexStop = pindexLast;     // The first block not stepped over
+    if (pindexLast->nHeight >= lowestHeight) {
+        const CBlockIndex* pindexHive = pindexLast->GetLastHive(params);
+        while (hiveBlockCount < params.hiveDifficultyWindow && pindexHive && pindexHive->nHeight >= lowestHeight) {
+            dwarfHashTarget += arith_uint256().SetCompact(pindexHive->nBits);
             hiveBlockCount++;
+            pindexStop = pindexHive->pprev;
+            pindexHive = pindexStop->GetLastHive(params);
         }
-        if (!pindexLast->GetBlockHeader().IsPopMined(params))
-            totalBlockCount++;
-
-        pindexLast = pindexLast->pprev;
+        if (hiveBlockCount < params.hiveDifficultyWindow)
+            pindexStop = pindexLast->GetAncestor(lowestHeight - 1);
     }
+    totalBlockCount = (pindexLast->nHeight - pindexStop->nHeight) - (pindexLast->GetChainPopBlocks(params) - pindexStop->GetChainPopBlocks(params));
 
-    if (hiveBlockCount == 0) {          // Should only happen when chain is starting
-        if (LogAcceptCategory(BCLog::HIVE))
-            LogPrintf("GetNextHiveWorkRequired: No previous hive blocks found.\n");
+    if (hiveBlockCount == 0)            // Should only happen when chain is starting
         return bnPowLimit.GetCompact();
-    }
 
     dwarfHashTarget /= hiveBlockCount;    // Average the dwarf hash targets in window
 
@@ -167,6 +172,35 @@ bool CheckProofOfWork(uint256 hash, unsigned int nBits, const Consensus::Params&
     return true;
 }
 
+// Ring-fork: Hive: Count the DCTs in a block and the dwarves they create
+void CountBlockDwarves(const CBlock& block, int nHeight, const Consensus::Params& consensusParams, int& nDCTs, int& nDwarves) {
+    nDCTs = nDwarves = 0;
+
+    if (block.IsHiveMined(consensusParams)      // Don't check Hivemined blocks (no DCTs will be found in them)
+        || block.IsPopMined(consensusParams)    // Ring-fork: Pop: Same for pop blocks
+    )
+        return;
+
+    CScript scriptPubKeyBCF = GetScriptForDestination(DecodeDestination(consensusParams.dwarfCreationAddress));
+    CScript scriptPubKeyCF = GetScriptForDestination(DecodeDestination(consensusParams.hiveCommunityAddress));
+    CAmount dwarfCost = GetDwarfCost(nHeight, consensusParams);
+
+    for(const auto& tx : block.vtx) {
+        CAmount dwarfFeePaid;
+        if (tx->IsDCT(consensusParams, scriptPubKeyBCF, &dwarfFeePaid)) {               // If it's a DCT, total its dwarves
+            if (tx->vout.size() > 1 && tx->vout[1].scriptPubKey == scriptPubKeyCF) {    // If it has a community fund contrib...
+                CAmount donationAmount = tx->vout[1].nValue;
+                CAmount expectedDonationAmount = (dwarfFeePaid + donationAmount) / consensusParams.communityContribFactor;  // ...check for valid donation amount
+                if (donationAmount != expectedDonationAmount)
+                    continue;
+                dwarfFeePaid += donationAmount;                                           // Add donation amount back to total paid
+            }
+            nDwarves += dwarfFeePaid / dwarfCost;
+            nDCTs++;
+        }
+    }
+}
+
 // Ring-fork: Hive: Get count of all live and gestating DCTs on the network
 bool GetNetworkHiveInfo(int& immatureDwarves, int& immatureDCTs, int& matureDwarves, int& matureDCTs, CAmount& potentialLifespanRewards, const Consensus::Params& consensusParams, bool recalcGraph) {
     int totalDwarfLifespan = consensusParams.dwarfLifespanBlocks + consensusParams.dwarfGestationBlocks;
@@ -187,11 +221,12 @@ bool GetNetworkHiveInfo(int& immatureDwarves, int& immatureDCTs, int& matureDwar
     if (IsInitialBlockDownload())   // Refuse if we're downloading
         return false;
 
+    // Answer from the hive index if it's caught up with the tip; it needs neither a scan nor block data
+    if (g_hiveindex && g_hiveindex->GetNetworkHiveInfo(pindexPrev, consensusParams, immatureDwarves, immatureDCTs, matureDwarves, matureDCTs, recalcGraph ? dwarfPopGraph : nullptr))
+        return true;
+
     // Count dwarves in next blockCount blocks
     CBlock block;
-    CScript scriptPubKeyBCF = GetScriptForDestination(DecodeDestination(consensusParams.dwarfCreationAddress));
-    CScript scriptPubKeyCF = GetScriptForDestination(DecodeDestination(consensusParams.hiveCommunityAddress));
-
     for (int i = 0; i < totalDwarfLifespan; i++) {
         // Don't keep checking before minHiveCheckBlock 
         if (pindexPrev->nHeight < consensusParams.minHiveCheckBlock)
@@ -202,62 +237,37 @@ bool GetNetworkHiveInfo(int& immatureDwarves, int& immatureDCTs, int& matureDwar
             return false;
         }
         
-        if (!pindexPrev->GetBlockHeader().IsHiveMined(consensusParams)      // Don't check Hivemined blocks (no DCTs will be found in them)
-            && !pindexPrev->GetBlockHeader().IsPopMined(consensusParams)    // Ring-fork: Pop: Same for pop blocks
+        if (!pindexPrev->IsHiveMined(consensusParams)      // Don't read Hivemined blocks (no DCTs will be found in them)
+            && !pindexPrev->IsPopMined(consensusParams)    // Ring-fork: Pop: Same for pop blocks
         ) {
             if (!ReadBlockFromDisk(block, pindexPrev, consensusParams, false)) {
                 LogPrintf("! GetNetworkHiveInfo: Warn: Block not available (not found on disk); can't calculate network dwarf count.");
                 return false;
             }
             int blockHeight = pindexPrev->nHeight;
-            CAmount dwarfCost = GetDwarfCost(blockHeight, consensusParams);
-            if (block.vtx.size() > 0) {
-                for(const auto& tx : block.vtx) {
-                    CAmount dwarfFeePaid;
-                    if (tx->IsDCT(consensusParams, scriptPubKeyBCF, &dwarfFeePaid)) {               // If it's a DCT, total its dwarves
-                        if (tx->vout.size() > 1 && tx->vout[1].scriptPubKey == scriptPubKeyCF) {    // If it has a community fund contrib...
-                            CAmount donationAmount = tx->vout[1].nValue;
-                            CAmount expectedDonationAmount = (dwarfFeePaid + donationAmount) / consensusParams.communityContribFactor;  // ...check for valid donation amount
-                            if (donationAmount != expectedDonationAmount)
-                                continue;
-                            dwarfFeePaid += donationAmount;                                           // Add donation amount back to total paid
-                        }
-                        int dwarfCount = dwarfFeePaid / dwarfCost;
-                        if (i < consensusParams.dwarfGestationBlocks) {
-                            immatureDwarves += dwarfCount;
-                            immatureDCTs++;
-                        } else {
-                            matureDwarves += dwarfCount; 
-                            matureDCTs++;
-                        }
+            int blockDCTs, dwarfCount;
+            CountBlockDwarves(block, blockHeight, consensusParams, blockDCTs, dwarfCount);
+            if (blockDCTs > 0) {
+                if (i < consensusParams.dwarfGestationBlocks) {
+                    immatureDwarves += dwarfCount;
+                    immatureDCTs += blockDCTs;
+                } else {
+                    matureDwarves += dwarfCount; 
+                    matureDCTs += blockDCTs;
+                }
 
-                        // Add these dwarves to pop graph
-                        if (recalcGraph) {
-                            /*
-                            int dwarfStart = blockHeight + consensusParams.dwarfGestationBlocks;
-                            int dwarfStop = dwarfStart + consensusParams.dwarfLifespanBlocks;
-                            dwarfStart -= tipHeight;
-                            dwarfStop -= tipHeight;
-                            for (int j = dwarfStart; j < dwarfStop; j++) {
-                                if (j > 0 && j < totalDwarfLifespan) {
-                                    if (i < consensusParams.dwarfGestationBlocks) // THIS IS WRONG
-                                        dwarfPopGraph[j].immaturePop += dwarfCount;
-                                    else
-                                        dwarfPopGraph[j].maturePop += dwarfCount;
-                                }
-                            }*/
-                            int dwarfBornBlock = blockHeight;
-                            int dwarfMaturesBlock = dwarfBornBlock + consensusParams.dwarfGestationBlocks;
-                            int dwarfDiesBlock = dwarfMaturesBlock + consensusParams.dwarfLifespanBlocks;
-                            for (int j = dwarfBornBlock; j < dwarfDiesBlock; j++) {
-                                int graphPos = j - tipHeight;
-                                if (graphPos > 0 && graphPos < totalDwarfLifespan) {
-                                    if (j < dwarfMaturesBlock)
-                                        dwarfPopGraph[graphPos].immaturePop += dwarfCount;
-                                    else
-                                        dwarfPopGraph[graphPos].maturePop += dwarfCount;
-                                }
-                            }
+                // Add these dwarves to pop graph
+                if (recalcGraph) {
+                    int dwarfBornBlock = blockHeight;
+                    int dwarfMaturesBlock = dwarfBornBlock + consensusParams.dwarfGestationBlocks;
+                    int dwarfDiesBlock = dwarfMaturesBlock + consensusParams.dwarfLifespanBlocks;
+                    for (int j = dwarfBornBlock; j < dwarfDiesBlock; j++) {
+                        int graphPos = j - tipHeight;
+                        if (graphPos > 0 && graphPos < totalDwarfLifespan) {
+                            if (j < dwarfMaturesBlock)
+                                dwarfPopGraph[graphPos].immaturePop += dwarfCount;
+                            else
+                                dwarfPopGraph[graphPos].maturePop += dwarfCount;
                         }
                     }
                 }
@@ -273,9 +283,68 @@ bool GetNetworkHiveInfo(int& immatureDwarves, int& immatureDCTs, int& matureDwar
     return true;
 }
 
-// Ring-fork: Hive: Check the hive proof for given block
-bool CheckHiveProof(const CBlock* pblock, const Consensus::Params& consensusParams) {
+// Ring-fork: Hive: Add str to the sha512 state up to its first NUL, if any; returns whether it had one
+static bool WriteUntilNul(CSHA512& sha, const std::string& str) {
+    size_t len = std::min(str.find('\0'), str.size());
+    sha.Write((const unsigned char*)str.data(), len);
+    return len != str.size();
+}
+
+CDwarfHasher::CDwarfHasher(const std::string& deterministicRandString) : hasher(GetThreadMinotaurHasher()) {
+    fRandStringTruncated = WriteUntilNul(randStringMidstate, deterministicRandString);
+    midstate = randStringMidstate;
+    fTruncated = fRandStringTruncated;
+}
+
+CDwarfHasher::CDwarfHasher(const std::string& deterministicRandString, const std::string& txid) : CDwarfHasher(deterministicRandString) {
+    SetTxid(txid);
+}
+
+void CDwarfHasher::SetTxid(const std::string& txid) {
+    midstate = randStringMidstate;
+    fTruncated = fRandStringTruncated || WriteUntilNul(midstate, txid);
+}
+
+uint256 CDwarfHasher::Hash(uint32_t nDwarf) {
+    static const char hexDigits[] = "0123456789abcdef";
+
+    // First pass: the prefix midstate plus the nonce in decimal
+    unsigned char initial[CSHA512::OUTPUT_SIZE];
+    CSHA512 sha(midstate);
+    if (!fTruncated) {
+        char digits[10];
+        char* p = digits + sizeof(digits);
+        do {
+            *--p = '0' + nDwarf % 10;
+            nDwarf /= 10;
+        } while (nDwarf);
+        sha.Write((const unsigned char*)p, digits + sizeof(digits) - p);
+    }
+    sha.Finalize(initial);
+    uint256 hash;
+    hasher.HashInitial(initial, hash.begin());
+
+    // Second pass: the first pass's hex, most significant byte first
+    char hex[64];
+    for (int i = 0; i < 32; i++) {
+        unsigned char c = hash.begin()[31 - i];
+        hex[2 * i] = hexDigits[c >> 4];
+        hex[2 * i + 1] = hexDigits[c & 0xf];
+    }
+    hasher.Hash(hex, sizeof(hex), hash.begin());
+    return hash;
+}
+
+bool CDwarfHasher::CheckTarget(uint32_t nDwarf, const arith_uint256& dwarfHashTarget) {
+    return UintToArith256(Hash(nDwarf)) < dwarfHashTarget;
+}
+
+// Ring-fork: Hive: Check the hive proof for given block. If pfAncestryOnly is given, it's set on a pass when the DCT was
+// found by looking through the block's ancestry rather than in the UTXO set, which needn't follow the block's branch.
+bool CheckHiveProof(const CBlock* pblock, const Consensus::Params& consensusParams, bool* pfAncestryOnly) {
     bool verbose = LogAcceptCategory(BCLog::HIVE);
+    if (pfAncestryOnly)
+        *pfAncestryOnly = false;
 
     if (verbose)
         LogPrintf("********************* Hive: CheckHiveProof *********************\n");
@@ -285,13 +354,13 @@ bool CheckHiveProof(const CBlock* pblock, const Consensus::Params& consensusPara
     CBlockIndex* pindexPrev;
     {
         LOCK(cs_main);
-        pindexPrev = mapBlockIndex[pblock->hashPrevBlock];
+        pindexPrev = LookupBlockIndex(pblock->hashPrevBlock);
+        if (!pindexPrev) {
+            LogPrintf("CheckHiveProof: Couldn't get previous block's CBlockIndex!\n");
+            return false;
+        }
         blockHeight = pindexPrev->nHeight + 1;
     }
-    if (!pindexPrev) {
-        LogPrintf("CheckHiveProof: Couldn't get previous block's CBlockIndex!\n");
-        return false;
-    }
     if (verbose)
         LogPrintf("CheckHiveProof: nHeight             = %i\n", blockHeight);
 
@@ -302,15 +371,7 @@ bool CheckHiveProof(const CBlock* pblock, const Consensus::Params& consensusPara
     }
 
     // Check that there aren't too many Hive blocks since the last Pow block
-    int hiveBlocksSincePow = 0;
-    CBlockIndex* pindexTemp = pindexPrev;
-    while (pindexTemp->GetBlockHeader().IsPopMined(consensusParams) || pindexTemp->GetBlockHeader().IsHiveMined(consensusParams)) {
-        if (pindexTemp->GetBlockHeader().IsHiveMined(consensusParams))
-            hiveBlocksSincePow++;
-
-        assert(pindexTemp->pprev);
-        pindexTemp = pindexTemp->pprev;
-    }
+    int hiveBlocksSincePow = pindexPrev->GetHiveSincePow(consensusParams);
     if (hiveBlocksSincePow >= consensusParams.maxConsecutiveHiveBlocks) {
         LogPrintf("CheckHiveProof: Too many Hive blocks without a POW block.\n");
         return false;
@@ -381,8 +442,7 @@ bool CheckHiveProof(const CBlock* pblock, const Consensus::Params& consensusPara
     if (verbose)
         LogPrintf("CheckHiveProof: dwarfHashTarget     = %s\n", dwarfHashTarget.ToString());
 
-    arith_uint256 dwarfHash(CBlockHeader::MinotaurHashArbitrary(std::string(deterministicRandString + txidStr + std::to_string(dwarfNonce)).c_str()).ToString());
-    dwarfHash = arith_uint256(CBlockHeader::MinotaurHashArbitrary(dwarfHash.ToString().c_str()).ToString());
+    arith_uint256 dwarfHash = UintToArith256(CDwarfHasher(deterministicRandString, txidStr).Hash(dwarfNonce));
 
     if (verbose)
         LogPrintf("CheckHiveProof: dwarfHash           = %s\n", dwarfHash.ToString());
@@ -430,6 +490,7 @@ bool CheckHiveProof(const CBlock* pblock, const Consensus::Params& consensusPara
 
     // Grab the DCT utxo
     bool deepDrill = false;
+    bool usedCoinsTip = false;
     uint32_t dctFoundHeight;
     CAmount dctValue;
     CScript dctScriptPubKey;
@@ -441,13 +502,22 @@ bool CheckHiveProof(const CBlock* pblock, const Consensus::Params& consensusPara
         Coin coin;
         CTransactionRef dct = nullptr;
         CBlockIndex foundAt;
+        CDCTLocation dctLocation;
+        bool dctLocated = GetDCTLocation(uint256S(txidStr), dctClaimedHeight, pindexPrev, dctLocation);
 
         if (pcoinsTip && pcoinsTip->GetCoin(outDwarfCreation, coin)) {      // First try the UTXO set (this pathway will hit on incoming blocks)
             if (verbose)
                 LogPrintf("CheckHiveProof: Using UTXO set for outDwarfCreation\n");
+            usedCoinsTip = true;
             dctValue = coin.out.nValue;
             dctScriptPubKey = coin.out.scriptPubKey;
             dctFoundHeight = coin.nHeight;
+        } else if (dctLocated) {                                            // Then the DCTs recorded as blocks were accepted (this pathway will hit when reindexing)
+            if (verbose)
+                LogPrintf("CheckHiveProof: Using DCT locator for outDwarfCreation\n");
+            dctValue = dctLocation.vout[0].nValue;
+            dctScriptPubKey = dctLocation.vout[0].scriptPubKey;
+            dctFoundHeight = dctLocation.nHeight;
         } else {                                                            // UTXO set isn't available when eg reindexing, so drill into block db (not too bad, since Alice put her DCT height in the coinbase tx)
             if (verbose)
                 LogPrintf("! CheckHiveProof: Warn: Using deep drill for outDwarfCreation\n");
@@ -469,12 +539,21 @@ bool CheckHiveProof(const CBlock* pblock, const Consensus::Params& consensusPara
                 if (pcoinsTip && pcoinsTip->GetCoin(outCommFund, coin)) {                       // First try UTXO set
                     if (verbose)
                         LogPrintf("CheckHiveProof: Using UTXO set for outCommFund\n");
+                    usedCoinsTip = true;
                     if (coin.out.scriptPubKey != scriptPubKeyCF) {                              // If we find it, validate the scriptPubKey and store amount
                         LogPrintf("CheckHiveProof: Community contrib was indicated but not found\n");
                         return false;
                     }
                     donationAmount = coin.out.nValue;
-                } else {                                                                        // Fallback if we couldn't use UTXO set
+                } else if (dctLocated) {                                                        // Then the DCT locator
+                    if (verbose)
+                        LogPrintf("CheckHiveProof: Using DCT locator for outCommFund\n");
+                    if (dctLocation.vout.size() < 2 || dctLocation.vout[1].scriptPubKey != scriptPubKeyCF) {
+                        LogPrintf("CheckHiveProof: Community contrib was indicated but not found\n");
+                        return false;
+                    }
+                    donationAmount = dctLocation.vout[1].nValue;
+                } else {                                                                        // Fallback if we couldn't use UTXO set or the locator
                     if (verbose)
                         LogPrintf("! CheckHiveProof: Warn: Using deep drill for outCommFund\n");
                     if (!GetTxByHashAndHeight(uint256S(txidStr), dctClaimedHeight, dct, foundAt, pindexPrev, consensusParams)) {
@@ -558,6 +637,8 @@ bool CheckHiveProof(const CBlock* pblock, const Consensus::Params& consensusPara
 
     if (verbose)
         LogPrintf("CheckHiveProof: Pass at %i%s\n", blockHeight, deepDrill ? " (used deepdrill)" : "");
+    if (pfAncestryOnly)
+        *pfAncestryOnly = !usedCoinsTip;
     return true;
 }
 
@@ -573,13 +654,13 @@ bool CheckPopProof(const CBlock* pblock, const Consensus::Params& consensusParam
     CBlockIndex* pindexPrev;
     {
         LOCK(cs_main);
-        pindexPrev = mapBlockIndex[pblock->hashPrevBlock];
+        pindexPrev = LookupBlockIndex(pblock->hashPrevBlock);
+        if (!pindexPrev) {
+            LogPrintf("CheckPopProof: Couldn't get previous block's CBlockIndex!\n");
+            return false;
+        }
         blockHeight = pindexPrev->nHeight + 1;
     }
-    if (!pindexPrev) {
-        LogPrintf("CheckPopProof: Couldn't get previous block's CBlockIndex!\n");
-        return false;
-    }
     if (verbose)
         LogPrintf("CheckPopProof: nHeight              = %i\n", blockHeight);
 
@@ -626,10 +707,9 @@ bool CheckPopProof(const CBlock* pblock, const Consensus::Params& consensusParam
 
     // Grab the source block hash (32 bytes at byte 4 -- byte 3 has val 32 as size marker)
     uint256 gameSourceHashBin;
-    gameSourceHashBin.SetHex(HexStr(&txCoinbase->vout[0].scriptPubKey[4], &txCoinbase->vout[0].scriptPubKey[4 + 32]));
-    std::string gameSourceHashStr = gameSourceHashBin.ToString();
+    GetPopProofSourceHash(*pblock, gameSourceHashBin);
     if (verbose)
-        LogPrintf("CheckPopProof: gameSourceHash       = %s\n", gameSourceHashStr);
+        LogPrintf("CheckPopProof: gameSourceHash       = %s\n", gameSourceHashBin.ToString());
  
     // Get public/private claim
     bool isPrivate = txCoinbase->vout[0].scriptPubKey[36] == OP_TRUE;
@@ -637,30 +717,37 @@ bool CheckPopProof(const CBlock* pblock, const Consensus::Params& consensusParam
         LogPrintf("CheckPopProof: isPrivate            = %s\n", isPrivate ? "true" : "false");
 
     // Grab the source block
-    CBlockIndex* pindexSourceBlock = mapBlockIndex[uint256S(gameSourceHashStr)];
-    if (!pindexSourceBlock) {
-        LogPrintf("CheckPopProof: Couldn't find claimed source block\n");
-        return false;
-    }
-
-    // Check claimed source block is in active chain
-    if (checkActiveChain && !chainActive.Contains(pindexSourceBlock)) {
-        LogPrintf("CheckPopProof: Claimed source block is not in active chain\n");
-        return false;
-    }
+    CBlockIndex* pindexSourceBlock;
+    {
+        LOCK(cs_main);
+        pindexSourceBlock = LookupBlockIndex(gameSourceHashBin);
+        if (!pindexSourceBlock) {
+            LogPrintf("CheckPopProof: Couldn't find claimed source block\n");
+            return false;
+        }
 
-    CBlock sourceBlock;
-    if (!ReadBlockFromDisk(sourceBlock, pindexSourceBlock, Params().GetConsensus(), false)) {
-        LogPrintf("CheckPopProof: Couldn't read source block\n");
-        return false;
+        // Check claimed source block is in active chain
+        if (checkActiveChain && !chainActive.Contains(pindexSourceBlock)) {
+            LogPrintf("CheckPopProof: Claimed source block is not in active chain\n");
+            return false;
+        }
     }
 
     // Make sure it's hivemined
-    if (!sourceBlock.GetBlockHeader().IsHiveMined(consensusParams)) {
+    if (!pindexSourceBlock->IsHiveMined(consensusParams)) {
         LogPrintf("CheckPopProof: Source block isn't hivemined!\n");
         return false;
     }
 
+    CHiveBlockSummary sourceSummary;
+    {
+        LOCK(cs_main);
+        if (!GetHiveBlockSummary(pindexSourceBlock, consensusParams, sourceSummary)) {
+            LogPrintf("CheckPopProof: Couldn't read source block\n");
+            return false;
+        }
+    }
+
     // Make sure it's within valid depth range
     int sourceBlockHeight = pindexSourceBlock->nHeight;
     int depth = blockHeight - sourceBlockHeight;
@@ -678,7 +765,7 @@ bool CheckPopProof(const CBlock* pblock, const Consensus::Params& consensusParam
 
     // Grab source block's reward destination
     CTxDestination rewardSourceBlock;
-    if (!ExtractDestination(sourceBlock.vtx[0]->vout[1].scriptPubKey, rewardSourceBlock) || !IsValidDestination(rewardSourceBlock)) {
+    if (!ExtractDestination(sourceSummary.rewardScript, rewardSourceBlock) || !IsValidDestination(rewardSourceBlock)) {
         LogPrintf("CheckPopProof: Couldn't extract source block reward destination\n");
         return false;
     }
@@ -722,30 +809,19 @@ bool CheckPopProof(const CBlock* pblock, const Consensus::Params& consensusParam
 
     // Verify it's a valid game solution
     std::string strError;
-    Game0 game0;
-    if (!game0.VerifyGameSolution(GetNextPopScoreRequired(pindexPrev, consensusParams), gameSourceHashBin, solution, strError)) {
+    if (!VerifyGame0Solution(GetNextPopScoreRequired(pindexPrev, consensusParams), gameSourceHashBin, solution, strError)) {
         LogPrintf("CheckPopProof: Invalid solution: %s\n", strError);
         return false;
     }
 
     // Make sure this gameSourceHash hasn't been claimed before
-    CBlockIndex *pblockindex = pindexPrev;
-    while (pblockindex->nHeight > sourceBlockHeight) {
-        if (pblockindex->GetBlockHeader().IsPopMined(consensusParams)) {
-            CBlock block;
-            if (ReadBlockFromDisk(block, pblockindex, consensusParams, false)) {
-                uint256 tempGameSourceHashBin;
-                tempGameSourceHashBin.SetHex(HexStr(&block.vtx[0]->vout[0].scriptPubKey[4], &block.vtx[0]->vout[0].scriptPubKey[4+32]));
-
-                if (gameSourceHashBin == tempGameSourceHashBin) {
-                    LogPrintf("CheckPopProof: Game is already claimed in block %s (height %i).\n", pblockindex->GetBlockHash().ToString(), pblockindex->nHeight);
-                    return false;
-                }
-            }
+    {
+        LOCK(cs_main);
+        const CBlockIndex* pindexClaim = FindGameClaim(gameSourceHashBin, sourceBlockHeight, pindexPrev, consensusParams);
+        if (pindexClaim) {
+            LogPrintf("CheckPopProof: Game is already claimed in block %s (height %i).\n", pindexClaim->GetBlockHash().ToString(), pindexClaim->nHeight);
+            return false;
         }
-
-        assert(pblockindex->pprev);
-        pblockindex = pblockindex->pprev;
     }
 
     if (verbose)
@@ -7,13 +7,17 @@
 #define RING_POW_H
 
 #include <consensus/params.h>
+#include <crypto/sha512.h>      // Ring-fork: Hive
 
 #include <stdint.h>
+#include <string>
 
 class CBlockHeader;
 class CBlockIndex;
 class uint256;
-class CBlock;   // Ring-fork: Hive
+class arith_uint256;    // Ring-fork: Hive
+class CBlock;           // Ring-fork: Hive
+class MinotaurHasher;   // Ring-fork: Hive
 
 // Ring-fork: Hive
 struct DwarfPopGraphPoint {
@@ -21,14 +25,45 @@ struct DwarfPopGraphPoint {
     int maturePop;
 };
 
+/** Ring-fork: Hive: Dwarf hash kernel, shared by the hive miner and CheckHiveProof.
+ *  A dwarf's hash is Minotaur(hex(Minotaur(deterministicRandString + txid + decimal(dwarf nonce)))), where hex() is the
+ *  lowercase big-endian hex of the 256-bit result. Minotaur starts with a sha512 of its input, and the
+ *  deterministicRandString + txid prefix (~450 bytes) is the same for every dwarf of a DCT, so the sha512 state over the
+ *  prefix is kept as a midstate and each dwarf only adds its nonce digits. Uses the calling thread's MinotaurHasher.
+ */
+class CDwarfHasher
+{
+public:
+    explicit CDwarfHasher(const std::string& deterministicRandString);
+    CDwarfHasher(const std::string& deterministicRandString, const std::string& txid);
+
+    /** Set the DCT txid for subsequent dwarves, keeping the deterministicRandString part of the midstate */
+    void SetTxid(const std::string& txid);
+
+    /** Get the hash of the given dwarf of the current DCT */
+    uint256 Hash(uint32_t nDwarf);
+
+    /** Check whether the given dwarf of the current DCT meets the dwarf hash target */
+    bool CheckTarget(uint32_t nDwarf, const arith_uint256& dwarfHashTarget);
+
+private:
+    MinotaurHasher& hasher;
+    CSHA512 randStringMidstate;
+    CSHA512 midstate;
+    bool fRandStringTruncated;
+    bool fTruncated;            // The prefix held a NUL; dwarf strings were always hashed as C strings, so nothing after it counts
+};
+
 unsigned int GetNextWorkRequired(const CBlockIndex* pindexLast, const CBlockHeader *pblock, const Consensus::Params&);
 
 /** Check whether a block hash satisfies the proof-of-work requirement specified by nBits */
 bool CheckProofOfWork(uint256 hash, unsigned int nBits, const Consensus::Params&);
 
 unsigned int GetNextHiveWorkRequired(const CBlockIndex* pindexLast, const Consensus::Params& params);           // Ring-fork: Hive: Get the current Dwarf Hash Target
-bool CheckHiveProof(const CBlock* pblock, const Consensus::Params& params);                                     // Ring-fork: Hive: Check the hive proof for given block
+unsigned int CalculateNextHiveWorkRequired(const CBlockIndex* pindexLast, const Consensus::Params& params);     // Ring-fork: Hive: Work out the Dwarf Hash Target, without the cached value
+bool CheckHiveProof(const CBlock* pblock, const Consensus::Params& params, bool* pfAncestryOnly = nullptr);     // Ring-fork: Hive: Check the hive proof for given block
 bool CheckPopProof(const CBlock* pblock, const Consensus::Params& params, bool checkActiveChain = true);        // Ring-fork: Pop: Check the pop proof for given block
+void CountBlockDwarves(const CBlock& block, int nHeight, const Consensus::Params& consensusParams, int& nDCTs, int& nDwarves);  // Ring-fork: Hive: Count the DCTs in a block and the dwarves they create
 bool GetNetworkHiveInfo(int& immatureDwarves, int& immatureDCTs, int& matureDwarves, int& matureDCTs, CAmount& potentialLifespanRewards, const Consensus::Params& consensusParams, bool recalcGraph = false); // Ring-fork: Hive: Get count of all live and gestating DCTs on the network
 int GetNextPopScoreRequired(const CBlockIndex* pindexLast, const Consensus::Params& params);                    // Ring-fork: Pop
 
@@ -110,7 +110,7 @@ void MiningPage::on_toggleMiningButton_clicked() {
 }
 
 void MiningPage::updateHashRateDisplay() {
-    ui->hashRateDisplayLabel->setText(QString::number(std::floor(dHashesPerSec/1000)));
+    ui->hashRateDisplayLabel->setText(QString::number(std::floor(GetMinerHashesPerSec()/1000)));
 
     double timeToSolve = (this->clientModel) ? this->clientModel->getTimeToSolve() : 0;
 
@@ -19,8 +19,6 @@ class ClientModel;
 class PlatformStyle;
 class WalletModel;
 
-extern double dHashesPerSec;
-
 namespace Ui {
     class MiningPage;
 }
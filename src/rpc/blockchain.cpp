@@ -67,20 +67,16 @@ double GetDifficulty(const CBlockIndex* blockindex, bool getHiveDifficulty)
     // Ring-fork: Hive: Step back until we find the blocktype we're looking for
     const Consensus::Params& consensusParams = Params().GetConsensus();
     if (getHiveDifficulty) {
-        while (!blockindex->GetBlockHeader().IsHiveMined(consensusParams)) {
-            if (!blockindex->pprev || blockindex->nHeight < consensusParams.minHiveCheckBlock) {   // Ran out of blocks without finding a Hive block? Return min target
-                LogPrint(BCLog::HIVE, "GetDifficulty: No hivemined blocks found in history\n");
-                return 1.0;
-            }
-
-            blockindex = blockindex->pprev;
+        // Only the first block below minHiveCheckBlock is looked at
+        const CBlockIndex* pindexLastHive = blockindex->GetLastHive(consensusParams);
+        if (!pindexLastHive || (pindexLastHive != blockindex && pindexLastHive->nHeight + 1 < consensusParams.minHiveCheckBlock)) {   // Ran out of blocks without finding a Hive block? Return min target
+            LogPrint(BCLog::HIVE, "GetDifficulty: No hivemined blocks found in history\n");
+            return 1.0;
         }
+        blockindex = pindexLastHive;
     } else {
         // Ring-fork: Pop: Step over pop blocks as well
-        while (blockindex->GetBlockHeader().IsHiveMined(consensusParams) || blockindex->GetBlockHeader().IsPopMined(consensusParams)) {
-            assert (blockindex->pprev);
-            blockindex = blockindex->pprev;
-        }
+        blockindex = blockindex->GetLastPow(consensusParams);
     }
 
     int nShift = (blockindex->nBits >> 24) & 0xff;
@@ -117,8 +113,8 @@ static int ComputeNextBlockAndDepth(const CBlockIndex* tip, const CBlockIndex* b
 UniValue blockheaderToJSON(const CBlockIndex* tip, const CBlockIndex* blockindex)
 {
     UniValue result(UniValue::VOBJ);
-    bool isHive = blockindex->GetBlockHeader().IsHiveMined(Params().GetConsensus());
-    bool isPop = blockindex->GetBlockHeader().IsPopMined(Params().GetConsensus());
+    bool isHive = blockindex->IsHiveMined(Params().GetConsensus());
+    bool isPop = blockindex->IsPopMined(Params().GetConsensus());
 
     result.pushKV("hash", blockindex->GetBlockHash().GetHex());
     result.pushKV("type", isHive ? "hive" : isPop ? "pop" : "pow");
@@ -152,8 +148,8 @@ UniValue blockheaderToJSON(const CBlockIndex* tip, const CBlockIndex* blockindex
 UniValue blockToJSON(const CBlock& block, const CBlockIndex* tip, const CBlockIndex* blockindex, bool txDetails)
 {
     UniValue result(UniValue::VOBJ);
-    bool isHive = blockindex->GetBlockHeader().IsHiveMined(Params().GetConsensus());
-    bool isPop = blockindex->GetBlockHeader().IsPopMined(Params().GetConsensus());    
+    bool isHive = blockindex->IsHiveMined(Params().GetConsensus());
+    bool isPop = blockindex->IsPopMined(Params().GetConsensus());    
 
     result.pushKV("hash", blockindex->GetBlockHash().GetHex());
     result.pushKV("type", isHive ? "hive" : isPop ? "pop" : "pow");
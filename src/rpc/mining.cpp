@@ -40,7 +40,7 @@ UniValue sethiveparams(const JSONRPCRequest& request)
             "sethiveparams ( hivecheckdelay, hivecheckthreads, hiveearlyout )\n"
             "\nSet hivemining optimisation parameters.\n"
             "\nArguments:\n"
-            "1. hivecheckdelay     (numeric, required, default=1) Time between Hive checks in ms. This should be left at default unless performance degradation is observed.\n"
+            "1. hivecheckdelay     (numeric, required, default=1) Deprecated and ignored; hive checks now start as soon as the tip changes.\n"
             "2. hivecheckthreads   (numeric, required, default=-2) Number of threads to use when checking dwarves, -1 for all available cores, or -2 for one less than all available cores.\n"
             "3. hiveearlyout       (boolean, required, default=true) Abort Hive checking as quickly as possible when a new block comes in. This should be left enabled unless performance degradation is observed.\n"
             "\nExamples:\n"
@@ -64,7 +64,7 @@ UniValue gethiveparams(const JSONRPCRequest& request)
             "\nGet hivemining optimisation parameters.\n"
             "\nResult:\n"
             "{\n"
-            "  \"hivecheckdelay\" : n,             (numeric) Time between Hive checks in ms. This should be left at default unless performance degradation is observed.\n"
+            "  \"hivecheckdelay\" : n,             (numeric) Deprecated and ignored; hive checks now start as soon as the tip changes.\n"
             "  \"hivecheckthreads\" : n,           (numeric) Number of threads to use when checking dwarves, -1 for all available cores, or -2 for one less than all available cores.\n"
             "  \"hiveearlyout\" : true|false,      (boolean) Abort Hive checking as quickly as possible when a new block comes in. This should be left enabled unless performance degradation is observed.\n"
             "}\n"
@@ -81,6 +81,76 @@ UniValue gethiveparams(const JSONRPCRequest& request)
     return obj;
 }
 
+// Ring-fork: Hive: Mining optimisations: Get hive check round telemetry
+UniValue gethivemininginfo(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0)
+        throw std::runtime_error(
+            RPCHelpMan{"gethivemininginfo",
+                "\nReturns the progress of the hive check in progress, and telemetry for the last " + std::to_string(HIVE_ROUND_HISTORY_SIZE) + " hive check rounds.\n"
+                "Times are in milliseconds.\n",
+                {},
+                RPCResult{
+            "{\n"
+            "  \"checking\": true|false,      (boolean) If a hive check is in progress\n"
+            "  \"claimed\": n,                (numeric) Dwarves claimed by check threads in the current check (only if checking)\n"
+            "  \"checked\": n,                (numeric) Dwarves checked in the current check (only if checking)\n"
+            "  \"rounds\": [                  (json array) Recent rounds, oldest first\n"
+            "    {\n"
+            "      \"height\": n,             (numeric) Height of the block the round tried to mine\n"
+            "      \"speculative\": true|false, (boolean) If the round checked against a header before its block connected\n"
+            "      \"time\": n,               (numeric) Unix time the round started\n"
+            "      \"result\": \"str\",         (string) \"solved\", \"none\" if no dwarf met the target, or \"aborted\" if the chain moved on\n"
+            "      \"dwarves\": n,            (numeric) Mature dwarves scheduled for checking\n"
+            "      \"checked\": n,            (numeric) Dwarves checked before the round ended\n"
+            "      \"threads\": n,            (numeric) Check threads used\n"
+            "      \"checktime\": n,          (numeric) Wall time of the round\n"
+            "      \"aborttime\": n,          (numeric) Time from the round being cancelled to it ending (only if aborted)\n"
+            "      \"submittime\": n,         (numeric) Time from the tip arriving to our hive block being submitted (only if submitted)\n"
+            "      \"accepted\": true|false   (boolean) If the submitted block was accepted (only if submitted)\n"
+            "    }, ...\n"
+            "  ]\n"
+            "}\n"
+                },
+                RPCExamples{
+                    HelpExampleCli("gethivemininginfo", "")
+                    + HelpExampleRpc("gethivemininginfo", "")
+                }
+            }.ToString());
+
+    UniValue obj(UniValue::VOBJ);
+    int nClaimed, nChecked;
+    bool fChecking = GetHiveCheckProgress(nClaimed, nChecked);
+    obj.pushKV("checking", fChecking);
+    if (fChecking) {
+        obj.pushKV("claimed", nClaimed);
+        obj.pushKV("checked", nChecked);
+    }
+
+    UniValue rounds(UniValue::VARR);
+    for (const CHiveRoundStats& stats : GetHiveRoundStats()) {
+        UniValue round(UniValue::VOBJ);
+        round.pushKV("height", stats.nHeight);
+        round.pushKV("speculative", stats.fSpeculative);
+        round.pushKV("time", stats.nTime);
+        round.pushKV("result", stats.result == HIVE_CHECK_SOLVED ? "solved" : stats.result == HIVE_CHECK_ABORTED ? "aborted" : "none");
+        round.pushKV("dwarves", stats.nDwarvesScheduled);
+        round.pushKV("checked", stats.nDwarvesChecked);
+        round.pushKV("threads", stats.nThreads);
+        round.pushKV("checktime", stats.nCheckMicros / 1000.0);
+        if (stats.nAbortMicros >= 0)
+            round.pushKV("aborttime", stats.nAbortMicros / 1000.0);
+        if (stats.nSubmitMicros >= 0) {
+            round.pushKV("submittime", stats.nSubmitMicros / 1000.0);
+            round.pushKV("accepted", stats.fAccepted);
+        }
+        rounds.push_back(round);
+    }
+    obj.pushKV("rounds", rounds);
+
+    return obj;
+}
+
 /**
  * Return average network hashes per second based on the last 'lookup' blocks,
  * or from the last difficulty change if 'lookup' is nonpositive.
@@ -221,7 +291,7 @@ double GetTimeToSolve() {
     if (!gArgs.GetBoolArg("-gen", DEFAULT_GENERATE))
         return (int64_t)0;
 
-    double ourHash = dHashesPerSec;
+    double ourHash = GetMinerHashesPerSec();
     if (ourHash < 0.1)
         return (int64_t)0;
 
@@ -270,9 +340,74 @@ UniValue gethashespersec(const JSONRPCRequest& request)
                 }
             }.ToString());
 
-    if (GetTimeMillis() - nHPSTimerStart > 8000)
-        return (int64_t) 0;
-    return (int64_t)dHashesPerSec;
+    return (int64_t)GetMinerHashesPerSec();
+}
+
+// Ring-fork: In-wallet miner
+UniValue getminerstats(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0)
+        throw std::runtime_error(
+            RPCHelpMan{"getminerstats",
+                "\nReturns per-thread telemetry from the in-wallet miner, sampled once a second.\n"
+                "Hashrates are averaged over the last 1, 10 and 60 seconds (or since the miner started, if more recent).\n",
+                {},
+                RPCResult{
+            "{\n"
+            "  \"generate\": true|false,      (boolean) If the generation is on or off\n"
+            "  \"hashespersec\": {           (json object) Total hashrate of all threads\n"
+            "    \"1s\": n,                  (numeric) Over the last second\n"
+            "    \"10s\": n,                 (numeric) Over the last 10 seconds\n"
+            "    \"60s\": n                  (numeric) Over the last 60 seconds\n"
+            "  },\n"
+            "  \"threads\": [                (json array) One entry per miner thread\n"
+            "    {\n"
+            "      \"thread\": n,            (numeric) Thread number\n"
+            "      \"hashespersec\": {...},  (json object) Hashrate of this thread, as above\n"
+            "      \"hashes\": n,            (numeric) Hashes done since the miner was started\n"
+            "      \"neartarget\": n,        (numeric) Hashes within a factor of " + std::to_string(1 << MINER_NEAR_TARGET_BITS) + " of the block target since the miner was started\n"
+            "      \"templateage\": n        (numeric) Seconds since the block template being mined was built, or -1 if the thread is idle\n"
+            "    }, ...\n"
+            "  ]\n"
+            "}\n"
+                },
+                RPCExamples{
+                    HelpExampleCli("getminerstats", "")
+                    + HelpExampleRpc("getminerstats", "")
+                }
+            }.ToString());
+
+    std::vector<CMinerThreadStats> vStats = GetMinerThreadStats();
+    double dTotal1s = 0, dTotal10s = 0, dTotal60s = 0;
+    UniValue threads(UniValue::VARR);
+    for (const CMinerThreadStats& stats : vStats) {
+        UniValue hashesPerSec(UniValue::VOBJ);
+        hashesPerSec.pushKV("1s", stats.dHashesPerSec1s);
+        hashesPerSec.pushKV("10s", stats.dHashesPerSec10s);
+        hashesPerSec.pushKV("60s", stats.dHashesPerSec60s);
+        dTotal1s += stats.dHashesPerSec1s;
+        dTotal10s += stats.dHashesPerSec10s;
+        dTotal60s += stats.dHashesPerSec60s;
+
+        UniValue thread(UniValue::VOBJ);
+        thread.pushKV("thread", stats.nThread);
+        thread.pushKV("hashespersec", hashesPerSec);
+        thread.pushKV("hashes", stats.nHashes);
+        thread.pushKV("neartarget", stats.nNearTarget);
+        thread.pushKV("templateage", stats.nTemplateAge);
+        threads.push_back(thread);
+    }
+
+    UniValue hashesPerSec(UniValue::VOBJ);
+    hashesPerSec.pushKV("1s", dTotal1s);
+    hashesPerSec.pushKV("10s", dTotal10s);
+    hashesPerSec.pushKV("60s", dTotal60s);
+
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("generate", gArgs.GetBoolArg("-gen", DEFAULT_GENERATE));
+    obj.pushKV("hashespersec", hashesPerSec);
+    obj.pushKV("threads", threads);
+    return obj;
 }
 
 UniValue generateBlocks(std::shared_ptr<CReserveScript> coinbaseScript, int nGenerate, uint64_t nMaxTries, bool keepScript)
@@ -404,9 +539,7 @@ static UniValue getmininginfo(const JSONRPCRequest& request)
     obj.pushKV("chain",            Params().NetworkIDString());
     obj.pushKV("warnings",         GetWarnings("statusbar"));
     // Ring-fork: In-wallet miner: Show internal miner status
-    int64_t hashesPerSec = 0;
-    if (GetTimeMillis() - nHPSTimerStart >= 8000)
-        hashesPerSec = dHashesPerSec;
+    int64_t hashesPerSec = GetMinerHashesPerSec();
     obj.pushKV("generate",         gArgs.GetBoolArg("-gen", DEFAULT_GENERATE));
     obj.pushKV("genproclimit",     (int)gArgs.GetArg("-genproclimit", DEFAULT_GENERATE_THREADS));
     obj.pushKV("hashespersec",     hashesPerSec);
@@ -1173,6 +1306,7 @@ static const CRPCCommand commands[] =
     { "generating",         "getgenerate",            &getgenerate,            {} },                            // Ring-fork: In-wallet miner
     { "generating",         "setgenerate",            &setgenerate,            {"generate", "genproclimit"} },  // Ring-fork: In-wallet miner
     { "generating",         "gethashespersec",        &gethashespersec,        {} },                            // Ring-fork: In-wallet miner
+    { "generating",         "getminerstats",          &getminerstats,          {} },                            // Ring-fork: In-wallet miner
     { "generating",         "gettimetosolve",         &gettimetosolve,         {} },                            // Ring-fork: In-wallet miner
     { "generating",         "generatetoaddress",      &generatetoaddress,      {"nblocks","address","maxtries"} },
 
@@ -1182,6 +1316,7 @@ static const CRPCCommand commands[] =
 
     { "mining",             "sethiveparams",          &sethiveparams,          {"hivecheckdelay", "hivecheckthreads", "hiveearlyout"} },  // Ring-fork: Hive: Mining optimisations: Set hive mining params
     { "mining",             "gethiveparams",          &gethiveparams,          {} },                            // Ring-fork: Hive: Mining optimisations: Get hive mining params    
+    { "mining",             "gethivemininginfo",      &gethivemininginfo,      {} },                            // Ring-fork: Hive: Mining optimisations: Get hive check round telemetry
 };
 // clang-format on
 
@@ -0,0 +1,644 @@
+// Copyright (c) 2019 The Ring Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Ring-fork: Stratum work server
+
+#include <stratum.h>
+
+#include <arith_uint256.h>
+#include <chainparams.h>
+#include <crypto/common.h>
+#include <hash.h>
+#include <key_io.h>
+#include <miner.h>
+#include <netbase.h>
+#include <pow.h>
+#include <primitives/block.h>
+#include <rpc/protocol.h>
+#include <script/standard.h>
+#include <streams.h>
+#include <timedata.h>
+#include <txmempool.h>
+#include <util/memory.h>
+#include <util/strencodings.h>
+#include <util/system.h>
+#include <validation.h>
+#include <validationinterface.h>
+#include <version.h>
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <set>
+#include <thread>
+
+#include <univalue.h>
+
+#include <event2/buffer.h>
+#include <event2/bufferevent.h>
+#include <event2/event.h>
+#include <event2/listener.h>
+#include <event2/thread.h>
+#include <event2/util.h>
+
+/** Bytes of the per-connection extranonce1 and the miner-chosen extranonce2 in the coinbase */
+static const unsigned int EXTRANONCE1_SIZE = 4;
+static const unsigned int EXTRANONCE2_SIZE = 4;
+/** Longest request line buffered from a client */
+static const size_t MAX_LINE_SIZE = 16 * 1024;
+/** Number of jobs kept for late submits */
+static const size_t MAX_JOBS = 16;
+/** Seconds between checks for a stale job, and vardiff on idle connections */
+static const int64_t REFRESH_INTERVAL = 5;
+/** A job is rebuilt for new mempool transactions once it's this many seconds old */
+static const int64_t JOB_MAX_AGE = 30;
+/** Vardiff retargets a connection after this many shares, or this many share intervals */
+static const unsigned int VARDIFF_SHARES = 8;
+/** Lowest share difficulty (DifficultyToTarget() works in steps of this) */
+static const double MIN_DIFFICULTY = 1.0 / (1 << 20);
+
+/** Stratum error codes */
+enum StratumErrorCode {
+    STRATUM_OTHER = 20,
+    STRATUM_JOB_NOT_FOUND = 21,
+    STRATUM_DUPLICATE_SHARE = 22,
+    STRATUM_LOW_DIFFICULTY = 23,
+    STRATUM_UNAUTHORIZED = 24,
+    STRATUM_NOT_SUBSCRIBED = 25,
+};
+
+struct StratumError
+{
+    int code;
+    std::string message;
+};
+
+/** Work sent to miners. The coinbase is split around the extranonces: coinb1 + extranonce1 + extranonce2 + coinb2. */
+struct StratumJob
+{
+    std::string strId;
+    CBlock block;
+    std::vector<unsigned char> coinb1;
+    std::vector<unsigned char> coinb2;
+    std::vector<uint256> vMerkleBranch;
+    std::set<uint256> setSubmitted;     // Hashes of the blocks behind shares already accepted for this job
+};
+
+/** A connected miner */
+struct StratumClient
+{
+    struct bufferevent* bev;
+    std::string strPeer;
+    std::vector<unsigned char> vExtraNonce1;
+    bool fSubscribed = false;
+    bool fAuthorized = false;
+    bool fDisconnect = false;
+    std::string strWorker;
+    double dDifficulty;
+    double dPrevDifficulty;             // Shares at the previous difficulty are accepted until the next job is sent
+    int64_t nRetargetTime;
+    unsigned int nRetargetShares = 0;
+};
+
+// Everything below is only touched from the event thread, once the server has started
+static struct event_base* eventBase = nullptr;
+static std::vector<struct evconnlistener*> vListeners;
+static struct event* eventRefresh = nullptr;
+static std::thread threadStratum;
+static std::map<struct bufferevent*, std::unique_ptr<StratumClient>> mapClients;
+static std::deque<std::shared_ptr<StratumJob>> jobs;
+static uint64_t nJobCounter = 0;
+static int64_t nJobTime = 0;
+static unsigned int nJobTransactionsUpdated = 0;
+static uint32_t nExtraNonce1Next = 0;
+
+// Settings
+static CScript scriptPayout;
+static double dStartDifficulty = DEFAULT_STRATUM_DIFFICULTY;
+static int64_t nShareInterval = DEFAULT_STRATUM_SHARE_INTERVAL;
+static unsigned int nMaxConnections = DEFAULT_STRATUM_MAX_CONNECTIONS;
+
+/** Share target for a difficulty; difficulty 1 is the target 0x1d00ffff */
+static arith_uint256 DifficultyToTarget(double dDifficulty)
+{
+    arith_uint256 target = arith_uint256().SetCompact(0x1d00ffff);
+    target *= (uint32_t)(1 << 20);
+    target /= arith_uint256(std::max<uint64_t>(1, (uint64_t)(dDifficulty * (1 << 20))));
+    return target;
+}
+
+/** Merkle branch of the first transaction (the coinbase), from the hashes of all transactions */
+static std::vector<uint256> CoinbaseMerkleBranch(std::vector<uint256> hashes)
+{
+    std::vector<uint256> branch;
+    while (hashes.size() > 1) {
+        branch.push_back(hashes[1]);
+        if (hashes.size() & 1)
+            hashes.push_back(hashes.back());
+        std::vector<uint256> next;
+        for (size_t i = 0; i < hashes.size(); i += 2)
+            next.push_back(Hash(hashes[i].begin(), hashes[i].end(), hashes[i + 1].begin(), hashes[i + 1].end()));
+        hashes.swap(next);
+    }
+    return branch;
+}
+
+/** Previous block hash the way stratum sends it: header byte order, with the bytes of each 32-bit word swapped */
+static std::string StratumPrevHash(const uint256& hash)
+{
+    unsigned char swapped[32];
+    for (int i = 0; i < 32; i += 4)
+        WriteBE32(swapped + i, ReadLE32(hash.begin() + i));
+    return HexStr(swapped, swapped + 32);
+}
+
+static void Send(StratumClient& client, const UniValue& message)
+{
+    std::string str = message.write() + "\n";
+    bufferevent_write(client.bev, str.data(), str.size());
+}
+
+static void SendNotification(StratumClient& client, const std::string& strMethod, const UniValue& params)
+{
+    UniValue notification(UniValue::VOBJ);
+    notification.pushKV("id", NullUniValue);
+    notification.pushKV("method", strMethod);
+    notification.pushKV("params", params);
+    Send(client, notification);
+}
+
+static void SendDifficulty(StratumClient& client)
+{
+    UniValue params(UniValue::VARR);
+    params.push_back(client.dDifficulty);
+    SendNotification(client, "mining.set_difficulty", params);
+}
+
+static void SendJob(StratumClient& client, const StratumJob& job, bool fClean)
+{
+    UniValue branch(UniValue::VARR);
+    for (const uint256& hash : job.vMerkleBranch)
+        branch.push_back(HexStr(hash.begin(), hash.end()));
+
+    UniValue params(UniValue::VARR);
+    params.push_back(job.strId);
+    params.push_back(StratumPrevHash(job.block.hashPrevBlock));
+    params.push_back(HexStr(job.coinb1));
+    params.push_back(HexStr(job.coinb2));
+    params.push_back(branch);
+    params.push_back(strprintf("%08x", job.block.nVersion));
+    params.push_back(strprintf("%08x", job.block.nBits));
+    params.push_back(strprintf("%08x", job.block.nTime));
+    params.push_back(fClean);
+
+    client.dPrevDifficulty = client.dDifficulty;
+    SendNotification(client, "mining.notify", params);
+}
+
+/** Build a job from a new block template */
+static std::shared_ptr<StratumJob> NewJob()
+{
+    std::unique_ptr<CBlockTemplate> pblocktemplate(BlockAssembler(Params()).CreateNewBlock(scriptPayout));
+    if (!pblocktemplate)
+        return nullptr;
+
+    std::shared_ptr<StratumJob> job = std::make_shared<StratumJob>();
+    job->block = pblocktemplate->block;
+    int nHeight;
+    {
+        LOCK(cs_main);
+        const CBlockIndex* pindexPrev = LookupBlockIndex(job->block.hashPrevBlock);
+        if (!pindexPrev)
+            return nullptr;
+        nHeight = pindexPrev->nHeight + 1;
+    }
+
+    // Make room for the extranonces in the coinbase, and split it around them
+    CMutableTransaction txCoinbase(*job->block.vtx[0]);
+    CScript scriptHeight = CScript() << nHeight;
+    txCoinbase.vin[0].scriptSig = (CScript(scriptHeight) << std::vector<unsigned char>(EXTRANONCE1_SIZE + EXTRANONCE2_SIZE)) + COINBASE_FLAGS;
+    assert(txCoinbase.vin[0].scriptSig.size() <= 100);
+
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION | SERIALIZE_TRANSACTION_NO_WITNESS);
+    ss << txCoinbase;
+    size_t nOffset = 4 + 1 + 36 + 1 + scriptHeight.size() + 1;      // Version, input count, prevout, script length, height, extranonce push
+    assert(ss[nOffset - 1] == EXTRANONCE1_SIZE + EXTRANONCE2_SIZE);
+    job->coinb1.assign(ss.begin(), ss.begin() + nOffset);
+    job->coinb2.assign(ss.begin() + nOffset + EXTRANONCE1_SIZE + EXTRANONCE2_SIZE, ss.end());
+    job->block.vtx[0] = MakeTransactionRef(std::move(txCoinbase));
+
+    std::vector<uint256> hashes;
+    for (const CTransactionRef& tx : job->block.vtx)
+        hashes.push_back(tx->GetHash());
+    job->vMerkleBranch = CoinbaseMerkleBranch(hashes);
+
+    job->strId = strprintf("%x", ++nJobCounter);
+    return job;
+}
+
+/** Replace the current job with one from a new template, and send it to all subscribed clients */
+static void UpdateJob()
+{
+    if (IsInitialBlockDownload())
+        return;
+
+    unsigned int nTransactionsUpdated = mempool.GetTransactionsUpdated();
+    std::shared_ptr<StratumJob> job = NewJob();
+    if (!job) {
+        LogPrintf("Stratum: Couldn't create a block template\n");
+        return;
+    }
+
+    // Work on a new tip makes all older jobs stale
+    bool fClean = jobs.empty() || jobs.back()->block.hashPrevBlock != job->block.hashPrevBlock;
+    if (fClean)
+        jobs.clear();
+    jobs.push_back(job);
+    while (jobs.size() > MAX_JOBS)
+        jobs.pop_front();
+    nJobTime = GetTime();
+    nJobTransactionsUpdated = nTransactionsUpdated;
+
+    LogPrint(BCLog::STRATUM, "Stratum: New job %s (%u transactions, clean: %d) for %u clients\n", job->strId, job->block.vtx.size(), fClean, mapClients.size());
+    for (const auto& item : mapClients) {
+        if (item.second->fSubscribed)
+            SendJob(*item.second, *job, fClean);
+    }
+}
+
+/** Vardiff: after enough shares or time, move the client's difficulty towards a share every nShareInterval seconds */
+static void UpdateDifficulty(StratumClient& client, int64_t nNow)
+{
+    int64_t nElapsed = nNow - client.nRetargetTime;
+    if (client.nRetargetShares < VARDIFF_SHARES && nElapsed < VARDIFF_SHARES * nShareInterval)
+        return;
+
+    double dFactor = client.nRetargetShares * nShareInterval / (double)std::max<int64_t>(nElapsed, 1);
+    dFactor = std::max(0.25, std::min(4.0, dFactor));
+    client.nRetargetTime = nNow;
+    client.nRetargetShares = 0;
+    if (dFactor > 0.8 && dFactor < 1.25)
+        return;
+
+    client.dDifficulty = std::max(MIN_DIFFICULTY, client.dDifficulty * dFactor);
+    LogPrint(BCLog::STRATUM, "Stratum: Difficulty for %s now %g\n", client.strPeer, client.dDifficulty);
+    SendDifficulty(client);
+}
+
+static std::vector<unsigned char> ParseHexField(const UniValue& value, size_t nSize, const std::string& strName)
+{
+    if (!value.isStr() || value.get_str().size() != nSize * 2 || !IsHex(value.get_str()))
+        throw StratumError{STRATUM_OTHER, "Invalid " + strName};
+    return ParseHex(value.get_str());
+}
+
+/** mining.submit: [worker, job id, extranonce2, ntime, nonce] */
+static UniValue Submit(StratumClient& client, const UniValue& params)
+{
+    if (!client.fSubscribed)
+        throw StratumError{STRATUM_NOT_SUBSCRIBED, "Not subscribed"};
+    if (!client.fAuthorized)
+        throw StratumError{STRATUM_UNAUTHORIZED, "Unauthorized worker"};
+    if (!params.isArray() || params.size() < 5 || !params[1].isStr())
+        throw StratumError{STRATUM_OTHER, "Invalid parameters"};
+
+    std::shared_ptr<StratumJob> job;
+    for (const std::shared_ptr<StratumJob>& j : jobs) {
+        if (j->strId == params[1].get_str())
+            job = j;
+    }
+    if (!job)
+        throw StratumError{STRATUM_JOB_NOT_FOUND, "Job not found"};
+
+    std::vector<unsigned char> vExtraNonce2 = ParseHexField(params[2], EXTRANONCE2_SIZE, "extranonce2");
+    uint32_t nTime = ReadBE32(ParseHexField(params[3], 4, "ntime").data());
+    uint32_t nNonce = ReadBE32(ParseHexField(params[4], 4, "nonce").data());
+
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    if (nTime < job->block.nTime || nTime > GetAdjustedTime() + MAX_FUTURE_BLOCK_TIME)
+        throw StratumError{STRATUM_OTHER, "ntime out of range"};
+    if (nNonce == consensusParams.hiveNonceMarker || nNonce == consensusParams.popNonceMarker)
+        throw StratumError{STRATUM_OTHER, "Reserved nonce"};
+
+    // Rebuild the coinbase and block
+    std::vector<unsigned char> vCoinbase(job->coinb1);
+    vCoinbase.insert(vCoinbase.end(), client.vExtraNonce1.begin(), client.vExtraNonce1.end());
+    vCoinbase.insert(vCoinbase.end(), vExtraNonce2.begin(), vExtraNonce2.end());
+    vCoinbase.insert(vCoinbase.end(), job->coinb2.begin(), job->coinb2.end());
+    CMutableTransaction txCoinbase;
+    CDataStream ss(vCoinbase, SER_NETWORK, PROTOCOL_VERSION | SERIALIZE_TRANSACTION_NO_WITNESS);
+    ss >> txCoinbase;
+    txCoinbase.vin[0].scriptWitness = job->block.vtx[0]->vin[0].scriptWitness;
+
+    std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>(job->block);
+    pblock->vtx[0] = MakeTransactionRef(std::move(txCoinbase));
+    uint256 hashMerkleRoot = pblock->vtx[0]->GetHash();
+    for (const uint256& hash : job->vMerkleBranch)
+        hashMerkleRoot = Hash(hashMerkleRoot.begin(), hashMerkleRoot.end(), hash.begin(), hash.end());
+    pblock->hashMerkleRoot = hashMerkleRoot;
+    pblock->nTime = nTime;
+    pblock->nNonce = nNonce;
+
+    if (job->setSubmitted.count(pblock->GetHash()))
+        throw StratumError{STRATUM_DUPLICATE_SHARE, "Duplicate share"};
+
+    // A share that solves the block is always good, even if the share target is lower than the block target
+    uint256 hashPow = pblock->GetPowHash();
+    bool fBlock = CheckProofOfWork(hashPow, pblock->nBits, consensusParams);
+    if (!fBlock && UintToArith256(hashPow) > DifficultyToTarget(std::min(client.dDifficulty, client.dPrevDifficulty)))
+        throw StratumError{STRATUM_LOW_DIFFICULTY, "Low difficulty share"};
+
+    job->setSubmitted.insert(pblock->GetHash());
+    client.nRetargetShares++;
+    LogPrint(BCLog::STRATUM, "Stratum: Share from %s (%s) for job %s\n", client.strPeer, client.strWorker, job->strId);
+
+    if (fBlock) {
+        LogPrintf("Stratum: Block %s found by %s (%s)\n", pblock->GetHash().ToString(), client.strPeer, client.strWorker);
+        if (!ProcessNewBlock(Params(), pblock, true, nullptr))
+            LogPrintf("Stratum: WARNING: Block was not accepted\n");
+    }
+
+    UpdateDifficulty(client, GetTime());
+    return true;
+}
+
+static void HandleRequest(StratumClient& client, const std::string& strLine)
+{
+    UniValue request;
+    if (!request.read(strLine) || !request.isObject()) {
+        LogPrint(BCLog::STRATUM, "Stratum: Malformed request from %s\n", client.strPeer);
+        client.fDisconnect = true;
+        return;
+    }
+    const UniValue& id = find_value(request, "id");
+    const UniValue& method = find_value(request, "method");
+    const UniValue& params = find_value(request, "params");
+
+    try {
+        if (!method.isStr())
+            throw StratumError{STRATUM_OTHER, "Missing method"};
+        const std::string& strMethod = method.get_str();
+
+        if (strMethod == "mining.subscribe") {
+            UniValue subscription(UniValue::VARR), subscriptions(UniValue::VARR);
+            std::string strSubscriptionId = HexStr(client.vExtraNonce1);
+            subscription.push_back("mining.set_difficulty");
+            subscription.push_back(strSubscriptionId);
+            subscriptions.push_back(subscription);
+            subscription = UniValue(UniValue::VARR);
+            subscription.push_back("mining.notify");
+            subscription.push_back(strSubscriptionId);
+            subscriptions.push_back(subscription);
+
+            UniValue result(UniValue::VARR);
+            result.push_back(subscriptions);
+            result.push_back(HexStr(client.vExtraNonce1));
+            result.push_back((int)EXTRANONCE2_SIZE);
+            Send(client, JSONRPCReplyObj(result, NullUniValue, id));
+
+            client.fSubscribed = true;
+            SendDifficulty(client);
+            if (!jobs.empty())
+                SendJob(client, *jobs.back(), true);
+        } else if (strMethod == "mining.authorize") {
+            if (params.isArray() && params.size() > 0 && params[0].isStr())
+                client.strWorker = params[0].get_str();
+            client.fAuthorized = true;
+            Send(client, JSONRPCReplyObj(true, NullUniValue, id));
+        } else if (strMethod == "mining.submit") {
+            Send(client, JSONRPCReplyObj(Submit(client, params), NullUniValue, id));
+        } else if (strMethod == "mining.extranonce.subscribe") {
+            Send(client, JSONRPCReplyObj(true, NullUniValue, id));     // Extranonce1 never changes for a connection
+        } else {
+            throw StratumError{STRATUM_OTHER, "Method not found"};
+        }
+    } catch (const StratumError& e) {
+        UniValue error(UniValue::VARR);
+        error.push_back(e.code);
+        error.push_back(e.message);
+        error.push_back(NullUniValue);
+        Send(client, JSONRPCReplyObj(NullUniValue, error, id));
+    } catch (const std::exception& e) {
+        LogPrint(BCLog::STRATUM, "Stratum: Bad request from %s: %s\n", client.strPeer, e.what());
+        client.fDisconnect = true;
+    }
+}
+
+static void RemoveClient(struct bufferevent* bev)
+{
+    auto it = mapClients.find(bev);
+    if (it != mapClients.end()) {
+        LogPrint(BCLog::STRATUM, "Stratum: %s disconnected\n", it->second->strPeer);
+        mapClients.erase(it);
+    }
+    bufferevent_free(bev);
+}
+
+static void stratum_read_cb(struct bufferevent* bev, void*)
+{
+    auto it = mapClients.find(bev);
+    if (it == mapClients.end())
+        return;
+    StratumClient& client = *it->second;
+
+    struct evbuffer* input = bufferevent_get_input(bev);
+    size_t n_read_out = 0;
+    char* line;
+    while (!client.fDisconnect && (line = evbuffer_readln(input, &n_read_out, EVBUFFER_EOL_CRLF)) != nullptr) {
+        std::string strLine(line, n_read_out);
+        free(line);
+        if (!strLine.empty())
+            HandleRequest(client, strLine);
+    }
+    if (client.fDisconnect || evbuffer_get_length(input) > MAX_LINE_SIZE)
+        RemoveClient(bev);
+}
+
+static void stratum_event_cb(struct bufferevent* bev, short what, void*)
+{
+    if (what & (BEV_EVENT_EOF | BEV_EVENT_ERROR))
+        RemoveClient(bev);
+}
+
+static void stratum_accept_cb(struct evconnlistener*, evutil_socket_t fd, struct sockaddr* addr, int, void*)
+{
+    CService peer;
+    peer.SetSockAddr(addr);
+    if (mapClients.size() >= nMaxConnections) {
+        LogPrint(BCLog::STRATUM, "Stratum: Connection from %s refused, too many connections\n", peer.ToString());
+        evutil_closesocket(fd);
+        return;
+    }
+
+    struct bufferevent* bev = bufferevent_socket_new(eventBase, fd, BEV_OPT_CLOSE_ON_FREE);
+    if (!bev) {
+        evutil_closesocket(fd);
+        return;
+    }
+
+    std::unique_ptr<StratumClient> client(new StratumClient());
+    client->bev = bev;
+    client->strPeer = peer.ToString();
+    client->vExtraNonce1.resize(EXTRANONCE1_SIZE);
+    WriteBE32(client->vExtraNonce1.data(), nExtraNonce1Next++);
+    client->dDifficulty = client->dPrevDifficulty = dStartDifficulty;
+    client->nRetargetTime = GetTime();
+    LogPrint(BCLog::STRATUM, "Stratum: %s connected\n", client->strPeer);
+    mapClients[bev] = std::move(client);
+
+    bufferevent_setcb(bev, stratum_read_cb, nullptr, stratum_event_cb, nullptr);
+    bufferevent_enable(bev, EV_READ | EV_WRITE);
+}
+
+/** Periodic refresh: replace a missing or stale job, and retarget idle connections */
+static void stratum_refresh_cb(evutil_socket_t, short, void*)
+{
+    bool fUpdate = jobs.empty();
+    if (!fUpdate && mempool.GetTransactionsUpdated() != nJobTransactionsUpdated && GetTime() - nJobTime >= JOB_MAX_AGE)
+        fUpdate = true;
+    if (!fUpdate) {
+        LOCK(cs_main);
+        fUpdate = chainActive.Tip() && chainActive.Tip()->GetBlockHash() != jobs.back()->block.hashPrevBlock;
+    }
+    if (fUpdate)
+        UpdateJob();
+
+    int64_t nNow = GetTime();
+    for (const auto& item : mapClients) {
+        if (item.second->fSubscribed)
+            UpdateDifficulty(*item.second, nNow);
+    }
+}
+
+/** Pushes new work to miners as soon as the tip changes */
+class StratumNotifier final : public CValidationInterface
+{
+protected:
+    void UpdatedBlockTip(const CBlockIndex* pindexNew, const CBlockIndex* pindexFork, bool fInitialDownload) override
+    {
+        if (fInitialDownload || !eventBase)
+            return;
+        event_base_once(eventBase, -1, EV_TIMEOUT, [](evutil_socket_t, short, void*) {
+            UpdateJob();
+        }, nullptr, nullptr);
+    }
+};
+
+static std::unique_ptr<StratumNotifier> notifier;
+
+static void ThreadStratum()
+{
+    event_base_dispatch(eventBase);
+}
+
+bool InitStratumServer()
+{
+    std::string strAddress = gArgs.GetArg("-stratumaddress", "");
+    CTxDestination dest = DecodeDestination(strAddress);
+    if (!IsValidDestination(dest)) {
+        LogPrintf("Stratum: -stratumaddress must be set to a valid address to pay block rewards to\n");
+        return false;
+    }
+    scriptPayout = GetScriptForDestination(dest);
+    dStartDifficulty = std::max(MIN_DIFFICULTY, atof(gArgs.GetArg("-stratumdifficulty", std::to_string(DEFAULT_STRATUM_DIFFICULTY)).c_str()));
+    nShareInterval = std::max<int64_t>(1, gArgs.GetArg("-stratumshareinterval", DEFAULT_STRATUM_SHARE_INTERVAL));
+    nMaxConnections = std::max<int64_t>(1, gArgs.GetArg("-stratummaxconnections", DEFAULT_STRATUM_MAX_CONNECTIONS));
+
+#ifdef WIN32
+    evthread_use_windows_threads();
+#else
+    evthread_use_pthreads();
+#endif
+    eventBase = event_base_new();
+    if (!eventBase) {
+        LogPrintf("Stratum: Unable to create event_base\n");
+        return false;
+    }
+
+    // Bind to loopback unless told otherwise
+    int nPort = gArgs.GetArg("-stratumport", DEFAULT_STRATUM_PORT);
+    std::vector<std::string> vBind = gArgs.GetArgs("-stratumbind");
+    if (vBind.empty()) {
+        vBind.push_back("::1");
+        vBind.push_back("127.0.0.1");
+    }
+    for (const std::string& strBind : vBind) {
+        int port = nPort;
+        std::string host;
+        SplitHostPort(strBind, port, host);
+        CService addrBind;
+        struct sockaddr_storage sockaddr;
+        socklen_t len = sizeof(sockaddr);
+        if (!Lookup(host.c_str(), addrBind, port, false) || !addrBind.GetSockAddr((struct sockaddr*)&sockaddr, &len)) {
+            LogPrintf("Stratum: Invalid bind address %s\n", strBind);
+            continue;
+        }
+        struct evconnlistener* listener = evconnlistener_new_bind(eventBase, stratum_accept_cb, nullptr, LEV_OPT_CLOSE_ON_FREE | LEV_OPT_REUSEABLE, -1, (struct sockaddr*)&sockaddr, len);
+        if (!listener) {
+            LogPrintf("Stratum: Binding on %s failed\n", addrBind.ToString());
+            continue;
+        }
+        if (addrBind.IsBindAny())
+            LogPrintf("WARNING: the stratum server is not safe to expose to untrusted networks such as the public internet\n");
+        LogPrintf("Stratum: Listening on %s\n", addrBind.ToString());
+        vListeners.push_back(listener);
+    }
+    if (vListeners.empty()) {
+        LogPrintf("Stratum: Unable to bind any endpoint\n");
+        return false;
+    }
+
+    eventRefresh = event_new(eventBase, -1, EV_PERSIST, stratum_refresh_cb, nullptr);
+    struct timeval tv = {REFRESH_INTERVAL, 0};
+    event_add(eventRefresh, &tv);
+
+    notifier = MakeUnique<StratumNotifier>();
+    RegisterValidationInterface(notifier.get());
+    return true;
+}
+
+void StartStratumServer()
+{
+    if (!eventBase)
+        return;
+    // First job as soon as the event loop runs
+    event_base_once(eventBase, -1, EV_TIMEOUT, [](evutil_socket_t, short, void*) {
+        UpdateJob();
+    }, nullptr, nullptr);
+    threadStratum = std::thread(std::bind(&TraceThread<void (*)()>, "stratum", &ThreadStratum));
+}
+
+void InterruptStratumServer()
+{
+    if (eventBase) {
+        event_base_once(eventBase, -1, EV_TIMEOUT, [](evutil_socket_t, short, void*) {
+            event_base_loopbreak(eventBase);
+        }, nullptr, nullptr);
+    }
+}
+
+void StopStratumServer()
+{
+    if (notifier) {
+        UnregisterValidationInterface(notifier.get());
+        notifier.reset();
+    }
+    if (threadStratum.joinable())
+        threadStratum.join();
+    for (auto& item : mapClients)
+        bufferevent_free(item.first);
+    mapClients.clear();
+    jobs.clear();
+    for (struct evconnlistener* listener : vListeners)
+        evconnlistener_free(listener);
+    vListeners.clear();
+    if (eventRefresh) {
+        event_free(eventRefresh);
+        eventRefresh = nullptr;
+    }
+    if (eventBase) {
+        event_base_free(eventBase);
+        eventBase = nullptr;
+    }
+}
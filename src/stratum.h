@@ -0,0 +1,35 @@
+// Copyright (c) 2019 The Ring Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Ring-fork: Stratum work server
+
+/**
+ * Work server for external miners, speaking stratum v1 (mining.subscribe, mining.authorize,
+ * mining.set_difficulty, mining.notify and mining.submit as line-delimited JSON over TCP).
+ * Each connection gets its own extranonce1 and its own (variable) share difficulty; new work
+ * is pushed to all connections as soon as the tip changes.
+ */
+#ifndef RING_STRATUM_H
+#define RING_STRATUM_H
+
+#include <stdint.h>
+
+static const bool DEFAULT_STRATUM = false;
+static const uint16_t DEFAULT_STRATUM_PORT = 3333;
+/** Share difficulty new connections start at (difficulty 1 is a target of 0x1d00ffff) */
+static const double DEFAULT_STRATUM_DIFFICULTY = 0.001;
+/** Seconds between shares that vardiff aims for on each connection */
+static const int64_t DEFAULT_STRATUM_SHARE_INTERVAL = 15;
+static const unsigned int DEFAULT_STRATUM_MAX_CONNECTIONS = 256;
+
+/** Initialize the stratum server: read its settings and bind. Returns false on failure. */
+bool InitStratumServer();
+/** Start the stratum server's event thread */
+void StartStratumServer();
+/** Interrupt the stratum server's event loop */
+void InterruptStratumServer();
+/** Stop the stratum server, dropping all connections */
+void StopStratumServer();
+
+#endif // RING_STRATUM_H
@@ -2,7 +2,10 @@
 
 #include <stdlib.h>
 
+#include <chain.h>
+#include <clientversion.h>
 #include <rpc/blockchain.h>
+#include <streams.h>
 #include <test/test_ring.h>
 
 /* Equality between doubles is imprecise. Comparison should be done
@@ -68,4 +71,33 @@ BOOST_AUTO_TEST_CASE(get_difficulty_for_very_high_target)
     TestDifficulty(0x12345678, 5913134931067755359633408.0);
 }
 
+// Ring-fork: Block index entries carry the pow hash when it's known, and entries without it still read
+BOOST_AUTO_TEST_CASE(disk_block_index_pow_hash)
+{
+    CBlockIndex index;
+    index.nVersion = 0x20000000;
+    index.hashMerkleRoot = InsecureRand256();
+    index.nTime = 1556000000;
+    index.nBits = 0x1e0fffff;
+    index.nNonce = 12345;
+
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << CDiskBlockIndex(&index);
+    size_t sizeWithoutPowHash = ss.size();
+    CDiskBlockIndex read;
+    ss >> read;
+    BOOST_CHECK(read.hashPow.IsNull());
+    BOOST_CHECK(read.GetBlockHash() == CDiskBlockIndex(&index).GetBlockHash());
+    BOOST_CHECK(read.GetBlockPowHash() == index.GetBlockHeader().GetPowHash());
+
+    index.hashPow = index.GetBlockHeader().GetPowHash();
+    ss << CDiskBlockIndex(&index);
+    BOOST_CHECK_EQUAL(ss.size(), sizeWithoutPowHash + 32);
+    CDiskBlockIndex readWithPowHash;
+    ss >> readWithPowHash;
+    BOOST_CHECK(ss.empty());
+    BOOST_CHECK(readWithPowHash.hashPow == index.hashPow);
+    BOOST_CHECK(readWithPowHash.GetBlockPowHash() == index.hashPow);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,133 @@
+// Copyright (c) 2019 The Ring Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Ring-fork: Pop: Game0 verifier tests
+
+#include <crypto/pop/game0/game0.h>
+#include <crypto/pop/game0/game0bitboard.h>
+#include <crypto/pop/game0/game0solver.h>
+#include <random.h>
+#include <uint256.h>
+#include <test/test_ring.h>
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(game0_tests, BasicTestingSetup)
+
+// Play a game to completion (or until no legal move turns up), placing tiles at random
+static std::vector<unsigned char> PlayRandomGame(const uint256& gameSourceHash, int nTiles)
+{
+    Game0 game;
+    game.InitGame(gameSourceHash);
+    std::string strError;
+    for (int i = 0; i < nTiles; i++) {
+        bool fPlaced = false;
+        for (int attempt = 0; attempt < 200 && !fPlaced; attempt++)
+            fPlaced = game.PlaceTile(InsecureRandRange(GAME0_BOARD_SIZE), InsecureRandRange(GAME0_BOARD_SIZE), InsecureRandRange(4), strError);
+        if (!fPlaced)
+            break;
+    }
+    return game.GetSolution();
+}
+
+// The bitboard verifier must accept and reject exactly what Game0::VerifyGameSolution does, with the same errors
+static void CheckSameVerdict(const uint256& gameSourceHash, const std::vector<unsigned char>& solution)
+{
+    int targetScore = InsecureRandRange(120);
+
+    Game0 game;
+    std::string strErrorExpected, strError;
+    bool fExpected = game.VerifyGameSolution(targetScore, gameSourceHash, solution, strErrorExpected);
+    bool fResult = VerifyGame0Solution(targetScore, gameSourceHash, solution, strError);
+    BOOST_CHECK_EQUAL(fResult, fExpected);
+    BOOST_CHECK_EQUAL(strError, strErrorExpected);
+
+    // For legal move sequences, the boards must score the same
+    Game0Bitboard board;
+    if (board.Replay(gameSourceHash, solution.data(), solution.size()) == Game0Bitboard::GAME0_OK) {
+        std::string strDesc;
+        BOOST_CHECK_EQUAL(board.CalculateScore(), game.CalculateScore(strDesc));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(game0_bitboard_matches_reference)
+{
+    for (int i = 0; i < 3000; i++) {
+        const uint256 gameSourceHash = InsecureRand256();
+        std::vector<unsigned char> solution = PlayRandomGame(gameSourceHash, InsecureRandRange(GAME0_BOARD_CELLS + 1));
+
+        switch (i % 3) {
+            case 0:     // A legal game
+                break;
+            case 1:     // A legal game with a bit flipped in one move
+                if (!solution.empty())
+                    solution[InsecureRandRange(solution.size())] ^= 1 << InsecureRandRange(8);
+                break;
+            case 2:     // Noise, including moves off the board and too many moves
+                solution = g_insecure_rand_ctx.randbytes(InsecureRandRange(GAME0_BOARD_CELLS + 3));
+                break;
+        }
+
+        CheckSameVerdict(gameSourceHash, solution);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(game0_bitboard_errors)
+{
+    const uint256 gameSourceHash = InsecureRand256();
+    std::string strError;
+
+    BOOST_CHECK(!VerifyGame0Solution(0, gameSourceHash, std::vector<unsigned char>(GAME0_BOARD_CELLS + 1, 0), strError));
+    BOOST_CHECK_EQUAL(strError, "Impossible solution size");
+
+    BOOST_CHECK(!VerifyGame0Solution(0, gameSourceHash, {7 << 3}, strError));
+    BOOST_CHECK_EQUAL(strError, "Attempted out-of-range placement");
+
+    BOOST_CHECK(!VerifyGame0Solution(0, gameSourceHash, {0, 0}, strError));
+    BOOST_CHECK_EQUAL(strError, "Attempted to place on an occupied tile");
+
+    BOOST_CHECK(!VerifyGame0Solution(0, gameSourceHash, {0, 2}, strError));
+    BOOST_CHECK_EQUAL(strError, "Attempted to place without occupied neighbour");
+
+    // An empty board scores nothing
+    BOOST_CHECK(VerifyGame0Solution(0, gameSourceHash, {}, strError));
+    BOOST_CHECK(!VerifyGame0Solution(1, gameSourceHash, {}, strError));
+    BOOST_CHECK_EQUAL(strError, "Solution does not meet score target; score=0, target=1");
+}
+
+// Solutions from the solver must pass the reference verifier
+BOOST_AUTO_TEST_CASE(game0_solver_solves)
+{
+    for (int i = 0; i < 2; i++) {
+        const uint256 gameSourceHash = InsecureRand256();
+        Game0SolverResult result = SolveGame0(gameSourceHash, 50, 1 + i, 16, nullptr);
+        BOOST_CHECK(result.fSolved);
+        BOOST_CHECK(result.nScore >= 50);
+        BOOST_CHECK(result.nPositions > 0);
+
+        Game0 game;
+        std::string strError;
+        BOOST_CHECK_MESSAGE(game.VerifyGameSolution(50, gameSourceHash, result.solution, strError), strError);
+    }
+}
+
+// An interrupted search reports the best (legal) position seen so far
+BOOST_AUTO_TEST_CASE(game0_solver_interrupt)
+{
+    const uint256 gameSourceHash = InsecureRand256();
+    int nPolls = 0;
+    Game0SolverResult result = SolveGame0(gameSourceHash, 1000, 2, 16, [&nPolls]() { return ++nPolls > 5; });
+    BOOST_CHECK(!result.fSolved);
+    BOOST_CHECK_EQUAL(result.nPasses, 1);
+    BOOST_CHECK(result.solution.size() <= 5);
+
+    Game0 game;
+    std::string strError;
+    BOOST_CHECK_MESSAGE(game.VerifyGameSolution(result.nScore, gameSourceHash, result.solution, strError), strError);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,224 @@
+// Copyright (c) 2019 The Ring Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chainparams.h>
+#include <consensus/validation.h>
+#include <index/hiveindex.h>
+#include <key_io.h>
+#include <pow.h>
+#include <script/sign.h>
+#include <script/standard.h>
+#include <test/test_ring.h>
+#include <util/time.h>
+#include <validation.h>
+#include <validationinterface.h>
+
+#include <boost/test/unit_test.hpp>
+
+// Filled by the disk scan in GetNetworkHiveInfo
+extern DwarfPopGraphPoint dwarfPopGraph[1024*40];
+
+BOOST_AUTO_TEST_SUITE(hiveindex_tests)
+
+static bool IndexAnswers(const HiveIndex& hiveindex, const CBlockIndex* pindex, int& immatureDwarves, int& matureDwarves)
+{
+    int immatureDCTs, matureDCTs;
+    return hiveindex.GetNetworkHiveInfo(pindex, Params().GetConsensus(), immatureDwarves, immatureDCTs, matureDwarves, matureDCTs);
+}
+
+BOOST_FIXTURE_TEST_CASE(hiveindex_follows_chain, TestChain100Setup)
+{
+    HiveIndex hiveindex(1 << 20, true);
+    int immatureDwarves, matureDwarves;
+
+    // Nothing is answered before the index is started.
+    BOOST_CHECK(!IndexAnswers(hiveindex, chainActive.Tip(), immatureDwarves, matureDwarves));
+    BOOST_CHECK(!hiveindex.BlockUntilSyncedToCurrentChain());
+
+    hiveindex.Start();
+
+    // Allow the index to catch up with the block index.
+    constexpr int64_t timeout_ms = 10 * 1000;
+    int64_t time_start = GetTimeMillis();
+    while (!hiveindex.BlockUntilSyncedToCurrentChain()) {
+        BOOST_REQUIRE(time_start + timeout_ms > GetTimeMillis());
+        MilliSleep(100);
+    }
+
+    // The index answers for the tip only; the test chain has no DCTs.
+    BOOST_CHECK(IndexAnswers(hiveindex, chainActive.Tip(), immatureDwarves, matureDwarves));
+    BOOST_CHECK_EQUAL(immatureDwarves, 0);
+    BOOST_CHECK_EQUAL(matureDwarves, 0);
+    BOOST_CHECK(!IndexAnswers(hiveindex, chainActive.Tip()->pprev, immatureDwarves, matureDwarves));
+
+    // New blocks are followed.
+    CScript coinbase_script_pub_key = GetScriptForDestination(coinbaseKey.GetPubKey().GetID());
+    std::vector<CMutableTransaction> no_txns;
+    for (int i = 0; i < 5; i++) {
+        CreateAndProcessBlock(no_txns, coinbase_script_pub_key);
+        BOOST_CHECK(hiveindex.BlockUntilSyncedToCurrentChain());
+        BOOST_CHECK(IndexAnswers(hiveindex, chainActive.Tip(), immatureDwarves, matureDwarves));
+    }
+
+    // Disconnecting the tip moves the index back with it.
+    CBlockIndex* pindex_invalid = chainActive.Tip();
+    CValidationState state;
+    BOOST_CHECK(InvalidateBlock(state, Params(), pindex_invalid));
+    SyncWithValidationInterfaceQueue();
+    BOOST_CHECK(!IndexAnswers(hiveindex, pindex_invalid, immatureDwarves, matureDwarves));
+    BOOST_CHECK(IndexAnswers(hiveindex, chainActive.Tip(), immatureDwarves, matureDwarves));
+
+    // And a block on the new branch is followed again.
+    CreateAndProcessBlock(no_txns, coinbase_script_pub_key);
+    BOOST_CHECK(hiveindex.BlockUntilSyncedToCurrentChain());
+    BOOST_CHECK(IndexAnswers(hiveindex, chainActive.Tip(), immatureDwarves, matureDwarves));
+
+    // shutdown sequence (c.f. Shutdown() in init.cpp)
+    hiveindex.Stop();
+
+    threadGroup.interrupt_all();
+    threadGroup.join_all();
+
+    // Rest of shutdown sequence and destructors happen in ~TestingSetup()
+}
+
+// A regtest chain that can hold DCTs. Regtest has no hive parameters, so this test's params get some; params are
+// selected afresh for each test.
+struct HiveIndexDCTSetup : public TestChain100Setup {
+    HiveIndexDCTSetup()
+    {
+        Consensus::Params& consensusParams = const_cast<Consensus::Params&>(Params().GetConsensus());
+        CKey creationKey, communityKey;
+        creationKey.MakeNewKey(true);
+        communityKey.MakeNewKey(true);
+        consensusParams.dwarfCost = CENT;
+        consensusParams.dwarfCreationAddress = EncodeDestination(CTxDestination(creationKey.GetPubKey().GetID()));
+        consensusParams.hiveCommunityAddress = EncodeDestination(CTxDestination(communityKey.GetPubKey().GetID()));
+        consensusParams.communityContribFactor = 5;
+        consensusParams.dwarfGestationBlocks = 3;
+        consensusParams.dwarfLifespanBlocks = 5;
+        consensusParams.minHiveCheckBlock = 0;
+        consensusParams.hiveBlockSpacingTargetTypical = 2;
+        consensusParams.popBlocksPerHive = 1;
+    }
+
+    // A DCT for nDwarves dwarves, spending the given mature coinbase; with fCommunityContrib, part of the cost goes to
+    // the community fund
+    CMutableTransaction CreateDCT(size_t nCoinbase, int nDwarves, bool fCommunityContrib)
+    {
+        const Consensus::Params& consensusParams = Params().GetConsensus();
+        const CTransactionRef& coinbase = m_coinbase_txns[nCoinbase];
+        const CAmount cost = nDwarves * consensusParams.dwarfCost;
+        BOOST_REQUIRE(coinbase->vout[0].nValue >= cost);
+
+        CScript scriptPubKeyDCT = GetScriptForDestination(DecodeDestination(consensusParams.dwarfCreationAddress));
+        CScript scriptPubKeyReward = GetScriptForDestination(coinbaseKey.GetPubKey().GetID());
+        scriptPubKeyDCT << OP_RETURN << OP_DWARF;
+        scriptPubKeyDCT.insert(scriptPubKeyDCT.end(), scriptPubKeyReward.begin(), scriptPubKeyReward.end());
+
+        CMutableTransaction dct;
+        dct.nVersion = 1;
+        dct.vin.resize(1);
+        dct.vin[0].prevout = COutPoint(coinbase->GetHash(), 0);
+        if (fCommunityContrib) {
+            const CAmount donation = cost / consensusParams.communityContribFactor;
+            dct.vout.emplace_back(cost - donation, scriptPubKeyDCT);
+            dct.vout.emplace_back(donation, GetScriptForDestination(DecodeDestination(consensusParams.hiveCommunityAddress)));
+        } else {
+            dct.vout.emplace_back(cost, scriptPubKeyDCT);
+        }
+
+        std::vector<unsigned char> vchSig;
+        uint256 hash = SignatureHash(coinbase->vout[0].scriptPubKey, dct, 0, SIGHASH_ALL, 0, SigVersion::BASE);
+        BOOST_REQUIRE(coinbaseKey.Sign(hash, vchSig));
+        vchSig.push_back((unsigned char)SIGHASH_ALL);
+        dct.vin[0].scriptSig << vchSig;
+        return dct;
+    }
+};
+
+// The index must answer for the tip exactly as the disk scan GetNetworkHiveInfo falls back to, graph included
+static void CheckMatchesDiskScan(HiveIndex& hiveindex, int& matureDwarves)
+{
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    const int totalDwarfLifespan = consensusParams.dwarfGestationBlocks + consensusParams.dwarfLifespanBlocks;
+    BOOST_REQUIRE(hiveindex.BlockUntilSyncedToCurrentChain());
+
+    LOCK(cs_main);
+    BOOST_REQUIRE(!g_hiveindex);
+    int immatureDwarves, immatureDCTs, matureDCTs;
+    CAmount potentialLifespanRewards;
+    BOOST_REQUIRE(GetNetworkHiveInfo(immatureDwarves, immatureDCTs, matureDwarves, matureDCTs, potentialLifespanRewards, consensusParams, true));
+
+    int indexImmatureDwarves, indexImmatureDCTs, indexMatureDwarves, indexMatureDCTs;
+    std::vector<DwarfPopGraphPoint> graph(totalDwarfLifespan);
+    BOOST_REQUIRE(hiveindex.GetNetworkHiveInfo(chainActive.Tip(), consensusParams, indexImmatureDwarves, indexImmatureDCTs, indexMatureDwarves, indexMatureDCTs, graph.data()));
+    BOOST_CHECK_EQUAL(indexImmatureDwarves, immatureDwarves);
+    BOOST_CHECK_EQUAL(indexImmatureDCTs, immatureDCTs);
+    BOOST_CHECK_EQUAL(indexMatureDwarves, matureDwarves);
+    BOOST_CHECK_EQUAL(indexMatureDCTs, matureDCTs);
+    for (int pos = 1; pos < totalDwarfLifespan; pos++) {
+        BOOST_CHECK_EQUAL(graph[pos].immaturePop, dwarfPopGraph[pos].immaturePop);
+        BOOST_CHECK_EQUAL(graph[pos].maturePop, dwarfPopGraph[pos].maturePop);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(hiveindex_matches_disk_scan, HiveIndexDCTSetup)
+{
+    HiveIndex hiveindex(1 << 20, true);
+    hiveindex.Start();
+
+    constexpr int64_t timeout_ms = 10 * 1000;
+    int64_t time_start = GetTimeMillis();
+    while (!hiveindex.BlockUntilSyncedToCurrentChain()) {
+        BOOST_REQUIRE(time_start + timeout_ms > GetTimeMillis());
+        MilliSleep(100);
+    }
+
+    // Blocks with DCTs, some paying the community fund, and some without; each new tip moves every window
+    CScript coinbase_script_pub_key = GetScriptForDestination(coinbaseKey.GetPubKey().GetID());
+    int matureDwarves;
+    for (int i = 0; i < 10; i++) {
+        std::vector<CMutableTransaction> txns;
+        if (i % 3 != 2)
+            txns.push_back(CreateDCT(i, 2 + i, i % 2));
+        CreateAndProcessBlock(txns, coinbase_script_pub_key);
+        CheckMatchesDiskScan(hiveindex, matureDwarves);
+    }
+    BOOST_CHECK(matureDwarves > 0);
+
+    // Disconnecting blocks with DCTs truncates the totals
+    CBlockIndex* pindexOldTip = chainActive.Tip();
+    CBlockIndex* pindexFork = chainActive[pindexOldTip->nHeight - 2];
+    CValidationState state;
+    BOOST_CHECK(InvalidateBlock(state, Params(), pindexFork));
+    SyncWithValidationInterfaceQueue();
+    mempool.clear();
+    CheckMatchesDiskScan(hiveindex, matureDwarves);
+
+    // A shorter branch with other DCTs replaces them
+    for (size_t nCoinbase : {2, 5}) {
+        CreateAndProcessBlock({CreateDCT(nCoinbase, 7, false)}, coinbase_script_pub_key);
+        CheckMatchesDiskScan(hiveindex, matureDwarves);
+    }
+    BOOST_CHECK(chainActive.Tip()->GetAncestor(pindexFork->nHeight) != pindexFork);
+
+    // Reorging back onto the longer branch replaces them again
+    {
+        LOCK(cs_main);
+        ResetBlockFailureFlags(pindexFork);
+    }
+    BOOST_CHECK(ActivateBestChain(state, Params()));
+    SyncWithValidationInterfaceQueue();
+    mempool.clear();
+    BOOST_CHECK(chainActive.Tip() == pindexOldTip);
+    CheckMatchesDiskScan(hiveindex, matureDwarves);
+
+    hiveindex.Stop();
+
+    threadGroup.interrupt_all();
+    threadGroup.join_all();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -8,6 +8,7 @@
 #include <consensus/merkle.h>
 #include <consensus/tx_verify.h>
 #include <consensus/validation.h>
+#include <crypto/pow/minotaur.h>
 #include <validation.h>
 #include <miner.h>
 #include <policy/policy.h>
@@ -521,4 +522,44 @@ BOOST_AUTO_TEST_CASE(CreateNewBlock_validity)
     fCheckpointsEnabled = true;
 }
 
+// Ring-fork: In-wallet miner: ScanHash counts each nonce it passes exactly once, and checks every one against the target
+BOOST_AUTO_TEST_CASE(ScanHash_counters)
+{
+    CBlockHeader header;
+    header.nVersion = 0x20000000;
+    header.hashPrevBlock = uint256S("00000000000b1cf0e5a1c4e1b9d7c4a2f7f00e5d1a7b3c2d9e8f7a6b5c4d3e2f1");
+    header.hashMerkleRoot = uint256S("4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b");
+    header.nTime = 1557331200;
+    header.nBits = 0x1e0fffff;
+    const arith_uint256 hashTarget = ~arith_uint256() >> 11;     // About one hash in 2048 meets it, and one in 8 is near it
+
+    // Scan up to the nonce space's next pause, 4096 nonces on, restarting after each solution the way the miner does
+    const uint32_t nStart = 0x10000 - 4096;
+    uint32_t nNonce = nStart;
+    std::atomic<uint64_t> nHashes(0), nNearTarget(0);
+    std::vector<uint32_t> vSolutions;
+    uint256 hash;
+    while (ScanHash(&header, nNonce, &hash, hashTarget, nHashes, nNearTarget, 0)) {
+        BOOST_CHECK_EQUAL(header.nNonce, nNonce);
+        BOOST_CHECK(hash == header.GetPowHash());
+        vSolutions.push_back(nNonce);
+    }
+    BOOST_CHECK(nNonce > 0x10000 && nNonce <= 0x10000 + MinotaurBatch::MAX_LANES);
+
+    // The same nonces, one at a time
+    uint64_t nExpectedNearTarget = 0;
+    std::vector<uint32_t> vExpectedSolutions;
+    for (uint32_t n = nStart + 1; n <= nNonce; n++) {
+        header.nNonce = n;
+        arith_uint256 hashArith = UintToArith256(header.GetPowHash());
+        if ((hashArith >> MINER_NEAR_TARGET_BITS) <= hashTarget)
+            nExpectedNearTarget++;
+        if (hashArith <= hashTarget)
+            vExpectedSolutions.push_back(n);
+    }
+    BOOST_CHECK_EQUAL(nHashes.load(), nNonce - nStart);
+    BOOST_CHECK_EQUAL(nNearTarget.load(), nExpectedNearTarget);
+    BOOST_CHECK(vSolutions == vExpectedSolutions);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
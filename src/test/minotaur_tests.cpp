@@ -0,0 +1,137 @@
+// Copyright (c) 2019 The Ring Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Ring-fork: Minotaur hash algorithm tests
+
+#include <crypto/pow/minotaur.h>
+#include <random.h>
+#include <uint256.h>
+#include <util/strencodings.h>
+#include <test/test_ring.h>
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(minotaur_tests, BasicTestingSetup)
+
+// Each algo run over the 64 bytes 0x00 - 0x3f, via whichever implementation MinotaurAutoDetect() picked
+BOOST_AUTO_TEST_CASE(minotaur_algo_testvectors)
+{
+    static const std::string expected[MINOTAUR_ALGO_COUNT] = {
+        "4d47291b807750d2ce6ced17ae71dc24f5a3205f4fe309537488242c4420cd32d997beda4d560200cbcf3e9d68143e69f08c54b82ce77db7c22d0e17b5a1363e", // blake512
+        "824168671c2e3f35ebba82b63b9e6c42b8411cdcda1041264bb5f50abd507d1827edcfff050f6c8675cb8ccba8699c843dcf5fb81ccadab1deef0d9cf4770257", // bmw512
+        "501336304d235cf9825da6f26623f20cf338c2efa1eac0f668dc1d99a1f67bf617453a1c861c9628f7b98dd5ca50baf6d75299f13fa43d28d39b40314161135f", // cubehash512
+        "2f7a64cec7e07c9d791f902b838e9a776c03da43ef8858e89c16bbfa7eff641d5e309d9a51e13177cbb86fb1021070c64763fa93b39824dafd773154cf2ec058", // echo512
+        "8daf6fdf358c3c83179afc8d072d5f8b648237175e6c82aa7ca4c376ce7ef6f0fb85e4d7b8eec86b5b1dd06b2bf2c9bc0ec61cee1e3202a004e5ed28ae90c98b", // fugue512
+        "6e8c9b90e36cea68c029a7d8b95b718c84205d81be227ba61510f567d46b83edd11f301bf1e7041be991b22fdbee82dbdce7ab0e0ee42a795ca965a439532a39", // groestl512
+        "f8c6d6ab542ce32043e06a04a37ee4116652adc877b360dc1232e3f095b2949560536b795b189b393b3c4459dec7cfb0eab0030d6190770de849381232e816b4", // hamsi512
+        "ee4320ebaf3fdb4f2c832b137200c08e235e0fa7bbd0eb1740c7063ba8a0d151da77e003398e1714a955d475b05e3e950b639503b452ec185de4229bc4873949", // sha512
+        "483560d10cadec86db6f390f6267e12f99594587d44c202902e8e4bb6c70c6c7fdff6b19965650e15e240bcfcefe4e5051567ef96c758b800efdcaf50a5d5bbd", // jh512
+        "59bff1edb37c403bea6387e283c5d4d8878246592807d22328fbc11ec1e029cdb6659300529849189ad647fde9ad4a8918202ba310b936ac6a1d477e4284ac4b", // keccak512
+        "a7fa7b1f6efdeebb4eb2d53b28412a4962fa7236c775a0472e97af3035d0cebb794c97465bc89e9d26983a7b0a9283cc716dee3a6083817030dda4a4625f5d00", // luffa512
+        "2ee4a74633348e70cd572fe237051e662869fe7ee5f160e2a2007f15139936fcf4c6315e4c930fc7bd6d8679d9915d9fdb0f248827455e053f7002ce5fdbc8da", // shabal512
+        "4b53734538b113c1637104887e9f2150fa4ad9ec70552d8ed62f0134a47a2f4e8134b2366932983b4127cbcba59cda04bf6d0005b5ba04dea92879f15e80a28a", // shavite512
+        "c09546e438b49f5cd6bd2b51581ad381c14b6d543efc00c193ee94dca4d58b900c5315985a5eac4571c2141cc995c3bc0233aed662094f3fd2176a9c05bfb4e4", // simd512
+        "78cfdbdb2bd125f49d26146e208ebc7ceae57619bd68a2e4e9cdb1db198c995e3795fadbccaabb000463525eee2e1e7f6e8309c765a61e19fccdb18f5284c070", // skein512
+        "5c3c6f524c8ae1e7a4f76b84977b1560e78eb568e2fd8d72699ad79186481bd42b53ab39a0b741d9c098a4ecb01f3eccf3844cf1b73a9355ee5d496a2a1fb5b3", // whirlpool
+    };
+
+    unsigned char in[64];
+    for (int i = 0; i < 64; i++)
+        in[i] = i;
+
+    MinotaurHasher hasher;
+    for (unsigned int algo = 0; algo < MINOTAUR_ALGO_COUNT; algo++) {
+        unsigned char out[64];
+        hasher.HashAlgo(algo, in, out);
+        BOOST_CHECK_EQUAL(HexStr(out, out + 64), expected[algo]);
+    }
+}
+
+// Accelerated algo implementations must agree with SPH on arbitrary inputs, including in-place hashing
+BOOST_AUTO_TEST_CASE(minotaur_algo_sph_equivalence)
+{
+    MinotaurHasher hasher;
+    for (int i = 0; i < 200; i++) {
+        unsigned char in[64], out[64], ref[64];
+        uint256 a = InsecureRand256(), b = InsecureRand256();
+        memcpy(in, a.begin(), 32);
+        memcpy(in + 32, b.begin(), 32);
+
+        sph_echo512_context ctx_echo;
+        sph_echo512_init(&ctx_echo);
+        sph_echo512(&ctx_echo, in, 64);
+        sph_echo512_close(&ctx_echo, ref);
+        hasher.HashAlgo(3, in, out);
+        BOOST_CHECK(memcmp(out, ref, 64) == 0);
+
+        sph_fugue512_context ctx_fugue;
+        sph_fugue512_init(&ctx_fugue);
+        sph_fugue512(&ctx_fugue, in, 64);
+        sph_fugue512_close(&ctx_fugue, ref);
+        hasher.HashAlgo(4, in, out);
+        BOOST_CHECK(memcmp(out, ref, 64) == 0);
+
+        sph_groestl512_context ctx_groestl;
+        sph_groestl512_init(&ctx_groestl);
+        sph_groestl512(&ctx_groestl, in, 64);
+        sph_groestl512_close(&ctx_groestl, ref);
+        hasher.HashAlgo(5, in, out);
+        BOOST_CHECK(memcmp(out, ref, 64) == 0);
+
+        sph_shavite512_context ctx_shavite;
+        sph_shavite512_init(&ctx_shavite);
+        sph_shavite512(&ctx_shavite, in, 64);
+        sph_shavite512_close(&ctx_shavite, ref);
+        memcpy(out, in, 64);
+        hasher.HashAlgo(12, out, out);
+        BOOST_CHECK(memcmp(out, ref, 64) == 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(minotaur_testvectors)
+{
+    const std::string empty;
+    const std::string abc = "abc";
+    const std::string fox = "The quick brown fox jumps over the lazy dog";
+    BOOST_CHECK(Minotaur(empty.begin(), empty.end()) == uint256S("2cd7229216375a090f0385569da9ff8fdb99c08d5cb22424e3d67d73e6392052"));
+    BOOST_CHECK(Minotaur(abc.begin(), abc.end()) == uint256S("c59abd333507a37cd9303b1acf4e6cc5770dc66ed6d871ed9c76bfbd0d0b3947"));
+    BOOST_CHECK(Minotaur(fox.begin(), fox.end()) == uint256S("f9814b81d901536630be3541427bebd14f81dc636c5c036431c2a548583e9e29"));
+
+    // 80 bytes, as for a block header
+    std::vector<unsigned char> header(80);
+    for (int i = 0; i < 80; i++)
+        header[i] = i;
+    BOOST_CHECK(Minotaur(header.begin(), header.end()) == uint256S("ab4ad3b41a5b14f3f1422b9bfaa7636acb972e07d51aedd7bf61a91d3cd44f3e"));
+
+    // A reused hasher gives the same result as the thread hasher
+    MinotaurHasher hasher;
+    uint256 hash;
+    hasher.Hash(header.data(), header.size(), hash.begin());
+    BOOST_CHECK(hash == Minotaur(header.begin(), header.end()));
+}
+
+// MinotaurBatch gives the same hashes as hashing each input alone, for any number of lanes
+BOOST_AUTO_TEST_CASE(minotaur_batch)
+{
+    for (unsigned int count = 0; count <= MinotaurBatch::MAX_LANES; count++) {
+        std::vector<std::vector<unsigned char>> inputs(count);
+        const unsigned char* data[MinotaurBatch::MAX_LANES];
+        size_t len = InsecureRandRange(200);
+        for (unsigned int i = 0; i < count; i++) {
+            inputs[i] = g_insecure_rand_ctx.randbytes(len);
+            data[i] = inputs[i].data();
+        }
+
+        MinotaurBatch batch;
+        std::vector<unsigned char> out(count * 32);
+        batch.Hash(data, len, count, out.data());
+        for (unsigned int i = 0; i < count; i++)
+            BOOST_CHECK(uint256(std::vector<unsigned char>(out.begin() + i * 32, out.begin() + (i + 1) * 32)) == Minotaur(inputs[i].begin(), inputs[i].end()));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
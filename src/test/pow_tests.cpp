@@ -4,9 +4,18 @@
 
 #include <chain.h>
 #include <chainparams.h>
+#include <clientversion.h>
+#include <key.h>
+#include <key_io.h>
 #include <pow.h>
+#include <primitives/block.h>
 #include <random.h>
+#include <rpc/blockchain.h>
+#include <script/standard.h>
+#include <streams.h>
+#include <util/strencodings.h>
 #include <util/system.h>
+#include <validation.h>
 #include <test/test_ring.h>
 
 #include <boost/test/unit_test.hpp>
@@ -92,4 +101,252 @@ BOOST_AUTO_TEST_CASE(GetBlockProofEquivalentTime_test)
     }
 }
 
+// Ring-fork: Hive: The dwarf hash kernel must agree with hashing the dwarf string and the hex of its hash, as CheckHiveProof used to
+BOOST_AUTO_TEST_CASE(dwarf_hasher_matches_string_hashing)
+{
+    for (int i = 0; i < 14; i++) {
+        std::string deterministicRandString;
+        for (int j = 0; j < i % 7; j++)                         // Short chains give fewer than 6 block hashes
+            deterministicRandString += InsecureRand256().GetHex();
+        std::string txid = InsecureRand256().GetHex();
+        if (i == 12)
+            txid[10] = '\0';                                    // Dwarf strings are hashed as C strings; nothing after a NUL counts
+        if (i == 13)
+            deterministicRandString[3] = '\0';
+
+        CDwarfHasher dwarfHasher(deterministicRandString, txid);
+        const uint32_t dwarfNonces[] = {0, 9, 10, 12345, 0xffffffff, (uint32_t)InsecureRand32()};
+        for (uint32_t dwarfNonce : dwarfNonces) {
+            arith_uint256 expected(CBlockHeader::MinotaurHashArbitrary(std::string(deterministicRandString + txid + std::to_string(dwarfNonce)).c_str()).ToString());
+            expected = arith_uint256(CBlockHeader::MinotaurHashArbitrary(expected.ToString().c_str()).ToString());
+            BOOST_CHECK(UintToArith256(dwarfHasher.Hash(dwarfNonce)) == expected);
+            BOOST_CHECK(!dwarfHasher.CheckTarget(dwarfNonce, expected));
+            BOOST_CHECK(dwarfHasher.CheckTarget(dwarfNonce, expected + 1));
+        }
+    }
+
+    // Switching txid must only replace the txid part of the prefix
+    std::string deterministicRandString = InsecureRand256().GetHex() + InsecureRand256().GetHex();
+    std::string txidA = InsecureRand256().GetHex(), txidB = InsecureRand256().GetHex();
+    CDwarfHasher dwarfHasher(deterministicRandString);
+    dwarfHasher.SetTxid(txidA);
+    uint256 hashA = dwarfHasher.Hash(7);
+    dwarfHasher.SetTxid(txidB);
+    BOOST_CHECK(dwarfHasher.Hash(7) == CDwarfHasher(deterministicRandString, txidB).Hash(7));
+    dwarfHasher.SetTxid(txidA);
+    BOOST_CHECK(dwarfHasher.Hash(7) == hashA);
+}
+
+// Ring-fork: Hive: DCTs recorded as blocks are accepted are only found at their height on the branch that mined them
+BOOST_AUTO_TEST_CASE(dct_locator_follows_branches)
+{
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    const int baseHeight = consensusParams.minHiveCheckBlock;
+
+    // A common block, then branch A (blocks 1-2) and branch B (blocks 3-4)
+    uint256 hashes[5];
+    CBlockIndex blocks[5];
+    for (int i = 0; i < 5; i++) {
+        hashes[i] = InsecureRand256();
+        blocks[i].phashBlock = &hashes[i];
+        blocks[i].pprev = i == 0 ? nullptr : i == 3 ? &blocks[0] : &blocks[i - 1];
+        blocks[i].nHeight = i == 0 ? baseHeight : blocks[i].pprev->nHeight + 1;
+        blocks[i].BuildSkip();
+    }
+
+    CScript scriptPubKeyDCT = GetScriptForDestination(DecodeDestination(consensusParams.dwarfCreationAddress));
+    CKey rewardKey;
+    rewardKey.MakeNewKey(true);
+    CScript scriptPubKeyReward = GetScriptForDestination(rewardKey.GetPubKey().GetID());
+    scriptPubKeyDCT << OP_RETURN << OP_DWARF;
+    scriptPubKeyDCT.insert(scriptPubKeyDCT.end(), scriptPubKeyReward.begin(), scriptPubKeyReward.end());
+
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vout.resize(1);
+    CMutableTransaction dct;
+    dct.vin.emplace_back(COutPoint(InsecureRand256(), 0));
+    dct.vout.emplace_back(3 * consensusParams.dwarfCost, scriptPubKeyDCT);
+    dct.vout.emplace_back(consensusParams.dwarfCost, GetScriptForDestination(DecodeDestination(consensusParams.hiveCommunityAddress)));
+    CBlock block;
+    block.vtx.push_back(MakeTransactionRef(coinbase));
+    block.vtx.push_back(MakeTransactionRef(dct));
+    const uint256 dctHash = block.vtx[1]->GetHash();
+
+    LOCK(cs_main);
+    AddBlockDCTLocations(block, &blocks[1], consensusParams);
+
+    CDCTLocation location;
+    BOOST_CHECK(GetDCTLocation(dctHash, baseHeight + 1, &blocks[2], location));
+    BOOST_CHECK_EQUAL(location.nHeight, baseHeight + 1);
+    BOOST_CHECK(location.blockHash == hashes[1]);
+    BOOST_CHECK_EQUAL(location.vout.size(), 2U);
+    BOOST_CHECK(location.vout[0] == dct.vout[0]);
+    BOOST_CHECK(location.vout[1] == dct.vout[1]);
+
+    BOOST_CHECK(!GetDCTLocation(dctHash, baseHeight + 1, &blocks[4], location));     // Other branch
+    BOOST_CHECK(!GetDCTLocation(dctHash, baseHeight + 2, &blocks[2], location));     // Wrong height
+    BOOST_CHECK(!GetDCTLocation(dctHash, baseHeight + 1, &blocks[0], location));     // Not in the chain yet
+    BOOST_CHECK(!GetDCTLocation(InsecureRand256(), baseHeight + 1, &blocks[2], location));
+}
+
+// Ring-fork: Pop: The claimed game is read from the proof as SubmitSolution encodes it
+BOOST_AUTO_TEST_CASE(pop_proof_source_hash)
+{
+    const uint256 gameSourceHash = InsecureRand256();
+    std::vector<unsigned char> gameSourceHashVec(gameSourceHash.begin(), gameSourceHash.end());
+    std::reverse(gameSourceHashVec.begin(), gameSourceHashVec.end());
+    uint8_t gameType = 0;
+
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vout.resize(2);
+    coinbase.vout[0].scriptPubKey << OP_RETURN << OP_GAME << gameType << gameSourceHashVec << OP_FALSE;
+    CBlock block;
+    block.vtx.push_back(MakeTransactionRef(coinbase));
+
+    uint256 decoded;
+    BOOST_CHECK(GetPopProofSourceHash(block, decoded));
+    BOOST_CHECK(decoded == gameSourceHash);
+
+    // Not a pop proof
+    coinbase.vout[0].scriptPubKey = CScript() << OP_RETURN << OP_DWARF << gameSourceHashVec;
+    block.vtx[0] = MakeTransactionRef(coinbase);
+    BOOST_CHECK(!GetPopProofSourceHash(block, decoded));
+    block.vtx.clear();
+    BOOST_CHECK(!GetPopProofSourceHash(block, decoded));
+}
+
+// Ring-fork: Hive: Block summaries carry what hive and pop checks read from the coinbase, and survive the database
+BOOST_AUTO_TEST_CASE(hive_block_summary)
+{
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+
+    CKey rewardKey;
+    rewardKey.MakeNewKey(true);
+    CScript scriptPubKeyReward = GetScriptForDestination(rewardKey.GetPubKey().GetID());
+
+    // A hive block, with the proof laid out as MintHiveBlock does it
+    const uint256 dctTxid = InsecureRand256();
+    const std::string dctTxidStr = dctTxid.GetHex();
+    unsigned char dwarfNonceEncoded[4], dctHeightEncoded[4];
+    WriteLE32(dwarfNonceEncoded, 1234567);
+    WriteLE32(dctHeightEncoded, consensusParams.minHiveCheckBlock);
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vout.resize(2);
+    coinbase.vout[0].scriptPubKey << OP_RETURN << OP_DWARF << std::vector<unsigned char>(dwarfNonceEncoded, dwarfNonceEncoded + 4)
+        << std::vector<unsigned char>(dctHeightEncoded, dctHeightEncoded + 4) << OP_FALSE << std::vector<unsigned char>(dctTxidStr.begin(), dctTxidStr.end())
+        << std::vector<unsigned char>(65, 0);
+    coinbase.vout[1].scriptPubKey = scriptPubKeyReward;
+    CBlock block;
+    block.nNonce = consensusParams.hiveNonceMarker;
+    block.vtx.push_back(MakeTransactionRef(coinbase));
+
+    CHiveBlockSummary summary;
+    BOOST_CHECK(BuildHiveBlockSummary(block, consensusParams, summary));
+    BOOST_CHECK(summary.rewardScript == scriptPubKeyReward);
+    BOOST_CHECK(summary.dctTxid == dctTxid);
+    BOOST_CHECK_EQUAL(summary.nDwarfNonce, 1234567U);
+    BOOST_CHECK(summary.gameSourceHash.IsNull());
+
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << summary;
+    CHiveBlockSummary summaryRead;
+    ss >> summaryRead;
+    BOOST_CHECK(summaryRead.rewardScript == summary.rewardScript);
+    BOOST_CHECK(summaryRead.dctTxid == summary.dctTxid);
+    BOOST_CHECK_EQUAL(summaryRead.nDwarfNonce, summary.nDwarfNonce);
+
+    // CheckHiveProof takes the txid hex in either case, so the summary must too
+    std::string dctTxidStrUpper = dctTxidStr;
+    std::transform(dctTxidStrUpper.begin(), dctTxidStrUpper.end(), dctTxidStrUpper.begin(), ToUpper);
+    coinbase.vout[0].scriptPubKey = CScript() << OP_RETURN << OP_DWARF << std::vector<unsigned char>(dwarfNonceEncoded, dwarfNonceEncoded + 4)
+        << std::vector<unsigned char>(dctHeightEncoded, dctHeightEncoded + 4) << OP_FALSE << std::vector<unsigned char>(dctTxidStrUpper.begin(), dctTxidStrUpper.end())
+        << std::vector<unsigned char>(65, 0);
+    block.vtx[0] = MakeTransactionRef(coinbase);
+    BOOST_CHECK(BuildHiveBlockSummary(block, consensusParams, summary));
+    BOOST_CHECK(summary.dctTxid == dctTxid);
+    BOOST_CHECK(summary.rewardScript == scriptPubKeyReward);
+
+    // A pop block claiming the hive block's game
+    const uint256 gameSourceHash = block.GetHash();
+    std::vector<unsigned char> gameSourceHashVec(gameSourceHash.begin(), gameSourceHash.end());
+    std::reverse(gameSourceHashVec.begin(), gameSourceHashVec.end());
+    uint8_t gameType = 0;
+    coinbase.vout[0].scriptPubKey = CScript() << OP_RETURN << OP_GAME << gameType << gameSourceHashVec << OP_FALSE;
+    block.nNonce = consensusParams.popNonceMarker;
+    block.vtx[0] = MakeTransactionRef(coinbase);
+    BOOST_CHECK(BuildHiveBlockSummary(block, consensusParams, summary));
+    BOOST_CHECK(summary.rewardScript == scriptPubKeyReward);
+    BOOST_CHECK(summary.gameSourceHash == gameSourceHash);
+    BOOST_CHECK(summary.dctTxid.IsNull());
+
+    // Neither
+    block.nNonce = 0;
+    BOOST_CHECK(!BuildHiveBlockSummary(block, consensusParams, summary));
+}
+
+// Ring-fork: Hive: Lookups through the chain context must agree with walking the chain, as they used to
+BOOST_AUTO_TEST_CASE(hive_context_matches_chain_walk)
+{
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    const int nBlocks = consensusParams.minHiveCheckBlock + 400;
+    const int nMixedFrom = consensusParams.minHiveCheckBlock - 100;     // Hive and pop blocks from here on, PoW only before
+
+    // The same chain twice; only the first has its context built
+    std::vector<uint256> hashes(nBlocks);
+    std::vector<CBlockIndex> built(nBlocks), walked(nBlocks);
+    int hiveRun = 0;
+    for (int i = 0; i < nBlocks; i++) {
+        uint32_t nNonce = 3 + InsecureRandRange(1000);
+        if (i >= nMixedFrom) {
+            uint64_t r = InsecureRandRange(4);
+            if (r == 0 && hiveRun < consensusParams.maxConsecutiveHiveBlocks)
+                nNonce = consensusParams.hiveNonceMarker;
+            else if (r == 1)
+                nNonce = consensusParams.popNonceMarker;
+        }
+        if (nNonce == consensusParams.hiveNonceMarker)
+            hiveRun++;
+        else if (nNonce != consensusParams.popNonceMarker)
+            hiveRun = 0;
+
+        hashes[i] = InsecureRand256();
+        for (std::vector<CBlockIndex>* blocks : {&built, &walked}) {
+            CBlockIndex& block = (*blocks)[i];
+            block.phashBlock = &hashes[i];
+            block.pprev = i ? &(*blocks)[i - 1] : nullptr;
+            block.nHeight = i;
+            block.nNonce = nNonce;
+            block.nTime = 1500000000 + i * consensusParams.nPowTargetSpacing;
+            block.nBits = 0x1e0fffff - InsecureRandRange(0x0f0000);
+            block.BuildSkip();
+        }
+        built[i].BuildHiveContext(consensusParams);
+    }
+
+    auto height = [](const CBlockIndex* pindex) { return pindex ? pindex->nHeight : -1; };
+    for (int j = 0; j < 600; j++) {
+        const int i = j < 400 ? nMixedFrom + InsecureRandRange(nBlocks - nMixedFrom) : InsecureRandRange(nBlocks);
+        const CBlockIndex& a = built[i];
+        const CBlockIndex& b = walked[i];
+
+        BOOST_CHECK_EQUAL(height(a.GetLastPow(consensusParams)), height(b.GetLastPow(consensusParams)));
+        BOOST_CHECK_EQUAL(height(a.GetLastHive(consensusParams)), height(b.GetLastHive(consensusParams)));
+        BOOST_CHECK_EQUAL(a.GetHiveSincePow(consensusParams), b.GetHiveSincePow(consensusParams));
+        BOOST_CHECK_EQUAL(a.GetChainPopBlocks(consensusParams), b.GetChainPopBlocks(consensusParams));
+
+        BOOST_CHECK(GetBlockProof(a) == GetBlockProof(b));
+        BOOST_CHECK_EQUAL(GetDifficulty(&a, false), GetDifficulty(&b, false));
+        BOOST_CHECK_EQUAL(GetDifficulty(&a, true), GetDifficulty(&b, true));
+        BOOST_CHECK_EQUAL(GetDeterministicRandString(&a), GetDeterministicRandString(&b));
+        BOOST_CHECK_EQUAL(GetNextHiveWorkRequired(&a, consensusParams), GetNextHiveWorkRequired(&b, consensusParams));
+
+        CBlockHeader header;
+        header.nTime = a.nTime + consensusParams.nPowTargetSpacing;
+        BOOST_CHECK_EQUAL(GetNextWorkRequired(&a, &header, consensusParams), GetNextWorkRequired(&b, &header, consensusParams));
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
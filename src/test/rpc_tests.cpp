@@ -102,6 +102,20 @@ BOOST_AUTO_TEST_CASE(rpc_togglenetwork)
     BOOST_CHECK_EQUAL(netState, true);
 }
 
+// Ring-fork: In-wallet miner
+BOOST_AUTO_TEST_CASE(rpc_getminerstats)
+{
+    BOOST_CHECK_THROW(CallRPC("getminerstats extra"), std::runtime_error);
+
+    // With the miner off there are no threads and no hashrate
+    UniValue r = CallRPC("getminerstats");
+    BOOST_CHECK_EQUAL(find_value(r.get_obj(), "generate").get_bool(), false);
+    const UniValue& hashesPerSec = find_value(r.get_obj(), "hashespersec");
+    for (const std::string& window : {"1s", "10s", "60s"})
+        BOOST_CHECK_EQUAL(find_value(hashesPerSec.get_obj(), window).get_real(), 0);
+    BOOST_CHECK(find_value(r.get_obj(), "threads").get_array().empty());
+}
+
 BOOST_AUTO_TEST_CASE(rpc_rawsign)
 {
     UniValue r;
@@ -4,16 +4,28 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <arith_uint256.h>
+#include <chain.h>
 #include <chainparams.h>
+#include <clientversion.h>
+#include <coins.h>
 #include <consensus/merkle.h>
 #include <consensus/validation.h>
+#include <crypto/common.h>
+#include <hash.h>
+#include <key.h>
+#include <key_io.h>
 #include <miner.h>
 #include <pow.h>
 #include <random.h>
+#include <script/standard.h>
+#include <streams.h>
 #include <test/test_ring.h>
 #include <validation.h>
 #include <validationinterface.h>
 
+#include <boost/thread.hpp>
+
 struct RegtestingSetup : public TestingSetup {
     RegtestingSetup() : TestingSetup(CBaseChainParams::REGTEST) {}
 };
@@ -184,4 +196,411 @@ BOOST_AUTO_TEST_CASE(processnewblock_signals_ordering)
     BOOST_CHECK_EQUAL(sub.m_expected_tip, chainActive.Tip()->GetBlockHash());
 }
 
+// Ring-fork: Header batches get their pow hashed before cs_main is taken; make sure the hashes reach the block index, and bad pow is still caught
+BOOST_AUTO_TEST_CASE(processnewblockheaders_pow_hash)
+{
+    std::vector<CBlockHeader> headers;
+    uint256 prev_hash = Params().GenesisBlock().GetHash();
+    for (int i = 0; i < 20; i++) {
+        headers.push_back(GoodBlock(prev_hash)->GetBlockHeader());
+        prev_hash = headers.back().GetHash();
+    }
+
+    CValidationState state;
+    BOOST_CHECK(ProcessNewBlockHeaders(headers, state, Params()));
+    {
+        LOCK(cs_main);
+        for (const CBlockHeader& header : headers) {
+            BlockMap::iterator mi = mapBlockIndex.find(header.GetHash());
+            BOOST_REQUIRE(mi != mapBlockIndex.end());
+            bool fPow = !header.IsHiveMined(Params().GetConsensus()) && !header.IsPopMined(Params().GetConsensus());
+            BOOST_CHECK(mi->second->hashPow == (fPow ? header.GetPowHash() : uint256()));
+        }
+    }
+
+    // A batch with a header failing pow is rejected at that header
+    std::vector<CBlockHeader> bad_headers;
+    bad_headers.push_back(GoodBlock(prev_hash)->GetBlockHeader());
+    CBlockHeader bad_header = GoodBlock(bad_headers.back().GetHash())->GetBlockHeader();
+    while (CheckProofOfWork(bad_header.GetPowHash(), bad_header.nBits, Params().GetConsensus()))
+        ++bad_header.nNonce;
+    bad_headers.push_back(bad_header);
+
+    CBlockHeader first_invalid;
+    BOOST_CHECK(!ProcessNewBlockHeaders(bad_headers, state, Params(), nullptr, &first_invalid));
+    BOOST_CHECK(first_invalid.GetHash() == bad_header.GetHash());
+    BOOST_CHECK_EQUAL(state.GetRejectReason(), "high-hash");
+}
+
+// Ring-fork: Chain params with checkpoints and a default assumevalid block of the test's choosing
+struct AssumedPowParams : public CChainParams {
+    explicit AssumedPowParams(const CChainParams& params) : CChainParams(params) {}
+    void AddCheckpoint(int nHeight, const uint256& hash) { checkpointData.mapCheckpoints[nHeight] = hash; }
+    void SetDefaultAssumeValid(const uint256& hash) { consensus.defaultAssumeValid = hash; }
+};
+
+// Ring-fork: A pow header on prev_hash that fails its pow check
+static CBlockHeader BadPowHeader(const uint256& prev_hash)
+{
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    CBlockHeader header = GoodBlock(prev_hash)->GetBlockHeader();
+    do {
+        ++header.nNonce;
+    } while (CheckProofOfWork(header.GetPowHash(), header.nBits, consensusParams) || header.IsHiveMined(consensusParams) || header.IsPopMined(consensusParams));
+    return header;
+}
+
+// Ring-fork: nBad headers failing pow, then nGood passing it, on the genesis block
+static std::vector<CBlockHeader> AssumedPowChain(int nBad, int nGood)
+{
+    std::vector<CBlockHeader> headers;
+    uint256 prev_hash = Params().GenesisBlock().GetHash();
+    for (int i = 0; i < nBad + nGood; i++) {
+        headers.push_back(i < nBad ? BadPowHeader(prev_hash) : GoodBlock(prev_hash)->GetBlockHeader());
+        prev_hash = headers.back().GetHash();
+    }
+    return headers;
+}
+
+// Ring-fork: Headers sync runs short of a checkpoint are held back, then accepted without a pow check (BLOCK_POW_ASSUMED)
+// once a later run links them to it. With -assumecheckpointedpow off, the same headers are rejected for their pow.
+BOOST_AUTO_TEST_CASE(processnewblockheaders_pow_assumed)
+{
+    std::vector<CBlockHeader> headers = AssumedPowChain(20, 10);
+    AssumedPowParams params(Params());
+    params.AddCheckpoint(20, headers[19].GetHash());
+
+    CValidationState state;
+    const CBlockIndex* pindex = nullptr;
+    BOOST_CHECK(ProcessNewBlockHeaders(std::vector<CBlockHeader>(headers.begin(), headers.begin() + 10), state, params, &pindex));
+    {
+        LOCK(cs_main);
+        BOOST_CHECK(pindex == LookupBlockIndex(Params().GenesisBlock().GetHash()));
+        for (int i = 0; i < 10; i++) {
+            BOOST_CHECK(IsHeaderPowPending(headers[i].GetHash()));
+            BOOST_CHECK(!LookupBlockIndex(headers[i].GetHash()));
+        }
+    }
+
+    BOOST_CHECK(ProcessNewBlockHeaders(std::vector<CBlockHeader>(headers.begin() + 10, headers.end()), state, params, &pindex));
+    {
+        LOCK(cs_main);
+        BOOST_CHECK(pindex == LookupBlockIndex(headers.back().GetHash()));
+        for (int i = 0; i < (int)headers.size(); i++) {
+            CBlockIndex* pindexHeader = LookupBlockIndex(headers[i].GetHash());
+            BOOST_REQUIRE(pindexHeader);
+            BOOST_CHECK(!IsHeaderPowPending(headers[i].GetHash()));
+            BOOST_CHECK_EQUAL((pindexHeader->nStatus & BLOCK_POW_ASSUMED) != 0, i < 20);
+            if (i < 20)
+                BOOST_CHECK(pindexHeader->hashPow.IsNull());
+        }
+    }
+
+    std::vector<CBlockHeader> other_headers = AssumedPowChain(20, 0);
+    AssumedPowParams other_params(Params());
+    other_params.AddCheckpoint(20, other_headers.back().GetHash());
+    fAssumeCheckpointedPow = false;
+    CValidationState other_state;
+    CBlockHeader first_invalid;
+    BOOST_CHECK(!ProcessNewBlockHeaders(other_headers, other_state, other_params, nullptr, &first_invalid));
+    fAssumeCheckpointedPow = DEFAULT_ASSUME_CHECKPOINTED_POW;
+    BOOST_CHECK(first_invalid.GetHash() == other_headers[0].GetHash());
+    BOOST_CHECK_EQUAL(other_state.GetRejectReason(), "high-hash");
+}
+
+// Ring-fork: The default assumevalid block anchors assumed pow too, and ThreadCheckAssumedPow() later finds the assumed
+// headers that fail their pow and marks them invalid
+BOOST_AUTO_TEST_CASE(thread_check_assumed_pow)
+{
+    std::vector<CBlockHeader> headers = AssumedPowChain(6, 4);
+    AssumedPowParams params(Params());
+    params.SetDefaultAssumeValid(headers[5].GetHash());
+
+    CValidationState state;
+    BOOST_CHECK(ProcessNewBlockHeaders(headers, state, params));
+    {
+        LOCK(cs_main);
+        for (int i = 0; i < (int)headers.size(); i++)
+            BOOST_CHECK_EQUAL((LookupBlockIndex(headers[i].GetHash())->nStatus & BLOCK_POW_ASSUMED) != 0, i < 6);
+    }
+
+    boost::thread checker(std::bind(&ThreadCheckAssumedPow, std::cref(params)));
+    for (int n = 0; n < 1000; n++) {
+        {
+            LOCK(cs_main);
+            if (!(LookupBlockIndex(headers[5].GetHash())->nStatus & BLOCK_POW_ASSUMED))
+                break;
+        }
+        MilliSleep(10);
+    }
+    checker.interrupt();
+    checker.join();
+
+    LOCK(cs_main);
+    for (int i = 0; i < (int)headers.size(); i++) {
+        const CBlockIndex* pindexHeader = LookupBlockIndex(headers[i].GetHash());
+        BOOST_CHECK(!(pindexHeader->nStatus & BLOCK_POW_ASSUMED));
+        BOOST_CHECK_EQUAL((pindexHeader->nStatus & BLOCK_FAILED_VALID) != 0, i < 6);
+    }
+}
+
+// Ring-fork: Hive: Main params (regtest has no hive parameters), with a chain of block indexes made up past the hive slow
+// start (no block data) set as the active chain. UnloadBlockIndex() frees them at teardown.
+struct HiveProofSetup : public TestingSetup {
+    int dctHeight;      // A DCT mined here is mature for a block on the tip
+
+    HiveProofSetup() : TestingSetup(CBaseChainParams::MAIN)
+    {
+        const Consensus::Params& consensusParams = Params().GetConsensus();
+        const int nHeight = consensusParams.lastInitialDistributionHeight + consensusParams.slowStartBlocks + consensusParams.dwarfGestationBlocks + 200;
+        dctHeight = nHeight - consensusParams.dwarfGestationBlocks - 100;
+
+        LOCK(cs_main);
+        chainActive.SetTip(ExtendChain(chainActive.Tip(), nHeight - chainActive.Height()));
+    }
+
+    // nBlocks made-up PoW block indexes on pindex
+    CBlockIndex* ExtendChain(CBlockIndex* pindex, int nBlocks) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+    {
+        const Consensus::Params& consensusParams = Params().GetConsensus();
+        for (int i = 0; i < nBlocks; i++) {
+            CBlockIndex* pindexNew = new CBlockIndex();
+            pindexNew->pprev = pindex;
+            pindexNew->nHeight = pindex->nHeight + 1;
+            pindexNew->nTime = pindex->nTime + consensusParams.nPowTargetSpacing;
+            pindexNew->nBits = 0x1e0fffff;
+            pindexNew->phashBlock = &mapBlockIndex.emplace(InsecureRand256(), pindexNew).first->first;
+            pindexNew->BuildSkip();
+            pindexNew->BuildHiveContext(consensusParams);
+            pindex = pindexNew;
+        }
+        return pindex;
+    }
+
+    // An index entry for a block whose data is stored and whose transactions are valid, as AcceptBlock leaves it
+    CBlockIndex* AddBlockIndex(const CBlock& block) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+    {
+        CBlockIndex* pindex = new CBlockIndex(block);
+        pindex->phashBlock = &mapBlockIndex.emplace(block.GetHash(), pindex).first->first;
+        pindex->pprev = LookupBlockIndex(block.hashPrevBlock);
+        pindex->nHeight = pindex->pprev->nHeight + 1;
+        pindex->BuildSkip();
+        pindex->BuildHiveContext(Params().GetConsensus());
+        pindex->nTx = block.vtx.size();
+        pindex->nStatus |= BLOCK_HAVE_DATA;
+        pindex->RaiseValidity(BLOCK_VALID_TRANSACTIONS);
+        return pindex;
+    }
+
+    // A PoW block on pindexPrev with its data on disk, for the deep drill to read
+    CBlockIndex* AddStoredBlock(const CBlockIndex* pindexPrev) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+    {
+        CMutableTransaction coinbase;
+        coinbase.vin.resize(1);
+        coinbase.vout.resize(1);
+        CBlock block;
+        block.hashPrevBlock = pindexPrev->GetBlockHash();
+        block.nTime = pindexPrev->nTime + Params().GetConsensus().nPowTargetSpacing;
+        block.nBits = 0x1e0fffff;
+        block.vtx.push_back(MakeTransactionRef(coinbase));
+        block.hashMerkleRoot = BlockMerkleRoot(block);
+
+        const CDiskBlockPos pos(1000, 0);     // A block file of its own
+        {
+            CAutoFile fileout(OpenBlockFile(pos), SER_DISK, CLIENT_VERSION);
+            BOOST_REQUIRE(!fileout.IsNull());
+            fileout << block;
+        }
+
+        CBlockIndex* pindex = AddBlockIndex(block);
+        pindex->nFile = pos.nFile;
+        pindex->nDataPos = pos.nPos;
+        return pindex;
+    }
+
+    // A DCT for 1000 dwarves (plenty for one to meet the easiest target), rewarding key
+    static CMutableTransaction CreateDCT(const CKey& key)
+    {
+        const Consensus::Params& consensusParams = Params().GetConsensus();
+        CScript scriptPubKeyDCT = GetScriptForDestination(DecodeDestination(consensusParams.dwarfCreationAddress));
+        CScript scriptPubKeyReward = GetScriptForDestination(key.GetPubKey().GetID());
+        scriptPubKeyDCT << OP_RETURN << OP_DWARF;
+        scriptPubKeyDCT.insert(scriptPubKeyDCT.end(), scriptPubKeyReward.begin(), scriptPubKeyReward.end());
+
+        CMutableTransaction dct;
+        dct.vin.emplace_back(COutPoint(InsecureRand256(), 0));
+        dct.vout.emplace_back(1000 * consensusParams.dwarfCost, scriptPubKeyDCT);
+        return dct;
+    }
+
+    // Record the DCT as mined at dctHeight in the active chain, as AcceptBlock does
+    void LocateDCT(const CMutableTransaction& dct) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+    {
+        CMutableTransaction coinbase;
+        coinbase.vin.resize(1);
+        coinbase.vout.resize(1);
+        CBlock block;
+        block.vtx.push_back(MakeTransactionRef(coinbase));
+        block.vtx.push_back(MakeTransactionRef(dct));
+        AddBlockDCTLocations(block, chainActive[dctHeight], Params().GetConsensus());
+    }
+
+    // A hive block on pindexPrev claiming a dwarf from the DCT mined at dctHeight, with its proof signed by signingKey,
+    // built as MintHiveBlock does
+    std::shared_ptr<CBlock> HiveBlock(const CBlockIndex* pindexPrev, const CMutableTransaction& dct, const CKey& rewardKey, const CKey& signingKey)
+    {
+        const Consensus::Params& consensusParams = Params().GetConsensus();
+        const std::string dctTxid = dct.GetHash().GetHex();
+        const std::string deterministicRandString = GetDeterministicRandString(pindexPrev);
+        arith_uint256 dwarfHashTarget;
+        dwarfHashTarget.SetCompact(GetNextHiveWorkRequired(pindexPrev, consensusParams));
+        CDwarfHasher dwarfHasher(deterministicRandString, dctTxid);
+        uint32_t dwarfNonce = 0;
+        while (dwarfNonce < 1000 && !dwarfHasher.CheckTarget(dwarfNonce, dwarfHashTarget))
+            dwarfNonce++;
+        BOOST_REQUIRE(dwarfNonce < 1000);
+
+        CHashWriter ss(SER_GETHASH, 0);
+        ss << deterministicRandString;
+        std::vector<unsigned char> messageProofVec;
+        BOOST_REQUIRE(signingKey.SignCompact(ss.GetHash(), messageProofVec));
+
+        unsigned char dwarfNonceEncoded[4], dctHeightEncoded[4];
+        WriteLE32(dwarfNonceEncoded, dwarfNonce);
+        WriteLE32(dctHeightEncoded, dctHeight);
+        CScript hiveProofScript;
+        hiveProofScript << OP_RETURN << OP_DWARF << std::vector<unsigned char>(dwarfNonceEncoded, dwarfNonceEncoded + 4)
+            << std::vector<unsigned char>(dctHeightEncoded, dctHeightEncoded + 4) << OP_FALSE
+            << std::vector<unsigned char>(dctTxid.begin(), dctTxid.end()) << messageProofVec;
+
+        CMutableTransaction coinbase;
+        coinbase.vin.resize(1);
+        coinbase.vin[0].scriptSig = CScript() << (pindexPrev->nHeight + 1) << OP_0;
+        coinbase.vout.emplace_back(0, hiveProofScript);
+        coinbase.vout.emplace_back(GetBlockSubsidyHive(consensusParams), GetScriptForDestination(rewardKey.GetPubKey().GetID()));
+
+        auto pblock = std::make_shared<CBlock>();
+        pblock->hashPrevBlock = pindexPrev->GetBlockHash();
+        pblock->nTime = pindexPrev->nTime + 1;
+        pblock->nNonce = consensusParams.hiveNonceMarker;
+        pblock->vtx.push_back(MakeTransactionRef(coinbase));
+        pblock->hashMerkleRoot = BlockMerkleRoot(*pblock);
+        return pblock;
+    }
+};
+
+// Check a block afresh, as ConnectBlock does with a block read from disk
+static bool CheckBlockAfresh(const CBlock& block, CValidationState& state)
+{
+    CBlock blockRead(block);
+    blockRead.fChecked = false;
+    return CheckBlock(blockRead, state, Params().GetConsensus());
+}
+
+// Ring-fork: Hive: A passed hive proof is only recorded when its DCT was found through the block's ancestry. A verdict
+// resting on the UTXO set would wrongly carry over to a reorg onto a branch without the DCT.
+BOOST_FIXTURE_TEST_CASE(hive_proof_verdict_kept_only_from_ancestry, HiveProofSetup)
+{
+    CKey key;
+    key.MakeNewKey(true);
+    const CMutableTransaction dct = CreateDCT(key);
+
+    // A hive block on the tip, with its DCT found by the locator: the verdict is kept
+    std::shared_ptr<CBlock> pblock;
+    CBlockIndex* pindex;
+    {
+        LOCK(cs_main);
+        LocateDCT(dct);
+        pblock = HiveBlock(chainActive.Tip(), dct, key, key);
+        pindex = AddBlockIndex(*pblock);
+    }
+    CValidationState state;
+    BOOST_CHECK(CheckBlock(*pblock, state, Params().GetConsensus()));
+    BOOST_CHECK(pindex->fProofPassed);
+
+    // A hive block on a branch forking below the DCT, so without it, claiming the same DCT. It passes while the DCT is
+    // in the active chain's UTXO set, but the verdict isn't kept.
+    std::shared_ptr<CBlock> pblockSide;
+    CBlockIndex* pindexSide;
+    {
+        LOCK(cs_main);
+        CBlockIndex* pindexBranch = AddStoredBlock(chainActive[dctHeight - 1]);
+        pindexBranch = ExtendChain(pindexBranch, chainActive.Height() - dctHeight);
+        pblockSide = HiveBlock(pindexBranch, dct, key, key);
+        pindexSide = AddBlockIndex(*pblockSide);
+        pcoinsTip->AddCoin(COutPoint(dct.GetHash(), 0), Coin(dct.vout[0], dctHeight, false), false);
+    }
+    BOOST_CHECK(CheckBlock(*pblockSide, state, Params().GetConsensus()));
+    BOOST_CHECK(!pindexSide->fProofPassed);
+
+    // On a reorg onto the branch, whose UTXO set doesn't have the DCT, the proof is checked again as the block is
+    // connected, and fails. The active chain's hive block keeps its verdict.
+    {
+        LOCK(cs_main);
+        pcoinsTip->SpendCoin(COutPoint(dct.GetHash(), 0));
+    }
+    BOOST_CHECK(!CheckBlockAfresh(*pblockSide, state));
+    BOOST_CHECK_EQUAL(state.GetRejectReason(), "bad-hive-proof");
+    BOOST_CHECK(!pindexSide->fProofPassed);
+
+    CValidationState stateTip;
+    BOOST_CHECK(CheckBlockAfresh(*pblock, stateTip));
+}
+
+// Ring-fork: Proofs deferred by LoadExternalBlockFile: a failure marks the block invalid, so it's never connected, and a
+// pass is recorded only when it holds on any branch
+BOOST_FIXTURE_TEST_CASE(deferred_block_proofs, HiveProofSetup)
+{
+    CKey key, otherKey;
+    key.MakeNewKey(true);
+    otherKey.MakeNewKey(true);
+    const CMutableTransaction dctLocated = CreateDCT(key);
+    const CMutableTransaction dctUnspent = CreateDCT(key);
+
+    // Hive blocks on the tip claiming a DCT found by the locator, one found in the UTXO set, and one signed by a key
+    // other than the DCT's
+    std::vector<CDeferredBlockProof> vDeferred;
+    CBlockIndex *pindexLocated, *pindexUnspent, *pindexBadSig;
+    std::shared_ptr<CBlock> pblockUnspent, pblockBadSig;
+    const CBlockIndex* pindexTip;
+    {
+        LOCK(cs_main);
+        pindexTip = chainActive.Tip();
+        LocateDCT(dctLocated);
+        pcoinsTip->AddCoin(COutPoint(dctUnspent.GetHash(), 0), Coin(dctUnspent.vout[0], dctHeight, false), false);
+
+        std::shared_ptr<CBlock> pblockLocated = HiveBlock(pindexTip, dctLocated, key, key);
+        pblockUnspent = HiveBlock(pindexTip, dctUnspent, key, key);
+        pblockBadSig = HiveBlock(pindexTip, dctLocated, key, otherKey);
+        pindexLocated = AddBlockIndex(*pblockLocated);
+        pindexUnspent = AddBlockIndex(*pblockUnspent);
+        pindexBadSig = AddBlockIndex(*pblockBadSig);
+        vDeferred.push_back({pblockLocated, pindexLocated, false, false});
+        vDeferred.push_back({pblockUnspent, pindexUnspent, false, false});
+        vDeferred.push_back({pblockBadSig, pindexBadSig, false, false});
+    }
+
+    CheckDeferredBlockProofs(vDeferred, Params());
+    BOOST_CHECK(vDeferred.empty());
+
+    LOCK(cs_main);
+    BOOST_CHECK(pindexLocated->fProofPassed);
+    BOOST_CHECK(pindexLocated->IsValid(BLOCK_VALID_TRANSACTIONS));
+
+    // Passed, but checked again when connected
+    BOOST_CHECK(!pindexUnspent->fProofPassed);
+    BOOST_CHECK(pindexUnspent->IsValid(BLOCK_VALID_TRANSACTIONS));
+    CValidationState state;
+    BOOST_CHECK(CheckBlockAfresh(*pblockUnspent, state));
+
+    // Failed: marked invalid, which keeps it out of the chains ActivateBestChain will connect
+    BOOST_CHECK(!pindexBadSig->fProofPassed);
+    BOOST_CHECK(pindexBadSig->nStatus & BLOCK_FAILED_VALID);
+    BOOST_CHECK(!pindexBadSig->IsValid(BLOCK_VALID_TRANSACTIONS));
+    BOOST_CHECK(!chainActive.Contains(pindexBadSig));
+    BOOST_CHECK(chainActive.Tip() == pindexTip);
+    BOOST_CHECK(!CheckBlockAfresh(*pblockBadSig, state));
+    BOOST_CHECK_EQUAL(state.GetRejectReason(), "bad-hive-proof");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
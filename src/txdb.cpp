@@ -13,6 +13,7 @@
 #include <uint256.h>
 #include <util/system.h>
 #include <ui_interface.h>
+#include <validation.h>             // Ring-fork: Hive
 
 #include <stdint.h>
 
@@ -28,6 +29,7 @@ static const char DB_HEAD_BLOCKS = 'H';
 static const char DB_FLAG = 'F';
 static const char DB_REINDEX_FLAG = 'R';
 static const char DB_LAST_BLOCK = 'l';
+static const char DB_HIVE_SUMMARY = 'h';    // Ring-fork: Hive
 
 namespace {
 
@@ -246,6 +248,15 @@ bool CBlockTreeDB::ReadFlag(const std::string &name, bool &fValue) {
     return true;
 }
 
+// Ring-fork: Hive: Coinbase summaries of hive and pop blocks, by block hash
+bool CBlockTreeDB::WriteHiveBlockSummary(const uint256& hash, const CHiveBlockSummary& summary) {
+    return Write(std::make_pair(DB_HIVE_SUMMARY, hash), summary);
+}
+
+bool CBlockTreeDB::ReadHiveBlockSummary(const uint256& hash, CHiveBlockSummary& summary) {
+    return Read(std::make_pair(DB_HIVE_SUMMARY, hash), summary);
+}
+
 bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex)
 {
     std::unique_ptr<CDBIterator> pcursor(NewIterator());
@@ -271,6 +282,7 @@ bool CBlockTreeDB::LoadBlockIndexGuts(const Consensus::Params& consensusParams,
                 pindexNew->nTime          = diskindex.nTime;
                 pindexNew->nBits          = diskindex.nBits;
                 pindexNew->nNonce         = diskindex.nNonce;
+                pindexNew->hashPow        = diskindex.hashPow;
                 pindexNew->nStatus        = diskindex.nStatus;
                 pindexNew->nTx            = diskindex.nTx;
 
@@ -20,6 +20,7 @@
 class CBlockIndex;
 class CCoinsViewDBCursor;
 class uint256;
+struct CHiveBlockSummary;
 
 //! No need to periodic flush if at least this much space still available.
 static constexpr int MAX_BLOCK_COINSDB_USAGE = 10;
@@ -37,6 +38,8 @@ static const int64_t nMaxBlockDBCache = 2;
 // Unlike for the UTXO database, for the txindex scenario the leveldb cache make
 // a meaningful difference: https://github.com/bitcoin/bitcoin/pull/8273#issuecomment-229601991
 static const int64_t nMaxTxIndexCache = 1024;
+//! Max memory allocated to the hive population index DB specific cache, if -hiveindex (MiB)
+static const int64_t nMaxHiveIndexCache = 16;   // Ring-fork: Hive
 //! Max memory allocated to coin DB specific cache (MiB)
 static const int64_t nMaxCoinsDBCache = 8;
 
@@ -96,6 +99,8 @@ public:
     bool WriteFlag(const std::string &name, bool fValue);
     bool ReadFlag(const std::string &name, bool &fValue);
     bool LoadBlockIndexGuts(const Consensus::Params& consensusParams, std::function<CBlockIndex*(const uint256&)> insertBlockIndex);
+    bool WriteHiveBlockSummary(const uint256& hash, const CHiveBlockSummary& summary);   // Ring-fork: Hive
+    bool ReadHiveBlockSummary(const uint256& hash, CHiveBlockSummary& summary);         // Ring-fork: Hive
 };
 
 #endif // RING_TXDB_H
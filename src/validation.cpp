@@ -14,9 +14,11 @@
 #include <consensus/merkle.h>
 #include <consensus/tx_verify.h>
 #include <consensus/validation.h>
+#include <crypto/pow/minotaur.h>
 #include <cuckoocache.h>
 #include <hash.h>
 #include <index/txindex.h>
+#include <key_io.h>               // Ring-fork: Hive
 #include <policy/fees.h>
 #include <policy/policy.h>
 #include <policy/rbf.h>
@@ -167,9 +169,10 @@ public:
      * If a block header hasn't already been seen, call CheckBlockHeader on it, ensure
      * that it doesn't descend from an invalid block, and then add it to mapBlockIndex.
      */
-    bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+    // Ring-fork: If phashPowKnown is given and non-null, it's the header's pow hash, already computed by the caller
+    bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, const uint256* phashPowKnown = nullptr, bool fPowAssumed = false) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     // Ring-fork: Pop: Added fPopCheckActiveChain
-    bool AcceptBlock(const std::shared_ptr<const CBlock>& pblock, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fRequested, const CDiskBlockPos* dbp, bool* fNewBlock, bool fPopCheckActiveChain = true) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+    bool AcceptBlock(const std::shared_ptr<const CBlock>& pblock, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fRequested, const CDiskBlockPos* dbp, bool* fNewBlock, bool fPopCheckActiveChain = true, bool fCheckProofs = true) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
     // Block (dis)connection on a given view:
     DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view);
@@ -183,6 +186,10 @@ public:
     bool PreciousBlock(CValidationState& state, const CChainParams& params, CBlockIndex* pindex) LOCKS_EXCLUDED(cs_main);
     bool InvalidateBlock(CValidationState& state, const CChainParams& chainparams, CBlockIndex* pindex);
     void ResetBlockFailureFlags(CBlockIndex* pindex) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+    // Ring-fork: Record the outcome of the deferred pow check of a header accepted with BLOCK_POW_ASSUMED
+    void AssumedPowChecked(CBlockIndex* pindex, const uint256& hashPow, const Consensus::Params& consensusParams) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+    // Ring-fork: Record the outcome of the deferred proof check of a hive or pop block accepted by LoadExternalBlockFile
+    void DeferredProofChecked(CBlockIndex* pindex, bool fPassed, bool fCacheable, const Consensus::Params& consensusParams) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
     bool ReplayBlocks(const CChainParams& params, CCoinsView* view);
     bool RewindBlockIndex(const CChainParams& params);
@@ -243,6 +250,7 @@ bool fIsBareMultisigStd = DEFAULT_PERMIT_BAREMULTISIG;
 bool fRequireStandard = true;
 bool fCheckBlockIndex = false;
 bool fCheckpointsEnabled = DEFAULT_CHECKPOINTS_ENABLED;
+bool fAssumeCheckpointedPow = DEFAULT_ASSUME_CHECKPOINTED_POW;    // Ring-fork
 size_t nCoinCacheUsage = 5000 * 300;
 uint64_t nPruneTarget = 0;
 int64_t nMaxTipAge = DEFAULT_MAX_TIP_AGE;
@@ -1069,6 +1077,56 @@ static bool WriteBlockToDisk(const CBlock& block, CDiskBlockPos& pos, const CMes
     return true;
 }
 
+// Ring-fork: Check a hive or pop block's proof, unless its block index records it as already passed (see
+// CBlockIndex::fProofPassed), in which case a pop block's source is only checked to still be in the active chain.
+// On a pass, pfCacheable (if given) is set when the verdict depends only on the block's ancestry and so may be recorded:
+// always for pop proofs, but for hive proofs only when the DCT wasn't taken from the UTXO set. The verdict isn't recorded
+// here: the block may not have had its merkle root checked yet.
+static bool CheckBlockProof(const CBlock& block, const Consensus::Params& consensusParams, bool fPopCheckActiveChain, bool* pfCacheable = nullptr)
+{
+    if (pfCacheable)
+        *pfCacheable = false;
+    bool fHive = block.IsHiveMined(consensusParams);
+    if (!fHive && !block.IsPopMined(consensusParams))
+        return true;
+
+    {
+        LOCK(cs_main);
+        const CBlockIndex* pindex = LookupBlockIndex(block.GetHash());
+        if (pindex && pindex->fProofPassed) {
+            if (pfCacheable)
+                *pfCacheable = true;
+            if (fHive || !fPopCheckActiveChain)
+                return true;
+            uint256 gameSourceHash;
+            if (!GetPopProofSourceHash(block, gameSourceHash))
+                return false;
+            const CBlockIndex* pindexSourceBlock = LookupBlockIndex(gameSourceHash);
+            return pindexSourceBlock && chainActive.Contains(pindexSourceBlock);
+        }
+    }
+
+    if (fHive)
+        return CheckHiveProof(&block, consensusParams, pfCacheable);
+    if (!CheckPopProof(&block, consensusParams, fPopCheckActiveChain))
+        return false;
+    if (pfCacheable)
+        *pfCacheable = true;
+    return true;
+}
+
+// Ring-fork: Record that a hive or pop block's proof has passed, once its merkle root shows the proof checked is its own
+static void MarkBlockProofPassed(const CBlock& block, const Consensus::Params& consensusParams)
+{
+    if (!block.IsHiveMined(consensusParams) && !block.IsPopMined(consensusParams))
+        return;
+
+    LOCK(cs_main);
+    CBlockIndex* pindex = LookupBlockIndex(block.GetHash());
+    if (pindex)
+        pindex->fProofPassed = true;
+}
+
 // Ring-fork: Pop: Allow option to not revalidate blocks when deep digging, as all are validated at first load
 bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus::Params& consensusParams, bool fullValidation)
 {
@@ -1094,10 +1152,10 @@ bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus:
     // Ring-fork: Hive: Check PoW or Hive work depending on blocktype
     // Ring-fork: Pop: Check pop work too
     if (block.IsHiveMined(consensusParams)) {
-        if (!CheckHiveProof(&block, consensusParams))
+        if (!CheckBlockProof(block, consensusParams, true))
             return error("ReadBlockFromDisk: Errors in Hive block header at %s", pos.ToString());
     } else if (block.IsPopMined(consensusParams)) {
-        if (!CheckPopProof(&block, consensusParams))
+        if (!CheckBlockProof(block, consensusParams, true))
             return error("ReadBlockFromDisk: Errors in Pop block header at %s", pos.ToString());
     } else {
         if (!CheckProofOfWork(block.GetPowHash(), block.nBits, consensusParams))
@@ -1111,16 +1169,23 @@ bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos, const Consensus:
 bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams, bool fullValidation)
 {
     CDiskBlockPos blockPos;
+    uint256 hashPow;
     {
         LOCK(cs_main);
         blockPos = pindex->GetBlockPos();
+        hashPow = pindex->hashPow;
     }
 
-    if (!ReadBlockFromDisk(block, blockPos, consensusParams, fullValidation))
+    // Ring-fork: If the index has the pow hash, check pow against that instead of recomputing it; the block read
+    // is the one that was checked, as long as its hash matches the index
+    bool fUseStoredPowHash = fullValidation && !hashPow.IsNull();
+    if (!ReadBlockFromDisk(block, blockPos, consensusParams, fullValidation && !fUseStoredPowHash))
         return false;
     if (block.GetHash() != pindex->GetBlockHash())
         return error("ReadBlockFromDisk(CBlock&, CBlockIndex*): GetHash() doesn't match index for %s at %s",
                 pindex->ToString(), pindex->GetBlockPos().ToString());
+    if (fUseStoredPowHash && !CheckProofOfWork(hashPow, block.nBits, consensusParams))
+        return error("ReadBlockFromDisk: Errors in PoW block header at %s", blockPos.ToString());
     return true;
 }
 
@@ -1731,6 +1796,71 @@ void ThreadScriptCheck() {
     scriptcheckqueue.Thread();
 }
 
+// Ring-fork: Computes the pow hash of a header, so that a batch of headers can be hashed in parallel before cs_main is taken.
+// The hash is only compared against the target later, in CheckBlockHeader; so this never fails, and every hash in a batch gets computed.
+class CHeaderPowHash
+{
+private:
+    const CBlockHeader* pheader;
+    uint256* phashPow;
+
+public:
+    CHeaderPowHash() : pheader(nullptr), phashPow(nullptr) {}
+    CHeaderPowHash(const CBlockHeader* pheaderIn, uint256* phashPowIn) : pheader(pheaderIn), phashPow(phashPowIn) {}
+
+    bool operator()() {
+        *phashPow = pheader->GetPowHash();
+        return true;
+    }
+
+    void swap(CHeaderPowHash& check) {
+        std::swap(pheader, check.pheader);
+        std::swap(phashPow, check.phashPow);
+    }
+};
+
+static CCheckQueue<CHeaderPowHash> headerpowhashqueue(16);
+
+void ThreadHeaderPowHash() {
+    RenameThread("ring-hdrpowh");
+    headerpowhashqueue.Thread();
+}
+
+// Ring-fork: Checks the hive or pop proof of a block that LoadExternalBlockFile accepted without it, so that a batch of
+// them can be checked in parallel outside cs_main. Like CHeaderPowHash this never fails; the verdict is acted on later,
+// in CChainState::DeferredProofChecked.
+class CBlockProofCheck
+{
+private:
+    const CBlock* pblock;
+    const Consensus::Params* pconsensusParams;
+    bool* pfPassed;
+    bool* pfCacheable;
+
+public:
+    CBlockProofCheck() : pblock(nullptr), pconsensusParams(nullptr), pfPassed(nullptr), pfCacheable(nullptr) {}
+    CBlockProofCheck(const CBlock* pblockIn, const Consensus::Params* pconsensusParamsIn, bool* pfPassedIn, bool* pfCacheableIn) : pblock(pblockIn), pconsensusParams(pconsensusParamsIn), pfPassed(pfPassedIn), pfCacheable(pfCacheableIn) {}
+
+    bool operator()() {
+        *pfPassed = CheckBlockProof(*pblock, *pconsensusParams, false, pfCacheable);
+        return true;
+    }
+
+    void swap(CBlockProofCheck& check) {
+        std::swap(pblock, check.pblock);
+        std::swap(pconsensusParams, check.pconsensusParams);
+        std::swap(pfPassed, check.pfPassed);
+        std::swap(pfCacheable, check.pfCacheable);
+    }
+};
+
+static CCheckQueue<CBlockProofCheck> blockproofcheckqueue(1);
+
+void ThreadBlockProofCheck() {
+    RenameThread("ring-proofchk");
+    blockproofcheckqueue.Thread();
+}
+
 VersionBitsCache versionbitscache GUARDED_BY(cs_main);
 
 int32_t ComputeBlockVersion(const CBlockIndex* pindexPrev, const Consensus::Params& params)
@@ -2333,6 +2463,194 @@ void static UpdateTip(const CBlockIndex *pindexNew, const CChainParams& chainPar
 
 }
 
+bool GetPopProofSourceHash(const CBlock& block, uint256& gameSourceHash) {
+    if (block.vtx.empty() || block.vtx[0]->vout.empty())
+        return false;
+
+    const CScript& script = block.vtx[0]->vout[0].scriptPubKey;
+    if (script.size() < 36 || script[0] != OP_RETURN || script[1] != OP_GAME)
+        return false;
+
+    // The hash is stored most significant byte first, as it's displayed
+    std::reverse_copy(script.begin() + 4, script.begin() + 36, gameSourceHash.begin());
+    return true;
+}
+
+bool GetHiveProofDCT(const CScript& script, uint256& dctTxid, uint32_t& dwarfNonce) {
+    if (script.size() < 14 + 64 || script[0] != OP_RETURN || script[1] != OP_DWARF)
+        return false;
+
+    // The txid is stored as hex (bytes 14-78; byte 13 has val 64 as size marker). Parsed as CheckHiveProof parses it, so any
+    // block that passes the proof check gets a summary.
+    std::string dctTxidStr(script.begin() + 14, script.begin() + 14 + 64);
+    dctTxid = uint256S(dctTxidStr);
+
+    dwarfNonce = ReadLE32(&script[3]);
+    return true;
+}
+
+bool BuildHiveBlockSummary(const CBlock& block, const Consensus::Params& consensusParams, CHiveBlockSummary& summary) {
+    if (block.vtx.empty() || block.vtx[0]->vout.size() < 2)
+        return false;
+
+    summary = CHiveBlockSummary();
+    if (block.IsHiveMined(consensusParams)) {
+        if (!GetHiveProofDCT(block.vtx[0]->vout[0].scriptPubKey, summary.dctTxid, summary.nDwarfNonce))
+            return false;
+    } else if (block.IsPopMined(consensusParams)) {
+        if (!GetPopProofSourceHash(block, summary.gameSourceHash))
+            return false;
+    } else
+        return false;
+
+    summary.rewardScript = block.vtx[0]->vout[1].scriptPubKey;
+    return true;
+}
+
+// Ring-fork: Hive: Summaries of recent hive and pop blocks, ordered by height so those well below the tip can be dropped. The
+// block tree database holds the rest.
+static std::map<std::pair<int, uint256>, CHiveBlockSummary> mapHiveBlockSummaries GUARDED_BY(cs_main);
+
+bool GetHiveBlockSummary(const CBlockIndex* pindex, const Consensus::Params& consensusParams, CHiveBlockSummary& summary) {
+    AssertLockHeld(cs_main);
+
+    if (!pindex->IsHiveMined(consensusParams) && !pindex->IsPopMined(consensusParams))
+        return false;
+
+    const std::pair<int, uint256> key(pindex->nHeight, pindex->GetBlockHash());
+    auto it = mapHiveBlockSummaries.find(key);
+    if (it != mapHiveBlockSummaries.end()) {
+        summary = it->second;
+        return true;
+    }
+
+    if (!pblocktree || !pblocktree->ReadHiveBlockSummary(pindex->GetBlockHash(), summary)) {
+        // Not seen since summaries were kept; build it from the block, once
+        CBlock block;
+        if (!(pindex->nStatus & BLOCK_HAVE_DATA) || !ReadBlockFromDisk(block, pindex, consensusParams, false))
+            return false;
+        if (!BuildHiveBlockSummary(block, consensusParams, summary))
+            return false;
+        if (pblocktree)
+            pblocktree->WriteHiveBlockSummary(pindex->GetBlockHash(), summary);
+    }
+
+    mapHiveBlockSummaries.emplace(key, summary);
+    return true;
+}
+
+// Ring-fork: Hive: Record the summary of a block being connected, and forget ones well below the tip. Summaries are kept in
+// memory for twice the public game window, so games can be listed and shallow reorgs undone without touching the database.
+static void ConnectHiveBlockSummary(const CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams) EXCLUSIVE_LOCKS_REQUIRED(cs_main) {
+    CHiveBlockSummary summary;
+    const std::pair<int, uint256> key(pindex->nHeight, pindex->GetBlockHash());
+    if (!mapHiveBlockSummaries.count(key) && BuildHiveBlockSummary(block, consensusParams, summary)) {
+        mapHiveBlockSummaries.emplace(key, summary);
+        if (pblocktree)
+            pblocktree->WriteHiveBlockSummary(pindex->GetBlockHash(), summary);
+    }
+
+    int nCutoff = pindex->nHeight - 2 * consensusParams.popMaxPublicGameDepth;
+    while (!mapHiveBlockSummaries.empty() && mapHiveBlockSummaries.begin()->first.first < nCutoff)
+        mapHiveBlockSummaries.erase(mapHiveBlockSummaries.begin());
+}
+
+// Ring-fork: Pop: Games claimed by pop blocks in the active chain, by source block hash, with the claiming block's height. Only
+// claims made above nClaimedGamesFloor are held; that covers every game still claimable on top of the tip, so new claims
+// and available games are checked without reading blocks. Kept in step with the tip by ConnectTip and DisconnectTip.
+static std::map<uint256, int> mapClaimedGames GUARDED_BY(cs_main);
+static std::multimap<int, uint256> mapClaimedGamesByHeight GUARDED_BY(cs_main);
+static int nClaimedGamesFloor GUARDED_BY(cs_main) = 0;
+
+static void AddClaimedGame(const CBlockIndex* pindex, const uint256& gameSourceHash) EXCLUSIVE_LOCKS_REQUIRED(cs_main) {
+    if (mapClaimedGames.emplace(gameSourceHash, pindex->nHeight).second)
+        mapClaimedGamesByHeight.emplace(pindex->nHeight, gameSourceHash);
+}
+
+// Ring-fork: Pop: Drop claims that have fallen below the window, or fill it back in after the tip moves down
+static void UpdateClaimedGamesFloor(const Consensus::Params& consensusParams) EXCLUSIVE_LOCKS_REQUIRED(cs_main) {
+    int nFloor = std::max(chainActive.Height() - consensusParams.popMaxPublicGameDepth, 0);
+    nClaimedGamesFloor = std::min(nClaimedGamesFloor, std::max(chainActive.Height(), 0));
+    while (nClaimedGamesFloor > nFloor) {
+        const CBlockIndex* pindex = chainActive[nClaimedGamesFloor];
+        if (pindex->IsPopMined(consensusParams)) {
+            CHiveBlockSummary summary;
+            if (!GetHiveBlockSummary(pindex, consensusParams, summary))
+                break;                  // Claims from here down are checked by reading blocks, as far as they can be
+            AddClaimedGame(pindex, summary.gameSourceHash);
+        }
+        nClaimedGamesFloor--;
+    }
+
+    if (nClaimedGamesFloor < nFloor) {
+        nClaimedGamesFloor = nFloor;
+        while (!mapClaimedGamesByHeight.empty() && mapClaimedGamesByHeight.begin()->first <= nFloor) {
+            mapClaimedGames.erase(mapClaimedGamesByHeight.begin()->second);
+            mapClaimedGamesByHeight.erase(mapClaimedGamesByHeight.begin());
+        }
+    }
+}
+
+// Ring-fork: Pop: Track claims as blocks are connected to and disconnected from the tip
+static void ConnectClaimedGames(const CBlockIndex* pindex, const Consensus::Params& consensusParams) EXCLUSIVE_LOCKS_REQUIRED(cs_main) {
+    CHiveBlockSummary summary;
+    if (pindex->IsPopMined(consensusParams) && GetHiveBlockSummary(pindex, consensusParams, summary))
+        AddClaimedGame(pindex, summary.gameSourceHash);
+    UpdateClaimedGamesFloor(consensusParams);
+}
+
+static void DisconnectClaimedGames(const CBlockIndex* pindex, const Consensus::Params& consensusParams) EXCLUSIVE_LOCKS_REQUIRED(cs_main) {
+    CHiveBlockSummary summary;
+    if (pindex->IsPopMined(consensusParams) && GetHiveBlockSummary(pindex, consensusParams, summary)) {
+        auto it = mapClaimedGames.find(summary.gameSourceHash);
+        if (it != mapClaimedGames.end() && it->second == pindex->nHeight) {
+            mapClaimedGames.erase(it);
+            auto range = mapClaimedGamesByHeight.equal_range(pindex->nHeight);
+            for (auto itHeight = range.first; itHeight != range.second; ++itHeight) {
+                if (itHeight->second == summary.gameSourceHash) {
+                    mapClaimedGamesByHeight.erase(itHeight);
+                    break;
+                }
+            }
+        }
+    }
+    UpdateClaimedGamesFloor(consensusParams);
+}
+
+// Ring-fork: Pop: Rebuild the claims from the blocks in the window below the tip
+static void LoadClaimedGames(const Consensus::Params& consensusParams) EXCLUSIVE_LOCKS_REQUIRED(cs_main) {
+    mapClaimedGames.clear();
+    mapClaimedGamesByHeight.clear();
+    nClaimedGamesFloor = std::max(chainActive.Height(), 0);
+    UpdateClaimedGamesFloor(consensusParams);
+}
+
+const CBlockIndex* FindGameClaim(const uint256& gameSourceHash, int nSourceHeight, const CBlockIndex* pindex, const Consensus::Params& consensusParams) {
+    AssertLockHeld(cs_main);
+
+    // Blocks off the active chain are checked one by one; so is any of the active chain below the floor
+    const CBlockIndex* pindexFork = chainActive.FindFork(pindex);
+    int nForkHeight = pindexFork ? pindexFork->nHeight : -1;
+    while (pindex && pindex->nHeight > nSourceHeight) {
+        if (pindex->nHeight <= nForkHeight && pindex->nHeight > nClaimedGamesFloor) {
+            auto it = mapClaimedGames.find(gameSourceHash);
+            if (it != mapClaimedGames.end() && it->second <= pindex->nHeight && it->second > nSourceHeight)
+                return chainActive[it->second];
+            pindex = pindex->GetAncestor(nClaimedGamesFloor);
+            continue;
+        }
+
+        if (pindex->IsPopMined(consensusParams)) {
+            CHiveBlockSummary summary;
+            if (GetHiveBlockSummary(pindex, consensusParams, summary) && summary.gameSourceHash == gameSourceHash)
+                return pindex;
+        }
+        pindex = pindex->pprev;
+    }
+
+    return nullptr;
+}
+
 /** Disconnect chainActive's tip.
   * After calling, the mempool will be in an inconsistent state, with
   * transactions from disconnected blocks being added to disconnectpool.  You
@@ -2381,6 +2699,7 @@ bool CChainState::DisconnectTip(CValidationState& state, const CChainParams& cha
     }
 
     chainActive.SetTip(pindexDelete->pprev);
+    DisconnectClaimedGames(pindexDelete, chainparams.GetConsensus());    // Ring-fork: Pop
 
     UpdateTip(pindexDelete->pprev, chainparams);
     // Let wallets know transactions went from 1-confirmed to
@@ -2508,6 +2827,8 @@ bool CChainState::ConnectTip(CValidationState& state, const CChainParams& chainp
     disconnectpool.removeForBlock(blockConnecting.vtx);
     // Update chainActive & related variables.
     chainActive.SetTip(pindexNew);
+    ConnectHiveBlockSummary(blockConnecting, pindexNew, chainparams.GetConsensus());  // Ring-fork: Hive
+    ConnectClaimedGames(pindexNew, chainparams.GetConsensus());                     // Ring-fork: Pop
     UpdateTip(pindexNew, chainparams);
 
     int64_t nTime6 = GetTimeMicros(); nTimePostConnect += nTime6 - nTime5; nTimeTotal += nTime6 - nTime1;
@@ -2974,6 +3295,106 @@ void ResetBlockFailureFlags(CBlockIndex *pindex) {
     return g_chainstate.ResetBlockFailureFlags(pindex);
 }
 
+void CChainState::AssumedPowChecked(CBlockIndex* pindex, const uint256& hashPow, const Consensus::Params& consensusParams) {
+    AssertLockHeld(cs_main);
+
+    pindex->nStatus &= ~BLOCK_POW_ASSUMED;
+    setDirtyBlockIndex.insert(pindex);
+    if (CheckProofOfWork(hashPow, pindex->nBits, consensusParams)) {
+        pindex->hashPow = hashPow;
+    } else {
+        CValidationState state;
+        state.DoS(100, false, REJECT_INVALID, "high-hash", false, "proof of work failed");
+        LogPrintf("%s: Header %s accepted without a pow check fails its pow check\n", __func__, pindex->GetBlockHash().ToString());
+        InvalidBlockFound(pindex, state);
+    }
+}
+
+void CChainState::DeferredProofChecked(CBlockIndex* pindex, bool fPassed, bool fCacheable, const Consensus::Params& consensusParams) {
+    AssertLockHeld(cs_main);
+
+    if (fPassed) {
+        pindex->fProofPassed = fCacheable;      // Otherwise it's checked again when the block is connected
+        return;
+    }
+
+    CValidationState state;
+    if (pindex->IsHiveMined(consensusParams))
+        state.DoS(100, false, REJECT_INVALID, "bad-hive-proof", false, "proof of hive failed");
+    else
+        state.DoS(100, false, REJECT_INVALID, "bad-pop-proof", false, "proof of play failed");
+    LogPrintf("%s: Block %s loaded from file fails its deferred proof check\n", __func__, pindex->GetBlockHash().ToString());
+    InvalidBlockFound(pindex, state);
+}
+
+// Ring-fork: Headers accepted with BLOCK_POW_ASSUMED that ThreadCheckAssumedPow() hasn't picked up yet. They're only queued
+// while the thread runs, so it's woken for new ones rather than rescanning the block index.
+static bool fCheckingAssumedPow GUARDED_BY(cs_main) = false;
+static boost::mutex csAssumedPowQueue;
+static boost::condition_variable condAssumedPowQueue;
+static std::vector<CBlockIndex*> vAssumedPowQueue;
+
+static void QueueAssumedPowCheck(CBlockIndex* pindex) EXCLUSIVE_LOCKS_REQUIRED(cs_main) {
+    AssertLockHeld(cs_main);
+
+    if (!fCheckingAssumedPow)
+        return;
+    boost::unique_lock<boost::mutex> lock(csAssumedPowQueue);
+    vAssumedPowQueue.push_back(pindex);
+    condAssumedPowQueue.notify_one();
+}
+
+void ThreadCheckAssumedPow(const CChainParams& chainparams) {
+    RenameThread("ring-powcheck");
+    LogPrintf("%s: Thread started\n", __func__);
+
+    MinotaurBatch batch;
+    CBlockHeader headers[MinotaurBatch::MAX_LANES];
+    const unsigned char* data[MinotaurBatch::MAX_LANES];
+    unsigned char hashes[MinotaurBatch::MAX_LANES * 32];
+    for (unsigned int i = 0; i < MinotaurBatch::MAX_LANES; i++)
+        data[i] = (const unsigned char*)&headers[i].nVersion;
+
+    // Find the headers loaded from disk still waiting for a pow check; any accepted from now on are queued
+    std::vector<CBlockIndex*> vAssumed;
+    {
+        LOCK(cs_main);
+        fCheckingAssumedPow = true;
+        for (const std::pair<const uint256, CBlockIndex*>& item : mapBlockIndex)
+            if (item.second->nStatus & BLOCK_POW_ASSUMED)
+                vAssumed.push_back(item.second);
+    }
+
+    while (true) {
+        if (vAssumed.empty()) {
+            boost::unique_lock<boost::mutex> lock(csAssumedPowQueue);
+            while (vAssumedPowQueue.empty())
+                condAssumedPowQueue.wait(lock);
+            vAssumed.swap(vAssumedPowQueue);
+        }
+        LogPrintf("%s: Checking the pow of %u headers\n", __func__, vAssumed.size());
+
+        // Hash in batches without holding cs_main (header fields don't change once in the block index)
+        for (size_t i = 0; i < vAssumed.size(); i += MinotaurBatch::MAX_LANES) {
+            boost::this_thread::interruption_point();
+            unsigned int count = std::min<size_t>(MinotaurBatch::MAX_LANES, vAssumed.size() - i);
+            for (unsigned int j = 0; j < count; j++)
+                headers[j] = vAssumed[i + j]->GetBlockHeader();
+            batch.Hash(data, 80, count, hashes);
+
+            LOCK(cs_main);
+            for (unsigned int j = 0; j < count; j++) {
+                if (!(vAssumed[i + j]->nStatus & BLOCK_POW_ASSUMED))
+                    continue;
+                uint256 hashPow;
+                memcpy(hashPow.begin(), hashes + j * 32, 32);
+                g_chainstate.AssumedPowChecked(vAssumed[i + j], hashPow, chainparams.GetConsensus());
+            }
+        }
+        vAssumed.clear();
+    }
+}
+
 CBlockIndex* CChainState::AddToBlockIndex(const CBlockHeader& block)
 {
     AssertLockHeld(cs_main);
@@ -2999,6 +3420,7 @@ CBlockIndex* CChainState::AddToBlockIndex(const CBlockHeader& block)
         pindexNew->nHeight = pindexNew->pprev->nHeight + 1;
         pindexNew->BuildSkip();
     }
+    pindexNew->BuildHiveContext(Params().GetConsensus());   // Ring-fork: Hive: Chain context
     pindexNew->nTimeMax = (pindexNew->pprev ? std::max(pindexNew->pprev->nTimeMax, pindexNew->nTime) : pindexNew->nTime);
     pindexNew->nChainWork = (pindexNew->pprev ? pindexNew->pprev->nChainWork : 0) + GetBlockProof(*pindexNew);
     pindexNew->RaiseValidity(BLOCK_VALID_TREE);
@@ -3145,20 +3567,26 @@ static bool FindUndoPos(CValidationState &state, int nFile, CDiskBlockPos &pos,
     return true;
 }
 
-static bool CheckBlockHeader(const CBlockHeader& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true)
+// Ring-fork: If phashPow is given, it receives the pow hash of pow blocks which pass the pow check.
+// If it already holds a (non-null) hash, that's taken to be the block's pow hash rather than computing it again.
+static bool CheckBlockHeader(const CBlockHeader& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true, uint256* phashPow = nullptr)
 {
     // Ring-fork: Hive: Only check pow header blocks
     // Ring-fork: Pop: Still only check pow header blocks
     if (fCheckPOW && !block.IsHiveMined(consensusParams) && !block.IsPopMined(consensusParams)) {
-        if (!CheckProofOfWork(block.GetPowHash(), block.nBits, consensusParams))
+        uint256 hashPow = (phashPow && !phashPow->IsNull()) ? *phashPow : block.GetPowHash();
+        if (!CheckProofOfWork(hashPow, block.nBits, consensusParams))
             return state.DoS(50, false, REJECT_INVALID, "high-hash", false, "proof of work failed");
+        if (phashPow)
+            *phashPow = hashPow;
     }
 
     return true;
 }
 
 // Ring-fork: Pop: Added fPopCheckActiveChain
-bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW, bool fCheckMerkleRoot, bool fPopCheckActiveChain)
+// Ring-fork: Added fCheckProofs, false when the caller checks the hive or pop proof itself (see LoadExternalBlockFile)
+bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW, bool fCheckMerkleRoot, bool fPopCheckActiveChain, bool fCheckProofs)
 {
     // These are checks that are independent of context.
 
@@ -3172,12 +3600,15 @@ bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::P
 
     // Ring-fork: Hive: Check Hive proof
     // Ring-fork: Pop: Check pop proof
-    if (block.IsHiveMined(consensusParams)) {
-        if (!CheckHiveProof(&block, consensusParams))
-            return state.DoS(100, false, REJECT_INVALID, "bad-hive-proof", false, "proof of hive failed");
-    } else if (block.IsPopMined(consensusParams)) {
-        if (!CheckPopProof(&block, consensusParams, fPopCheckActiveChain))
-            return state.DoS(100, false, REJECT_INVALID, "bad-pop-proof", false, "proof of play failed");
+    bool fProofCacheable = false;
+    if (fCheckProofs) {
+        if (block.IsHiveMined(consensusParams)) {
+            if (!CheckBlockProof(block, consensusParams, fPopCheckActiveChain, &fProofCacheable))
+                return state.DoS(100, false, REJECT_INVALID, "bad-hive-proof", false, "proof of hive failed");
+        } else if (block.IsPopMined(consensusParams)) {
+            if (!CheckBlockProof(block, consensusParams, fPopCheckActiveChain, &fProofCacheable))
+                return state.DoS(100, false, REJECT_INVALID, "bad-pop-proof", false, "proof of play failed");
+        }
     }
 
     // Check the merkle root.
@@ -3192,6 +3623,11 @@ bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::P
         // while still invalidating it.
         if (mutated)
             return state.DoS(100, false, REJECT_INVALID, "bad-txns-duplicate", true, "duplicate transaction");
+
+        // Ring-fork: The proof checked above is this block's own, so it needn't be checked again if its verdict holds on
+        // any branch the block may end up connected to
+        if (fProofCacheable)
+            MarkBlockProofPassed(block, consensusParams);
     }
 
     // All potential-corruption validation must be done before we do any
@@ -3225,7 +3661,7 @@ bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::P
     if (nSigOps * WITNESS_SCALE_FACTOR > MAX_BLOCK_SIGOPS_COST)
         return state.DoS(100, false, REJECT_INVALID, "bad-blk-sigops", false, "out-of-bounds SigOpCount");
 
-    if (fCheckPOW && fCheckMerkleRoot)
+    if (fCheckPOW && fCheckMerkleRoot && fCheckProofs)
         block.fChecked = true;
 
     return true;
@@ -3243,19 +3679,13 @@ std::string GetDeterministicRandString(const CBlockIndex* pindexPrev) {
 
     std::string deterministicRandString = "";
     int heights[] = { 0, 21, 173, 471, 1363, 12103 };
-    int hits = 0, steps = 0;
-    while (hits < 6) {
-        if (steps == heights[hits]) {
-            assert(pindexPrev->phashBlock);
-            deterministicRandString += pindexPrev->phashBlock->GetHex();
-            hits++;
-        }
-
-        if (!pindexPrev->pprev)
+    for (int steps : heights) {
+        if (steps > pindexPrev->nHeight)
             break;
 
-        pindexPrev = pindexPrev->pprev;
-        steps++;
+        const CBlockIndex* pindex = pindexPrev->GetAncestor(pindexPrev->nHeight - steps);
+        assert(pindex->phashBlock);
+        deterministicRandString += pindex->phashBlock->GetHex();
     }
     return deterministicRandString;
 }
@@ -3266,10 +3696,8 @@ bool GetTxByHashAndHeight(const uint256 txHash, const int nHeight, CTransactionR
     if (pindex->nHeight < nHeight)
         return false;
 
-    while(pindex->nHeight > nHeight) {
-        assert(pindex->pprev);
-        pindex = pindex->pprev;
-    }
+    pindex = pindex->GetAncestor(nHeight);
+    assert(pindex);
 
     CBlock block;
     std::set<uint256> txids;
@@ -3295,6 +3723,70 @@ bool GetTxByHashAndHeight(const uint256 txHash, const int nHeight, CTransactionR
     return false;
 }
 
+// Ring-fork: Hive: DCTs seen in accepted blocks, by txid (a DCT can be mined on more than one branch). Blocks are
+// accepted in order during -reindex, before any are connected, so this is what lets hive proofs be checked there
+// without drilling into the block files; it only holds DCTs young enough to be claimed near the highest block.
+static std::map<uint256, std::vector<CDCTLocation>> mapDCTLocations GUARDED_BY(cs_main);
+static std::multimap<int, uint256> mapDCTLocationsByHeight GUARDED_BY(cs_main);
+static int nDCTLocationsHighest GUARDED_BY(cs_main) = 0;
+
+void AddBlockDCTLocations(const CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams) {
+    AssertLockHeld(cs_main);
+
+    if (pindex->nHeight < consensusParams.minHiveCheckBlock
+        || block.IsHiveMined(consensusParams)   // No DCTs in hive or pop blocks
+        || block.IsPopMined(consensusParams))
+        return;
+
+    CScript scriptPubKeyBCF = GetScriptForDestination(DecodeDestination(consensusParams.dwarfCreationAddress));
+    for (const auto& tx : block.vtx) {
+        if (tx->IsCoinBase() || !tx->IsDCT(consensusParams, scriptPubKeyBCF))
+            continue;
+
+        CDCTLocation location;
+        location.blockHash = pindex->GetBlockHash();
+        location.nHeight = pindex->nHeight;
+        location.vout.assign(tx->vout.begin(), tx->vout.begin() + std::min<size_t>(tx->vout.size(), 2));
+        mapDCTLocations[tx->GetHash()].push_back(location);
+        mapDCTLocationsByHeight.emplace(pindex->nHeight, tx->GetHash());
+    }
+
+    // Forget DCTs that died before anything within a download window of the highest block could claim them
+    nDCTLocationsHighest = std::max(nDCTLocationsHighest, pindex->nHeight);
+    int nExpiry = nDCTLocationsHighest - (int)BLOCK_DOWNLOAD_WINDOW - consensusParams.dwarfGestationBlocks - consensusParams.dwarfLifespanBlocks;
+    while (!mapDCTLocationsByHeight.empty() && mapDCTLocationsByHeight.begin()->first < nExpiry) {
+        auto it = mapDCTLocations.find(mapDCTLocationsByHeight.begin()->second);
+        if (it != mapDCTLocations.end()) {
+            std::vector<CDCTLocation>& locations = it->second;
+            locations.erase(std::remove_if(locations.begin(), locations.end(), [nExpiry](const CDCTLocation& location) { return location.nHeight < nExpiry; }), locations.end());
+            if (locations.empty())
+                mapDCTLocations.erase(it);
+        }
+        mapDCTLocationsByHeight.erase(mapDCTLocationsByHeight.begin());
+    }
+}
+
+bool GetDCTLocation(const uint256& txHash, int nHeight, const CBlockIndex* pindex, CDCTLocation& locationOut) {
+    AssertLockHeld(cs_main);
+
+    if (pindex->nHeight < nHeight)
+        return false;
+
+    auto it = mapDCTLocations.find(txHash);
+    if (it == mapDCTLocations.end())
+        return false;
+
+    const CBlockIndex* pindexAtHeight = pindex->GetAncestor(nHeight);
+    for (const CDCTLocation& location : it->second) {
+        if (location.nHeight == nHeight && location.blockHash == pindexAtHeight->GetBlockHash()) {
+            locationOut = location;
+            return true;
+        }
+    }
+
+    return false;
+}
+
 bool IsNullDummyEnabled(const CBlockIndex* pindexPrev, const Consensus::Params& params)
 {
     LOCK(cs_main);
@@ -3508,11 +4000,108 @@ static bool ContextualCheckBlock(const CBlock& block, CValidationState& state, c
     return true;
 }
 
-bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex)
+// Ring-fork: Whether the header at nHeight with the given hash anchors assumed pow: a checkpoint, or the default assumevalid
+// block. Either commits to all its ancestors.
+static bool IsPowAnchor(const uint256& hash, int nHeight, const CChainParams& chainparams)
+{
+    const MapCheckpoints& checkpoints = chainparams.Checkpoints().mapCheckpoints;
+    MapCheckpoints::const_iterator it = checkpoints.find(nHeight);
+    if (it != checkpoints.end() && it->second == hash)
+        return true;
+    return hash == chainparams.GetConsensus().defaultAssumeValid;
+}
+
+// Ring-fork: Which of a run of headers building on pindexBase can be accepted without checking their pow. That's the case for
+// pow headers that lead, through the run's own hashPrevBlock links, to an anchor (see IsPowAnchor); a header that isn't one of
+// the anchor's ancestors can't be assumed. Full blocks still have their pow checked in CheckBlock, so no block is connected on
+// an assumed header alone.
+static std::vector<bool> GetHeadersPowAssumed(const std::vector<CBlockHeader>& headers, const CBlockIndex* pindexBase, const CChainParams& chainparams) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+{
+    AssertLockHeld(cs_main);
+
+    std::vector<bool> vPowAssumed(headers.size(), false);
+    if (!fAssumeCheckpointedPow || !fCheckpointsEnabled || !pindexBase)
+        return vPowAssumed;
+
+    // Walk back from the last header, remembering whether the links seen so far reach an anchor
+    const Consensus::Params& consensusParams = chainparams.GetConsensus();
+    bool fLeadsToAnchor = false;
+    for (size_t i = headers.size(); i-- > 0; ) {
+        const uint256 hash = headers[i].GetHash();
+        if (i + 1 < headers.size() && headers[i + 1].hashPrevBlock != hash)
+            fLeadsToAnchor = false;
+        if (IsPowAnchor(hash, pindexBase->nHeight + 1 + i, chainparams))
+            fLeadsToAnchor = true;
+        vPowAssumed[i] = fLeadsToAnchor && !headers[i].IsHiveMined(consensusParams) && !headers[i].IsPopMined(consensusParams);
+    }
+    return vPowAssumed;
+}
+
+// Ring-fork: Runs of headers held back during header sync until a later run links them to an anchor, so they can be accepted
+// without a pow check too. Each one's hashPrevBlock is either another held header or in the block index. They're capped, and
+// all dropped once the best header is past the last checkpoint, as nothing can be held from then on.
+static const size_t MAX_POW_PENDING_HEADERS = 50000;
+static std::unordered_map<uint256, CBlockHeader, BlockHasher> mapPowPendingHeaders GUARDED_BY(cs_main);
+
+bool IsHeaderPowPending(const uint256& hash)
+{
+    AssertLockHeld(cs_main);
+    return mapPowPendingHeaders.count(hash) > 0;
+}
+
+// Ring-fork: Work out which headers to accept for a run received during header sync: the held headers it builds on, if any,
+// then its own, in vAccept, with pindexBase set to the block index entry the first builds on (or nullptr if there's none).
+// Returns true if the run was held back instead, as it doesn't lead to an anchor yet but could still be followed by one.
+static bool HoldPowPendingHeaders(const std::vector<CBlockHeader>& headers, const CChainParams& chainparams, std::vector<CBlockHeader>& vAccept, const CBlockIndex*& pindexBase) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+{
+    AssertLockHeld(cs_main);
+
+    // Collect the held headers the run builds on, and release them
+    std::vector<CBlockHeader> vHeld;
+    for (auto it = mapPowPendingHeaders.find(headers[0].hashPrevBlock); it != mapPowPendingHeaders.end(); it = mapPowPendingHeaders.find(it->second.hashPrevBlock))
+        vHeld.push_back(it->second);
+    for (const CBlockHeader& header : vHeld)
+        mapPowPendingHeaders.erase(header.GetHash());
+    vAccept.assign(vHeld.rbegin(), vHeld.rend());
+    vAccept.insert(vAccept.end(), headers.begin(), headers.end());
+    pindexBase = LookupBlockIndex(vAccept[0].hashPrevBlock);
+
+    // Single headers (announcements, compact blocks, submitheader) are never held
+    const MapCheckpoints& checkpoints = chainparams.Checkpoints().mapCheckpoints;
+    if (!fAssumeCheckpointedPow || !fCheckpointsEnabled || checkpoints.empty() || !pindexBase || headers.size() < 2)
+        return false;
+    const int nLastCheckpoint = checkpoints.rbegin()->first;
+    if (pindexBestHeader && pindexBestHeader->nHeight >= nLastCheckpoint) {
+        mapPowPendingHeaders.clear();
+        return false;
+    }
+
+    // Hold the run only if it's new, unbroken, short of the last checkpoint and without an anchor of its own
+    if (LookupBlockIndex(headers.back().GetHash()) || pindexBase->nHeight + (int)vAccept.size() >= nLastCheckpoint)
+        return false;
+    if (mapPowPendingHeaders.size() + headers.size() > MAX_POW_PENDING_HEADERS)
+        return false;
+    for (size_t i = 0; i < vAccept.size(); i++) {
+        const uint256 hash = vAccept[i].GetHash();
+        if (i + 1 < vAccept.size() && vAccept[i + 1].hashPrevBlock != hash)
+            return false;
+        if (IsPowAnchor(hash, pindexBase->nHeight + 1 + i, chainparams))
+            return false;
+    }
+    for (const CBlockHeader& header : vAccept)
+        mapPowPendingHeaders.emplace(header.GetHash(), header);
+    return true;
+}
+
+// Ring-fork: Added phashPowKnown and fPowAssumed
+bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, const uint256* phashPowKnown, bool fPowAssumed)
 {
     AssertLockHeld(cs_main);
     // Check for duplicate
     uint256 hash = block.GetHash();
+    uint256 hashPow;
+    if (phashPowKnown)
+        hashPow = *phashPowKnown;
     BlockMap::iterator miSelf = mapBlockIndex.find(hash);
     CBlockIndex *pindex = nullptr;
     if (hash != chainparams.GetConsensus().hashGenesisBlock) {
@@ -3526,7 +4115,11 @@ bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState&
             return true;
         }
 
-        if (!CheckBlockHeader(block, state, chainparams.GetConsensus()))
+        // Ring-fork: Headers known to lead to a checkpoint may skip the pow check; it can be done later by ThreadCheckAssumedPow()
+        if (fPowAssumed)
+            hashPow.SetNull();
+
+        if (!CheckBlockHeader(block, state, chainparams.GetConsensus(), !fPowAssumed, &hashPow))
             return error("%s: Consensus::CheckBlockHeader: %s, %s", __func__, hash.ToString(), FormatStateMessage(state));
 
         // Get prev block index
@@ -3578,8 +4171,14 @@ bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState&
             }
         }
     }
-    if (pindex == nullptr)
+    if (pindex == nullptr) {
         pindex = AddToBlockIndex(block);
+        pindex->hashPow = hashPow;      // Ring-fork: Keep the pow hash we just checked
+        if (fPowAssumed) {
+            pindex->nStatus |= BLOCK_POW_ASSUMED;
+            QueueAssumedPowCheck(pindex);
+        }
+    }
 
     if (ppindex)
         *ppindex = pindex;
@@ -3593,11 +4192,56 @@ bool CChainState::AcceptBlockHeader(const CBlockHeader& block, CValidationState&
 bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& headers, CValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex, CBlockHeader *first_invalid)
 {
     if (first_invalid != nullptr) first_invalid->SetNull();
+    if (headers.empty())
+        return true;
+
+    // Ring-fork: Hold the headers back if they may yet turn out to lead to an anchor, or pick up the held ones they build on
+    std::vector<CBlockHeader> vAccept;
+    const CBlockIndex* pindexBase;
+    {
+        LOCK(cs_main);
+        if (HoldPowPendingHeaders(headers, chainparams, vAccept, pindexBase)) {
+            if (ppindex)
+                *ppindex = pindexBase;
+            return true;
+        }
+    }
+
+    // Ring-fork: Hash the pow headers we haven't seen yet across the header pow hashing threads, before taking cs_main.
+    // Only the cheap target comparison and the contextual checks are then left to do under the lock.
+    std::vector<uint256> vHashPow(vAccept.size());
+    if (nScriptCheckThreads && vAccept.size() > 1) {
+        const Consensus::Params& consensusParams = chainparams.GetConsensus();
+        std::vector<CHeaderPowHash> vChecks;
+        {
+            LOCK(cs_main);
+            // Headers whose pow will be assumed don't need hashing
+            std::vector<bool> vPowAssumed = GetHeadersPowAssumed(vAccept, pindexBase, chainparams);
+            for (size_t i = 0; i < vAccept.size(); i++) {
+                const CBlockHeader& header = vAccept[i];
+                if (header.IsHiveMined(consensusParams) || header.IsPopMined(consensusParams))
+                    continue;
+                if (mapBlockIndex.count(header.GetHash()))
+                    continue;
+                if (vPowAssumed[i])
+                    continue;
+                vChecks.emplace_back(&header, &vHashPow[i]);
+            }
+        }
+        CCheckQueueControl<CHeaderPowHash> control(&headerpowhashqueue);
+        control.Add(vChecks);
+        control.Wait();
+    }
+
     {
         LOCK(cs_main);
-        for (const CBlockHeader& header : headers) {
+        // Ring-fork: Worked out again, as the block index may have changed since the headers were hashed; a header
+        // that's no longer assumed but wasn't hashed gets hashed in AcceptBlockHeader
+        std::vector<bool> vPowAssumed = GetHeadersPowAssumed(vAccept, LookupBlockIndex(vAccept[0].hashPrevBlock), chainparams);
+        for (size_t i = 0; i < vAccept.size(); i++) {
+            const CBlockHeader& header = vAccept[i];
             CBlockIndex *pindex = nullptr; // Use a temp pindex instead of ppindex to avoid a const_cast
-            if (!g_chainstate.AcceptBlockHeader(header, state, chainparams, &pindex)) {
+            if (!g_chainstate.AcceptBlockHeader(header, state, chainparams, &pindex, &vHashPow[i], vPowAssumed[i])) {
                 if (first_invalid) *first_invalid = header;
                 return false;
             }
@@ -3631,7 +4275,7 @@ static CDiskBlockPos SaveBlockToDisk(const CBlock& block, int nHeight, const CCh
 
 /** Store block on disk. If dbp is non-nullptr, the file is known to already reside on disk */
 // Ring-fork: Pop: Added fPopCheckActiveChain
-bool CChainState::AcceptBlock(const std::shared_ptr<const CBlock>& pblock, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fRequested, const CDiskBlockPos* dbp, bool* fNewBlock, bool fPopCheckActiveChain)
+bool CChainState::AcceptBlock(const std::shared_ptr<const CBlock>& pblock, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fRequested, const CDiskBlockPos* dbp, bool* fNewBlock, bool fPopCheckActiveChain, bool fCheckProofs)
 {
     const CBlock& block = *pblock;
 
@@ -3677,7 +4321,8 @@ bool CChainState::AcceptBlock(const std::shared_ptr<const CBlock>& pblock, CVali
     }
 
     // Ring-fork: Pop: Added fPopCheckActiveChain
-    if (!CheckBlock(block, state, chainparams.GetConsensus(), true, true, fPopCheckActiveChain) ||
+    // Ring-fork: Added fCheckProofs
+    if (!CheckBlock(block, state, chainparams.GetConsensus(), true, true, fPopCheckActiveChain, fCheckProofs) ||
         !ContextualCheckBlock(block, state, chainparams.GetConsensus(), pindex->pprev)) {
         if (state.IsInvalid() && !state.CorruptionPossible()) {
             pindex->nStatus |= BLOCK_FAILED_VALID;
@@ -3686,9 +4331,15 @@ bool CChainState::AcceptBlock(const std::shared_ptr<const CBlock>& pblock, CVali
         return error("%s: %s", __func__, FormatStateMessage(state));
     }
 
+    // Ring-fork: A block already checked by ProcessNewBlock skipped CheckBlock above, so record its proof as passed here.
+    // Only pop verdicts are known to depend on the block's ancestry alone; a hive verdict may have come from the UTXO set.
+    if (fCheckProofs && block.IsPopMined(chainparams.GetConsensus()))
+        pindex->fProofPassed = true;
+
     // Header is valid/has work, merkle tree and segwit merkle tree are good...RELAY NOW
     // (but if it does not build on our best tip, let the SendMessages loop relay it)
-    if (!IsInitialBlockDownload() && chainActive.Tip() == pindex->pprev)
+    // Ring-fork: Not if its proof check was deferred; it's relayed once connected, like any other block
+    if (fCheckProofs && !IsInitialBlockDownload() && chainActive.Tip() == pindex->pprev)
         GetMainSignals().NewPoWValidBlock(pindex, pblock);
 
     // Write block to history file
@@ -3700,6 +4351,7 @@ bool CChainState::AcceptBlock(const std::shared_ptr<const CBlock>& pblock, CVali
             return false;
         }
         ReceivedBlockTransactions(block, pindex, blockPos, chainparams.GetConsensus());
+        AddBlockDCTLocations(block, pindex, chainparams.GetConsensus());    // Ring-fork: Hive
     } catch (const std::runtime_error& e) {
         return AbortNode(state, std::string("System error: ") + e.what());
     }
@@ -4020,6 +4672,7 @@ bool CChainState::LoadBlockIndex(const Consensus::Params& consensus_params, CBlo
     for (const std::pair<int, CBlockIndex*>& item : vSortedByHeight)
     {
         CBlockIndex* pindex = item.second;
+        pindex->BuildHiveContext(consensus_params);             // Ring-fork: Hive: Chain context
         pindex->nChainWork = (pindex->pprev ? pindex->pprev->nChainWork : 0) + GetBlockProof(*pindex);
         pindex->nTimeMax = (pindex->pprev ? std::max(pindex->pprev->nTimeMax, pindex->nTime) : pindex->nTime);
         // We can link the chain of blocks for which we've received transactions at some point.
@@ -4129,6 +4782,7 @@ bool LoadChainTip(const CChainParams& chainparams)
         return false;
     }
     chainActive.SetTip(pindex);
+    LoadClaimedGames(chainparams.GetConsensus());    // Ring-fork: Pop
 
     g_chainstate.PruneBlockIndexCandidates();
 
@@ -4501,6 +5155,16 @@ void UnloadBlockIndex()
 {
     LOCK(cs_main);
     chainActive.SetTip(nullptr);
+    mapClaimedGames.clear();                        // Ring-fork: Pop
+    mapClaimedGamesByHeight.clear();
+    nClaimedGamesFloor = 0;
+    mapHiveBlockSummaries.clear();                  // Ring-fork: Hive
+    mapPowPendingHeaders.clear();                   // Ring-fork
+    fCheckingAssumedPow = false;                    // Ring-fork: ThreadCheckAssumedPow() has stopped by now
+    {
+        boost::unique_lock<boost::mutex> lock(csAssumedPowQueue);
+        vAssumedPowQueue.clear();
+    }
     pindexBestInvalid = nullptr;
     pindexBestHeader = nullptr;
     mempool.clear();
@@ -4545,6 +5209,50 @@ bool LoadBlockIndex(const CChainParams& chainparams)
     return true;
 }
 
+// Ring-fork: Block index entries written before pow hashes were stored don't have them. Work them out once, on the
+// header hash threads and without cs_main held, then store them all under one lock; the entries are marked dirty so
+// they're written back with the next flush.
+void StoreMissingPowHashes(const CChainParams& chainparams)
+{
+    AssertLockNotHeld(cs_main);
+
+    std::vector<CBlockIndex*> vMissingPowHash;
+    std::vector<CBlockHeader> vHeaders;
+    {
+        LOCK(cs_main);
+        for (const std::pair<const uint256, CBlockIndex*>& item : mapBlockIndex) {
+            CBlockIndex* pindex = item.second;
+            if (!pindex->hashPow.IsNull() || (pindex->nStatus & BLOCK_POW_ASSUMED))
+                continue;
+            CBlockHeader header = pindex->GetBlockHeader();
+            if (header.IsHiveMined(chainparams.GetConsensus()) || header.IsPopMined(chainparams.GetConsensus()))
+                continue;
+            vMissingPowHash.push_back(pindex);
+            vHeaders.push_back(header);
+        }
+    }
+    if (vMissingPowHash.empty())
+        return;
+
+    LogPrintf("%s: Storing pow hashes for %u block index entries...\n", __func__, vMissingPowHash.size());
+    std::vector<uint256> vHashPow(vHeaders.size());
+    {
+        std::vector<CHeaderPowHash> vChecks;
+        vChecks.reserve(vHeaders.size());
+        for (size_t i = 0; i < vHeaders.size(); i++)
+            vChecks.emplace_back(&vHeaders[i], &vHashPow[i]);
+        CCheckQueueControl<CHeaderPowHash> control(&headerpowhashqueue);
+        control.Add(vChecks);
+        control.Wait();
+    }
+
+    LOCK(cs_main);
+    for (size_t i = 0; i < vMissingPowHash.size(); i++) {
+        vMissingPowHash[i]->hashPow = vHashPow[i];
+        setDirtyBlockIndex.insert(vMissingPowHash[i]);
+    }
+}
+
 bool CChainState::LoadGenesisBlock(const CChainParams& chainparams)
 {
     LOCK(cs_main);
@@ -4575,12 +5283,40 @@ bool LoadGenesisBlock(const CChainParams& chainparams)
     return g_chainstate.LoadGenesisBlock(chainparams);
 }
 
+void CheckDeferredBlockProofs(std::vector<CDeferredBlockProof>& vDeferred, const CChainParams& chainparams)
+{
+    AssertLockNotHeld(cs_main);
+    if (vDeferred.empty())
+        return;
+
+    {
+        std::vector<CBlockProofCheck> vChecks;
+        vChecks.reserve(vDeferred.size());
+        for (CDeferredBlockProof& deferred : vDeferred) {
+            deferred.fPassed = deferred.fCacheable = false;
+            vChecks.emplace_back(deferred.pblock.get(), &chainparams.GetConsensus(), &deferred.fPassed, &deferred.fCacheable);
+        }
+        CCheckQueueControl<CBlockProofCheck> control(&blockproofcheckqueue);
+        control.Add(vChecks);
+        control.Wait();
+    }
+
+    LOCK(cs_main);
+    for (const CDeferredBlockProof& deferred : vDeferred)
+        g_chainstate.DeferredProofChecked(deferred.pindex, deferred.fPassed, deferred.fCacheable, chainparams.GetConsensus());
+    vDeferred.clear();
+}
+
 bool LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, CDiskBlockPos *dbp)
 {
     // Map of disk positions for blocks with unknown parent (only used for reindex)
     static std::multimap<uint256, CDiskBlockPos> mapBlocksUnknownParent;
     int64_t nStart = GetTimeMillis();
 
+    // Ring-fork: Hive and pop blocks are accepted without their proofs, which are then checked in batches in parallel.
+    // The block data comes from our own files, and every proof is still checked before the block can be connected.
+    std::vector<CDeferredBlockProof> vDeferred;
+
     int nLoaded = 0;
     try {
         // This takes over fileIn and calls fclose() on it in the CBufferedFile destructor
@@ -4637,8 +5373,11 @@ bool LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, CDiskB
                     CBlockIndex* pindex = LookupBlockIndex(hash);
                     if (!pindex || (pindex->nStatus & BLOCK_HAVE_DATA) == 0) {
                       CValidationState state;
-                      if (g_chainstate.AcceptBlock(pblock, state, chainparams, nullptr, true, dbp, nullptr, false)) {   // Ring-fork: Pop: Pass fPopCheckActiveChain=false
+                      bool fNewBlock = false;
+                      if (g_chainstate.AcceptBlock(pblock, state, chainparams, &pindex, true, dbp, &fNewBlock, false, false)) {   // Ring-fork: Pop: Pass fPopCheckActiveChain=false; Ring-fork: Defer the proof check
                           nLoaded++;
+                          if (fNewBlock && (block.IsHiveMined(chainparams.GetConsensus()) || block.IsPopMined(chainparams.GetConsensus())))
+                              vDeferred.push_back({pblock, pindex, false, false});
                       }
                       if (state.IsError()) {
                           break;
@@ -4648,6 +5387,10 @@ bool LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, CDiskB
                     }
                 }
 
+                // Ring-fork: Check a full batch of deferred proofs
+                if (vDeferred.size() >= BLOCK_PROOF_CHECK_BATCH_SIZE)
+                    CheckDeferredBlockProofs(vDeferred, chainparams);
+
                 // Activate the genesis block so normal node progress can continue
                 if (hash == chainparams.GetConsensus().hashGenesisBlock) {
                     CValidationState state;
@@ -4674,10 +5417,14 @@ bool LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, CDiskB
                                     head.ToString());
                             LOCK(cs_main);
                             CValidationState dummy;
-                            if (g_chainstate.AcceptBlock(pblockrecursive, dummy, chainparams, nullptr, true, &it->second, nullptr, false))  // Ring-fork: Pop: Pass fPopCheckActiveChain=false
+                            CBlockIndex* pindexRecursive = nullptr;
+                            bool fNewBlock = false;
+                            if (g_chainstate.AcceptBlock(pblockrecursive, dummy, chainparams, &pindexRecursive, true, &it->second, &fNewBlock, false, false))  // Ring-fork: Pop: Pass fPopCheckActiveChain=false; Ring-fork: Defer the proof check
                             {
                                 nLoaded++;
                                 queue.push_back(pblockrecursive->GetHash());
+                                if (fNewBlock && (pblockrecursive->IsHiveMined(chainparams.GetConsensus()) || pblockrecursive->IsPopMined(chainparams.GetConsensus())))
+                                    vDeferred.push_back({pblockrecursive, pindexRecursive, false, false});
                             }
                         }
                         range.first++;
@@ -4692,6 +5439,8 @@ bool LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, CDiskB
     } catch (const std::runtime_error& e) {
         AbortNode(std::string("System error: ") + e.what());
     }
+    // Ring-fork: Check what's left of the deferred proofs
+    CheckDeferredBlockProofs(vDeferred, chainparams);
     if (nLoaded > 0)
         LogPrintf("Loaded %i blocks from external file in %dms\n", nLoaded, GetTimeMillis() - nStart);
     return nLoaded > 0;
@@ -99,6 +99,9 @@ static const int MAX_BLOCKTXN_DEPTH = 10;
  *  degree of disordering of blocks on disk (which make reindexing and pruning harder). We'll probably
  *  want to make this a per-peer adaptive value at some point. */
 static const unsigned int BLOCK_DOWNLOAD_WINDOW = 1024;
+/** Ring-fork: Number of hive and pop blocks loaded from file whose proofs are checked together, in parallel. Kept well
+ *  inside BLOCK_DOWNLOAD_WINDOW, so the DCT locations the hive proofs look up haven't expired by the time they're checked. */
+static const unsigned int BLOCK_PROOF_CHECK_BATCH_SIZE = 256;
 /** Time to wait (in seconds) between writing blocks/block index to disk. */
 static const unsigned int DATABASE_WRITE_INTERVAL = 60 * 60;
 /** Time to wait (in seconds) between flushing chainstate to disk. */
@@ -117,7 +120,10 @@ static const int64_t MAX_FEE_ESTIMATION_TIP_AGE = 3 * 60 * 60;
 /** Default for -permitbaremultisig */
 static const bool DEFAULT_PERMIT_BAREMULTISIG = true;
 static const bool DEFAULT_CHECKPOINTS_ENABLED = true;
+static const bool DEFAULT_ASSUME_CHECKPOINTED_POW = true;   // Ring-fork
+static const bool DEFAULT_CHECK_ASSUMED_POW = true;         // Ring-fork
 static const bool DEFAULT_TXINDEX = false;
+static const bool DEFAULT_HIVEINDEX = false;                // Ring-fork: Hive
 static const unsigned int DEFAULT_BANSCORE_THRESHOLD = 100;
 /** Default for -persistmempool */
 static const bool DEFAULT_PERSIST_MEMPOOL = true;
@@ -161,6 +167,8 @@ extern bool fIsBareMultisigStd;
 extern bool fRequireStandard;
 extern bool fCheckBlockIndex;
 extern bool fCheckpointsEnabled;
+/** Ring-fork: Whether headers known to lead to a checkpoint are accepted without checking their pow */
+extern bool fAssumeCheckpointedPow;
 extern size_t nCoinCacheUsage;
 /** A fee rate smaller than this is considered zero fee (for relaying, mining and transaction creation) */
 extern CFeeRate minRelayTxFee;
@@ -238,11 +246,15 @@ bool ProcessNewBlock(const CChainParams& chainparams, const std::shared_ptr<cons
  * @param[in]  block The block headers themselves
  * @param[out] state This may be set to an Error state if any error occurred processing them
  * @param[in]  chainparams The params for the chain we want to connect to
- * @param[out] ppindex If set, the pointer will be set to point to the last new block index object for the given headers
+ * @param[out] ppindex If set, the pointer will be set to point to the last new block index object for the given headers, or
+ *                     Ring-fork: if they were held back until they're known to lead to a checkpoint, the one they build on
  * @param[out] first_invalid First header that fails validation, if one exists
  */
 bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& block, CValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex = nullptr, CBlockHeader* first_invalid = nullptr) LOCKS_EXCLUDED(cs_main);
 
+/** Ring-fork: Whether the header with the given hash is held back by ProcessNewBlockHeaders until it's known to lead to a checkpoint */
+bool IsHeaderPowPending(const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
 /** Check whether enough disk space is available for an incoming block */
 bool CheckDiskSpace(uint64_t nAdditionalBytes = 0, bool blocks_dir = false);
 /** Open a block file (blk?????.dat) */
@@ -251,6 +263,18 @@ FILE* OpenBlockFile(const CDiskBlockPos &pos, bool fReadOnly = false);
 fs::path GetBlockPosFilename(const CDiskBlockPos &pos, const char *prefix);
 /** Import blocks from an external file */
 bool LoadExternalBlockFile(const CChainParams& chainparams, FILE* fileIn, CDiskBlockPos *dbp = nullptr);
+/** Ring-fork: A hive or pop block accepted by LoadExternalBlockFile with its proof check deferred */
+struct CDeferredBlockProof
+{
+    std::shared_ptr<const CBlock> pblock;
+    CBlockIndex* pindex;
+    bool fPassed;
+    bool fCacheable;
+};
+/** Ring-fork: Check deferred block proofs in parallel on the proof check threads, then record each verdict: a failed
+ *  block is marked invalid, and a passed one keeps its verdict only if it holds on any branch. Must be called without
+ *  cs_main, which the checks take for their lookups. */
+void CheckDeferredBlockProofs(std::vector<CDeferredBlockProof>& vDeferred, const CChainParams& chainparams);
 /** Ensures we have a genesis block in the block tree, possibly writing one to disk. */
 bool LoadGenesisBlock(const CChainParams& chainparams);
 /** Load the block tree and coins database from disk,
@@ -258,10 +282,18 @@ bool LoadGenesisBlock(const CChainParams& chainparams);
 bool LoadBlockIndex(const CChainParams& chainparams) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 /** Update the chain tip based on database information. */
 bool LoadChainTip(const CChainParams& chainparams) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+/** Ring-fork: Work out and store the pow hashes that older block index entries are missing */
+void StoreMissingPowHashes(const CChainParams& chainparams);
 /** Unload database information */
 void UnloadBlockIndex();
 /** Run an instance of the script checking thread */
 void ThreadScriptCheck();
+/** Ring-fork: Run an instance of the header pow hashing thread */
+void ThreadHeaderPowHash();
+/** Ring-fork: Run an instance of the deferred hive and pop proof checking thread */
+void ThreadBlockProofCheck();
+/** Ring-fork: Keep checking the pow of headers that were accepted without it (BLOCK_POW_ASSUMED) as they arrive, until interrupted */
+void ThreadCheckAssumedPow(const CChainParams& chainparams);
 /** Check whether we are doing an initial block download (synchronizing from disk or network) */
 bool IsInitialBlockDownload();
 /** Retrieve a transaction (from memory pool, or from disk, if possible) */
@@ -407,7 +439,8 @@ bool ReadRawBlockFromDisk(std::vector<uint8_t>& block, const CBlockIndex* pindex
 
 /** Context-independent validity checks */
 // Ring-fork: Pop: Added fPopCheckActiveChain
-bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true, bool fCheckMerkleRoot = true, bool fPopCheckActiveChain = true);
+// Ring-fork: Added fCheckProofs
+bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW = true, bool fCheckMerkleRoot = true, bool fPopCheckActiveChain = true, bool fCheckProofs = true);
 
 /** Check a block is completely valid from start to finish (only works on top of our current best block) */
 bool TestBlockValidity(CValidationState& state, const CChainParams& chainparams, const CBlock& block, CBlockIndex* pindexPrev, bool fCheckPOW = true, bool fCheckMerkleRoot = true) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
@@ -421,6 +454,58 @@ std::string GetDeterministicRandString(const CBlockIndex* pindexPrev);
 // Ring-fork: Hive: Get tx by given hash, from a block at given chain height
 bool GetTxByHashAndHeight(const uint256 txHash, const int nHeight, CTransactionRef& txNew, CBlockIndex& foundAtOut, CBlockIndex* pindex, const Consensus::Params& consensusParams);
 
+// Ring-fork: Hive: Where a DCT was mined, and the outputs a hive proof needs from it
+struct CDCTLocation
+{
+    uint256 blockHash;
+    int nHeight;
+    std::vector<CTxOut> vout;   // The DCT's first two outputs (dwarf creation, and community fund if any)
+};
+
+// Ring-fork: Hive: Record the DCTs in a newly accepted block, so hive proofs claiming them can be checked without reading blocks
+void AddBlockDCTLocations(const CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
+// Ring-fork: Hive: Find a DCT recorded as mined at the given height in pindex's chain
+bool GetDCTLocation(const uint256& txHash, int nHeight, const CBlockIndex* pindex, CDCTLocation& locationOut) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
+// Ring-fork: Pop: Read the game source hash a pop block's coinbase claims; false if it doesn't carry a pop proof
+bool GetPopProofSourceHash(const CBlock& block, uint256& gameSourceHash);
+
+// Ring-fork: Pop: Find the block claiming the game from the block at nSourceHeight with hash gameSourceHash, among the blocks
+// after it in pindex's chain. Returns null if the game is unclaimed there.
+const CBlockIndex* FindGameClaim(const uint256& gameSourceHash, int nSourceHeight, const CBlockIndex* pindex, const Consensus::Params& consensusParams) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
+// Ring-fork: Hive: What hive and pop checks need from a hive or pop block's coinbase, kept so they don't have to read the block
+struct CHiveBlockSummary
+{
+    CScript rewardScript;       // Coinbase vout[1]: where the block reward went
+    uint256 dctTxid;            // Hive: the DCT the solving dwarf came from
+    uint32_t nDwarfNonce;       // Hive: the solving dwarf
+    uint256 gameSourceHash;     // Pop: the game claimed
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(rewardScript);
+        READWRITE(dctTxid);
+        READWRITE(nDwarfNonce);
+        READWRITE(gameSourceHash);
+    }
+
+    CHiveBlockSummary() : nDwarfNonce(0) {}
+};
+
+// Ring-fork: Hive: Read the DCT txid and dwarf nonce from a hive proof script
+bool GetHiveProofDCT(const CScript& script, uint256& dctTxid, uint32_t& dwarfNonce);
+
+// Ring-fork: Hive: Summarise a hive or pop block's coinbase; false if it's neither, or its coinbase isn't well formed
+bool BuildHiveBlockSummary(const CBlock& block, const Consensus::Params& consensusParams, CHiveBlockSummary& summary);
+
+// Ring-fork: Hive: Get the summary of the hive or pop block at pindex. Summaries are recorded as blocks connect; others are
+// built from the block on disk the first time they're asked for.
+bool GetHiveBlockSummary(const CBlockIndex* pindex, const Consensus::Params& consensusParams, CHiveBlockSummary& summary) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
 /** Check whether NULLDUMMY (BIP 147) has activated. */
 bool IsNullDummyEnabled(const CBlockIndex* pindexPrev, const Consensus::Params& params);
 
@@ -0,0 +1,160 @@
+// Copyright (c) 2019 The Ring Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <arith_uint256.h>
+#include <chain.h>
+#include <chainparams.h>
+#include <miner.h>
+#include <pow.h>
+#include <random.h>
+#include <test/test_ring.h>
+#include <wallet/wallet.h>
+
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(hivemining_tests, BasicTestingSetup)
+
+static std::string RandString()
+{
+    std::string deterministicRandString;
+    for (int i = 0; i < 6; i++)
+        deterministicRandString += InsecureRand256().GetHex();
+    return deterministicRandString;
+}
+
+// nDCTs ranges of nDwarves dwarves, the later ones starting part way into their DCT
+static std::vector<CDwarfRange> Ranges(int nDCTs, int nDwarves)
+{
+    std::vector<CDwarfRange> vRanges;
+    for (int i = 0; i < nDCTs; i++)
+        vRanges.push_back({InsecureRand256().GetHex(), "", false, i * 7, nDwarves});
+    return vRanges;
+}
+
+// Ring-fork: Hive: Mining optimisations: The check pool's solution is one the dwarf hasher agrees meets the target
+BOOST_AUTO_TEST_CASE(hive_check_pool_result)
+{
+    const std::string deterministicRandString = RandString();
+    const std::vector<CDwarfRange> vRanges = Ranges(5, 300);
+    const arith_uint256 dwarfHashTarget = ~arith_uint256() >> 8;    // About one dwarf in 256 meets it
+
+    // Which dwarves meet the target, checked one at a time
+    int nSolutions = 0;
+    for (const CDwarfRange& range : vRanges) {
+        CDwarfHasher dwarfHasher(deterministicRandString, range.txid);
+        for (int i = 0; i < range.count; i++)
+            nSolutions += dwarfHasher.CheckTarget(range.offset + i, dwarfHashTarget);
+    }
+    BOOST_REQUIRE(nSolutions > 0);
+
+    CDwarfRange solvingRange;
+    uint32_t solvingDwarf;
+    BOOST_CHECK_EQUAL(CheckHiveDwarves(deterministicRandString, dwarfHashTarget, vRanges, 3, solvingRange, solvingDwarf), HIVE_CHECK_SOLVED);
+    bool fFound = false;
+    for (const CDwarfRange& range : vRanges)
+        fFound |= range.txid == solvingRange.txid && (int)solvingDwarf >= range.offset && (int)solvingDwarf < range.offset + range.count;
+    BOOST_CHECK(fFound);
+    BOOST_CHECK(CDwarfHasher(deterministicRandString, solvingRange.txid).CheckTarget(solvingDwarf, dwarfHashTarget));
+
+    // No dwarf meets a zero target, so all are checked
+    BOOST_CHECK_EQUAL(CheckHiveDwarves(deterministicRandString, arith_uint256(), vRanges, 3, solvingRange, solvingDwarf), HIVE_CHECK_NONE);
+
+    StopHiveCheckThreads();
+}
+
+// Ring-fork: Hive: Mining optimisations: Cancelling a check in progress ends it long before its dwarves run out
+BOOST_AUTO_TEST_CASE(hive_check_pool_abort)
+{
+    const std::string deterministicRandString = RandString();
+    const std::vector<CDwarfRange> vRanges = Ranges(1, 100000000);
+
+    HiveCheckResult result = HIVE_CHECK_SKIPPED;
+    std::thread checker([&] {
+        CDwarfRange solvingRange;
+        uint32_t solvingDwarf;
+        result = CheckHiveDwarves(deterministicRandString, arith_uint256(), vRanges, 2, solvingRange, solvingDwarf);
+    });
+
+    // Cancel once the workers are under way
+    int nClaimed = 0, nChecked = 0;
+    while (!GetHiveCheckProgress(nClaimed, nChecked) || nClaimed == 0)
+        MilliSleep(1);
+    CancelHiveCheck();
+    checker.join();
+
+    BOOST_CHECK_EQUAL(result, HIVE_CHECK_ABORTED);
+    BOOST_CHECK(!GetHiveCheckProgress(nClaimed, nChecked));
+
+    StopHiveCheckThreads();
+}
+
+// Ring-fork: Hive: Mining optimisations: Rounds are cancelled by which block they build on, not its height
+BOOST_AUTO_TEST_CASE(hive_round_staleness)
+{
+    // A <- B <- C, with B2 competing with B
+    CBlockIndex blocks[4];
+    CBlockIndex *pindexA = &blocks[0], *pindexB = &blocks[1], *pindexB2 = &blocks[2], *pindexC = &blocks[3];
+    pindexA->nHeight = 100;
+    pindexB->pprev = pindexA;
+    pindexB->nHeight = 101;
+    pindexB2->pprev = pindexA;
+    pindexB2->nHeight = 101;
+    pindexC->pprev = pindexB;
+    pindexC->nHeight = 102;
+
+    // A round on the tip B is stale once any other block is the tip, even one at the same height
+    BOOST_CHECK(!IsHiveRoundStaleOnTip(pindexB, false, pindexB));
+    BOOST_CHECK(IsHiveRoundStaleOnTip(pindexB, false, pindexB2));
+    BOOST_CHECK(IsHiveRoundStaleOnTip(pindexB, false, pindexC));
+    BOOST_CHECK(IsHiveRoundStaleOnTip(pindexB, false, pindexA));
+
+    // A speculative round on the header B, past the tip A, outlives B's block connecting
+    BOOST_CHECK(!IsHiveRoundStaleOnTip(pindexB, true, pindexA));
+    BOOST_CHECK(!IsHiveRoundStaleOnTip(pindexB, true, pindexB));
+    BOOST_CHECK(IsHiveRoundStaleOnTip(pindexB, true, pindexB2));
+    BOOST_CHECK(IsHiveRoundStaleOnTip(pindexB, true, pindexC));
+
+    // Only a block competing with the round's own is grounds to cancel before it's the tip
+    BOOST_CHECK(IsHiveRoundStaleOnBlock(pindexB, pindexC));
+    BOOST_CHECK(!IsHiveRoundStaleOnBlock(pindexB, pindexB2));
+    BOOST_CHECK(IsHiveRoundStaleOnBlock(pindexA, pindexB2));
+}
+
+// Ring-fork: Hive: A speculative check covers the dwarves mature one block after the tip
+BOOST_AUTO_TEST_CASE(hive_speculative_dwarves)
+{
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    auto dct = [](const std::string& txid, const std::string& status, int blocksLeft) {
+        CDwarfCreationTransactionInfo info;
+        info.txid = txid;
+        info.dwarfCount = 10;
+        info.communityContrib = false;
+        info.dwarfStatus = status;
+        info.blocksLeft = blocksLeft;
+        return info;
+    };
+    const std::vector<CDwarfCreationTransactionInfo> dcts = {
+        dct("mature", "mature", 500),
+        dct("dying", "mature", 1),                                              // Dead a block from now
+        dct("maturing", "immature", consensusParams.dwarfLifespanBlocks + 1),   // Mature a block from now
+        dct("immature", "immature", consensusParams.dwarfLifespanBlocks + 2),
+        dct("expired", "expired", 0),
+    };
+
+    auto txids = [](const std::vector<CDwarfRange>& vRanges) {
+        std::vector<std::string> v;
+        for (const CDwarfRange& range : vRanges)
+            v.push_back(range.txid);
+        return v;
+    };
+    const std::vector<std::string> vNow = txids(GetMatureDwarfRanges(dcts, false, consensusParams));
+    const std::vector<std::string> vNext = txids(GetMatureDwarfRanges(dcts, true, consensusParams));
+    BOOST_CHECK((vNow == std::vector<std::string>{"mature", "dying"}));
+    BOOST_CHECK((vNext == std::vector<std::string>{"mature", "maturing"}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -729,6 +729,47 @@ void CWallet::AddToSpends(const uint256& wtxid)
         AddToSpends(txin.prevout, wtxid);
 }
 
+// Ring-fork: Hive: Get the txid of the DCT a hive coinbase pays out for (held as hex in bytes 14-78 of its first output)
+static bool GetHiveCoinBaseDCT(const CWalletTx& wtx, uint256& dctHash)
+{
+    uint32_t dwarfNonce;
+    return GetHiveProofDCT(wtx.tx->vout[0].scriptPubKey, dctHash, dwarfNonce);
+}
+
+// Ring-fork: Hive: Register a wallet tx if it's a DCT, or against its DCT if it's a hive coinbase
+void CWallet::AddToDCTRegistry(const CWalletTx& wtx)
+{
+    if (wtx.IsHiveCoinBase()) {
+        uint256 dctHash;
+        if (GetHiveCoinBaseDCT(wtx, dctHash))
+            mapDCTRewards[dctHash].insert(wtx.GetHash());
+        return;
+    }
+
+    if (wtx.IsCoinBase())
+        return;
+
+    const Consensus::Params& consensusParams = Params().GetConsensus();
+    CScript scriptPubKeyBCF = GetScriptForDestination(DecodeDestination(consensusParams.dwarfCreationAddress));
+    if (wtx.tx->IsDCT(consensusParams, scriptPubKeyBCF))
+        setDCTs.insert(wtx.GetHash());
+}
+
+// Ring-fork: Hive: Forget a wallet tx that's being removed from the wallet
+void CWallet::RemoveFromDCTRegistry(const CWalletTx& wtx)
+{
+    uint256 dctHash;
+    if (wtx.IsHiveCoinBase() && GetHiveCoinBaseDCT(wtx, dctHash)) {
+        auto it = mapDCTRewards.find(dctHash);
+        if (it != mapDCTRewards.end()) {
+            it->second.erase(wtx.GetHash());
+            if (it->second.empty())
+                mapDCTRewards.erase(it);
+        }
+    }
+    setDCTs.erase(wtx.GetHash());
+}
+
 bool CWallet::EncryptWallet(const SecureString& strWalletPassphrase)
 {
     if (IsCrypted())
@@ -951,6 +992,7 @@ bool CWallet::AddToWallet(const CWalletTx& wtxIn, bool fFlushOnClose)
         wtx.m_it_wtxOrdered = wtxOrdered.insert(std::make_pair(wtx.nOrderPos, &wtx));
         wtx.nTimeSmart = ComputeTimeSmart(wtx);
         AddToSpends(hash);
+        AddToDCTRegistry(wtx);  // Ring-fork: Hive
     }
 
     bool fUpdated = false;
@@ -1026,6 +1068,7 @@ void CWallet::LoadToWallet(const CWalletTx& wtxIn)
         wtx.m_it_wtxOrdered = wtxOrdered.insert(std::make_pair(wtx.nOrderPos, &wtx));
     }
     AddToSpends(hash);
+    AddToDCTRegistry(wtx);      // Ring-fork: Hive
     for (const CTxIn& txin : wtx.tx->vin) {
         auto it = mapWallet.find(txin.prevout.hash);
         if (it != mapWallet.end()) {
@@ -2850,27 +2893,22 @@ CDwarfCreationTransactionInfo CWallet::GetDCT(const CWalletTx& wtx, bool include
     int blocksFound = 0;
     CAmount rewardsPaid = 0;
     if (isMature && scanRewards) {
-        for (const std::pair<uint256, CWalletTx>& pairWtx2 : mapWallet) {
-            const CWalletTx& wtx2 = pairWtx2.second;
-
-            // Skip non-hive rewards
-            if (!wtx2.IsHiveCoinBase())
-                continue;
-
-            // Skip unconfirmed transactions and orphans
-            if (wtx2.GetDepthInMainChain(*locked_chain) < minRewardConfirmations)
-                continue;
-
-            // Grab the txid (bytes 14-78)
-            std::vector<unsigned char> blockTxid(&wtx2.tx->vout[0].scriptPubKey[14], &wtx2.tx->vout[0].scriptPubKey[14 + 64]);
-            std::string blockTxidStr = std::string(blockTxid.begin(), blockTxid.end());
+        LOCK(cs_wallet);
+        auto itRewards = mapDCTRewards.find(wtx.GetHash());
+        if (itRewards != mapDCTRewards.end()) {
+            for (const uint256& rewardHash : itRewards->second) {
+                auto it = mapWallet.find(rewardHash);
+                if (it == mapWallet.end())
+                    continue;
+                const CWalletTx& wtx2 = it->second;
 
-            // Check it
-            if (dctTxid!=blockTxidStr)
-                continue;
+                // Skip unconfirmed transactions and orphans
+                if (wtx2.GetDepthInMainChain(*locked_chain) < minRewardConfirmations)
+                    continue;
 
-            blocksFound++;
-            rewardsPaid += wtx2.tx->vout[1].nValue;
+                blocksFound++;
+                rewardsPaid += wtx2.tx->vout[1].nValue;
+            }
         }
     }
 
@@ -3025,23 +3063,13 @@ bool CWallet::SubmitSolution(CAvailableGame *game, uint8_t gameType, std::vector
         LogPrintf("SubmitSolution: popProofScript          = %s\n", HexStr(popProofScript).c_str());
 
     // Make sure this gameSourceHash hasn't been claimed before
-    CBlockIndex *pblockindex = pindexPrev;
-    while (pblockindex->nHeight > pindexSourceBlock->nHeight) {
-        if (pblockindex->GetBlockHeader().IsPopMined(consensusParams)) {
-            CBlock block;
-            if (ReadBlockFromDisk(block, pblockindex, consensusParams, false)) {
-                uint256 tempGameSourceHashBin;
-                tempGameSourceHashBin.SetHex(HexStr(&block.vtx[0]->vout[0].scriptPubKey[4], &block.vtx[0]->vout[0].scriptPubKey[4+32]));
-
-                if (game->gameSourceHash == tempGameSourceHashBin) {
-                    strFailReason = "SubmitSolution: Game is already claimed in block " + pblockindex->GetBlockHash().ToString() + " (height " + std::to_string(pblockindex->nHeight) + ")";
-                    return false;
-                }
-            }
+    {
+        LOCK(cs_main);
+        const CBlockIndex* pindexClaim = FindGameClaim(game->gameSourceHash, pindexSourceBlock->nHeight, pindexPrev, consensusParams);
+        if (pindexClaim) {
+            strFailReason = "SubmitSolution: Game is already claimed in block " + pindexClaim->GetBlockHash().ToString() + " (height " + std::to_string(pindexClaim->nHeight) + ")";
+            return false;
         }
-
-        assert(pblockindex->pprev);
-        pblockindex = pblockindex->pprev;
     }
 
     // Create a new reward address for game rewards if needed
@@ -3130,7 +3158,8 @@ bool CWallet::SubmitSolution(CAvailableGame *game, uint8_t gameType, std::vector
 // Ring-fork: Pop: Return all games valid to be played by this wallet
 std::vector<CAvailableGame> CWallet::GetAvailableGames(const Consensus::Params& consensusParams) {
     std::vector<CAvailableGame> games;
-    
+
+    LOCK(cs_main);
     if (chainActive.Height() < consensusParams.popMaxPublicGameDepth) {
         LogPrintf("CWallet::GetAvailableGames: Chain height is below popMaxPublicGameDepth\n");
         return games;
@@ -3147,13 +3176,13 @@ std::vector<CAvailableGame> CWallet::GetAvailableGames(const Consensus::Params&
     }
 
     while (pblockindex->nHeight > stopHeight) {
-        // Skip if not hivemined
-        if (pblockindex->GetBlockHeader().IsHiveMined(consensusParams)) {
+        // Skip if not hivemined, or already claimed
+        if (pblockindex->IsHiveMined(consensusParams) && !FindGameClaim(pblockindex->GetBlockHash(), pblockindex->nHeight, chainActive.Tip(), consensusParams)) {
             CTxDestination rewardDestination;
-            CBlock block;
+            CHiveBlockSummary summary;
             if (
-                ReadBlockFromDisk(block, pblockindex, consensusParams, false)                   // Grab block
-                && ExtractDestination(block.vtx[0]->vout[1].scriptPubKey, rewardDestination)    // Grab its reward destination
+                GetHiveBlockSummary(pblockindex, consensusParams, summary)                      // Grab block's coinbase summary
+                && ExtractDestination(summary.rewardScript, rewardDestination)                  // Grab its reward destination
                 && IsValidDestination(rewardDestination)                                        // Check it's valid
                 && ::IsMine((const CKeyStore&)*this, rewardDestination) == ISMINE_SPENDABLE     // Check it's ours
             ) {
@@ -3173,7 +3202,7 @@ std::vector<CAvailableGame> CWallet::GetAvailableGames(const Consensus::Params&
     // Grab potential public games
     stopHeight = tipHeight - consensusParams.popMaxPublicGameDepth;
     while (pblockindex->nHeight > stopHeight) {
-        if (pblockindex->GetBlockHeader().IsHiveMined(consensusParams)) {
+        if (pblockindex->IsHiveMined(consensusParams) && !FindGameClaim(pblockindex->GetBlockHash(), pblockindex->nHeight, chainActive.Tip(), consensusParams)) {
             CAvailableGame game;
             game.gameSourceHash = pblockindex->GetBlockHash();
             int depth = tipHeight - pblockindex->nHeight;
@@ -3186,28 +3215,6 @@ std::vector<CAvailableGame> CWallet::GetAvailableGames(const Consensus::Params&
         pblockindex = pblockindex->pprev;
     }
 
-    // Remove already solved ones
-    pblockindex = chainActive.Tip();
-    while (pblockindex->nHeight > stopHeight) { // (Stop height's already set)
-        if (pblockindex->GetBlockHeader().IsPopMined(consensusParams)) {
-            CBlock block;
-            if (ReadBlockFromDisk(block, pblockindex, consensusParams, false)) {
-                // Grab the source game blockhash
-                uint256 tempGameSourceHashBin;
-                tempGameSourceHashBin.SetHex(HexStr(&block.vtx[0]->vout[0].scriptPubKey[4], &block.vtx[0]->vout[0].scriptPubKey[4+32]));
-                std::string tempGameSourceHashStr = tempGameSourceHashBin.ToString();
-
-                // Remove from potential games if present
-                std::unordered_map<std::string, CAvailableGame>::const_iterator i = potentialGames.find(tempGameSourceHashStr);
-                if (i != potentialGames.end())
-                    potentialGames.erase(tempGameSourceHashStr);
-            }
-        }
-
-        assert(pblockindex->pprev);
-        pblockindex = pblockindex->pprev;
-    }
-
     // Copy survivors to final output
     for (auto it = potentialGames.begin(); it != potentialGames.end(); ++it)
         games.push_back(it->second);
@@ -3252,12 +3259,13 @@ std::vector<CDwarfCreationTransactionInfo> CWallet::GetDCTs(bool includeDead, bo
     if (chainActive.Height() == 0)  // Don't continue if chainActive is invalid; we may be reindexing
         return dcts;
 
-    CScript scriptPubKeyBCF = GetScriptForDestination(DecodeDestination(consensusParams.dwarfCreationAddress));
-    CScript scriptPubKeyCF = GetScriptForDestination(DecodeDestination(consensusParams.hiveCommunityAddress));
-
     auto locked_chain = chain().lock();
-    for (const std::pair<uint256, CWalletTx>& pairWtx : mapWallet) {
-        const CWalletTx& wtx = pairWtx.second;
+    LOCK(cs_wallet);
+    for (const uint256& hash : setDCTs) {
+        auto it = mapWallet.find(hash);
+        if (it == mapWallet.end())
+            continue;
+        const CWalletTx& wtx = it->second;
 
         // Skip unconfirmed transactions and orphans
         if (wtx.GetDepthInMainChain(*locked_chain) < 1)
@@ -3870,6 +3878,7 @@ DBErrors CWallet::ZapSelectTx(std::vector<uint256>& vHashIn, std::vector<uint256
     for (uint256 hash : vHashOut) {
         const auto& it = mapWallet.find(hash);
         wtxOrdered.erase(it->second.m_it_wtxOrdered);
+        RemoveFromDCTRegistry(it->second);  // Ring-fork: Hive
         mapWallet.erase(it);
     }
 
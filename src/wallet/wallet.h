@@ -706,6 +706,16 @@ private:
     void AddToSpends(const COutPoint& outpoint, const uint256& wtxid) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
     void AddToSpends(const uint256& wtxid) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
+    /**
+     * Ring-fork: Hive: DCT registry. Wallet txs that are DCTs, and for each DCT the hive
+     * coinbases paying out for it, so DCT queries don't have to walk mapWallet. Like
+     * mapTxSpends it's derived from mapWallet, and rebuilt as the wallet loads.
+     */
+    std::set<uint256> setDCTs GUARDED_BY(cs_wallet);
+    std::map<uint256, std::set<uint256>> mapDCTRewards GUARDED_BY(cs_wallet);
+    void AddToDCTRegistry(const CWalletTx& wtx) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    void RemoveFromDCTRegistry(const CWalletTx& wtx) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
     /**
      * Add a transaction to the wallet, or update it.  pIndex and posInBlock should
      * be set when the transaction was known to be included in a block.  When
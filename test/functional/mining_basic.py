@@ -5,6 +5,7 @@
 """Test mining RPCs
 
 - getmininginfo
+- gethivemininginfo
 - getblocktemplate proposal mode
 - submitblock"""
 
@@ -77,6 +78,11 @@ class MiningTest(RingTestFramework):
         assert_equal(mining_info['networkhashps'], Decimal('0.003333333333333334'))
         assert_equal(mining_info['pooledtx'], 0)
 
+        self.log.info('gethivemininginfo')
+        hive_info = node.gethivemininginfo()
+        assert_equal(hive_info['checking'], False)
+        assert_equal(hive_info['rounds'], [])
+
         # Mine a block to leave initial block download
         node.generatetoaddress(1, node.get_deterministic_priv_key().address)
         tmpl = node.getblocktemplate({'rules': ['segwit']})
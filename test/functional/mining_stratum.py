@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+# Copyright (c) 2019 The Ring Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test the stratum work server (-stratum), with a minimal stratum client standing in for a miner.
+
+- mining.subscribe / mining.authorize, and the difficulty and job sent after subscribing
+- error replies for unknown jobs and malformed submits
+- submits are turned into blocks paying -stratumaddress, built exactly as the client built them
+- a new job is pushed (clean) as soon as the tip changes
+"""
+import json
+import socket
+import struct
+
+from test_framework.messages import hash256
+from test_framework.test_framework import RingTestFramework
+from test_framework.util import assert_equal, p2p_port
+
+
+class StratumClient():
+    def __init__(self, port):
+        self.sock = socket.create_connection(('127.0.0.1', port), timeout=60)
+        self.buf = b''
+        self.next_id = 1
+        self.notifications = []
+
+    def read_message(self):
+        while b'\n' not in self.buf:
+            data = self.sock.recv(4096)
+            assert data, 'connection closed'
+            self.buf += data
+        line, self.buf = self.buf.split(b'\n', 1)
+        return json.loads(line.decode())
+
+    def call(self, method, params):
+        request_id = self.next_id
+        self.next_id += 1
+        self.sock.sendall((json.dumps({'id': request_id, 'method': method, 'params': params}) + '\n').encode())
+        while True:
+            message = self.read_message()
+            if message.get('id') == request_id:
+                return message
+            self.notifications.append(message)
+
+    def wait_for_notification(self, method):
+        while True:
+            for message in self.notifications:
+                if message['method'] == method:
+                    self.notifications.remove(message)
+                    return message['params']
+            self.notifications.append(self.read_message())
+
+
+def job_header(job, extranonce1, extranonce2, nonce):
+    """Build the 80-byte header for a mining.notify job, the way a stratum miner does"""
+    job_id, prevhash, coinb1, coinb2, branch, version, nbits, ntime, clean = job
+    prev = b''.join(bytes.fromhex(prevhash)[i:i + 4][::-1] for i in range(0, 32, 4))
+    root = hash256(bytes.fromhex(coinb1) + bytes.fromhex(extranonce1) + bytes.fromhex(extranonce2) + bytes.fromhex(coinb2))
+    for h in branch:
+        root = hash256(root + bytes.fromhex(h))
+    return struct.pack('<I', int(version, 16)) + prev + root + struct.pack('<III', int(ntime, 16), int(nbits, 16), nonce)
+
+
+class StratumTest(RingTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 1
+
+    def skip_test_if_missing_module(self):
+        self.skip_if_no_wallet()
+
+    def run_test(self):
+        node = self.nodes[0]
+        node.generate(1)    # Leave IBD
+        address = node.getnewaddress()
+        port = p2p_port(self.num_nodes)
+        self.restart_node(0, ['-stratum', '-stratumport=%d' % port, '-stratumaddress=%s' % address, '-debug=stratum'])
+
+        self.log.info('Subscribe and authorize')
+        client = StratumClient(port)
+        result = client.call('mining.subscribe', ['test-miner/1.0'])['result']
+        extranonce1, extranonce2_size = result[1], result[2]
+        assert_equal(len(extranonce1), 8)
+        assert_equal(extranonce2_size, 4)
+        assert client.wait_for_notification('mining.set_difficulty')[0] > 0
+        job = client.wait_for_notification('mining.notify')
+        assert_equal(job[8], True)
+        assert_equal(client.call('mining.authorize', ['worker', 'x'])['result'], True)
+
+        self.log.info('Bad submits are refused')
+        assert_equal(client.call('mining.submit', ['worker', 'nosuchjob', '00000000', job[7], '00000003'])['error'][0], 21)
+        assert_equal(client.call('mining.submit', ['worker', job[0], '00', job[7], '00000003'])['error'][0], 20)
+
+        self.log.info('Submit until a share solves a block (regtest targets are easy)')
+        height = node.getblockcount()
+        extranonce2 = '01020304'
+        nonce = 3       # Clear of the hive and pop nonce markers
+        while node.getblockcount() == height:
+            reply = client.call('mining.submit', ['worker', job[0], extranonce2, job[7], '%08x' % nonce])
+            assert reply['result'] is True or reply['error'][0] == 23
+            nonce += 1
+        nonce -= 1
+        assert_equal(node.getblockcount(), height + 1)
+
+        self.log.info('The block is the one the client built, and pays the stratum address')
+        header = job_header(job, extranonce1, extranonce2, nonce)
+        assert_equal(node.getbestblockhash(), hash256(header)[::-1].hex())
+        block = node.getblock(node.getbestblockhash(), 2)
+        assert address in block['tx'][0]['vout'][0]['scriptPubKey']['addresses']
+
+        self.log.info('New work is pushed for the new tip, and the old job is stale')
+        new_job = client.wait_for_notification('mining.notify')
+        assert_equal(new_job[8], True)
+        assert new_job[0] != job[0]
+        assert_equal(client.call('mining.submit', ['worker', job[0], extranonce2, job[7], '%08x' % nonce])['error'][0], 21)
+
+
+if __name__ == '__main__':
+    StratumTest().main()